@@ -2221,7 +2221,7 @@ void QuadPlane::log_QPOS(void)
 // @Field: TAcc: Target acceleration
 // @Field: OShoot: True if landing point is overshot or heading off by more than 60 degrees
 
-    AP::logger().WriteStreaming("QPOS", "TimeUS,State,Dist,TSpd,TAcc,OShoot", "QBfffB",
+    LOGGER_WRITE_STREAMING_FAST("QPOS", "TimeUS,State,Dist,TSpd,TAcc,OShoot", nullptr, nullptr, "QBfffB",
                                 AP_HAL::micros64(),
                                 poscontrol.get_state(),
                                 plane.auto_state.wp_distance,
@@ -2957,12 +2957,13 @@ void QuadPlane::assign_tilt_to_fwd_thr(void) {
         plane.nav_pitch_cd = MIN(plane.nav_pitch_cd, (int32_t)q_bck_pitch_lim_cd);
 
 #if HAL_LOGGING_ENABLED
-        AP::logger().WriteStreaming("QBRK",
+        LOGGER_WRITE_STREAMING_FAST("QBRK",
                                 "TimeUS,SpdScaler,NPULCD,QBPLCD,NPCD",  // labels
+                                nullptr, nullptr,
                                 "Qffii",    // fmt
                                 AP_HAL::micros64(),
-                                (double)speed_scaler,
-                                (double)nav_pitch_upper_limit_cd,
+                                speed_scaler,
+                                nav_pitch_upper_limit_cd,
                                 (int32_t)q_bck_pitch_lim_cd,
                                 (int32_t)plane.nav_pitch_cd);
 #endif
@@ -2988,16 +2989,17 @@ void QuadPlane::assign_tilt_to_fwd_thr(void) {
 
 #if HAL_LOGGING_ENABLED
     // Diagnostics logging - remove when feature is fully flight tested.
-    AP::logger().WriteStreaming("FWDT",
+    LOGGER_WRITE_STREAMING_FAST("FWDT",
                                 "TimeUS,fts,qfplcd,npllcd,npcd,qft,npulcd",  // labels
+                                nullptr, nullptr,
                                 "Qffffff",    // fmt
                                 AP_HAL::micros64(),
-                                (double)fwd_thr_scaler,
-                                (double)q_fwd_pitch_lim_cd,
-                                (double)nav_pitch_lower_limit_cd,
-                                (double)plane.nav_pitch_cd,
-                                (double)q_fwd_throttle,
-                                (float)nav_pitch_upper_limit_cd);
+                                fwd_thr_scaler,
+                                q_fwd_pitch_lim_cd,
+                                nav_pitch_lower_limit_cd,
+                                plane.nav_pitch_cd,
+                                q_fwd_throttle,
+                                nav_pitch_upper_limit_cd);
 #endif
 
     plane.nav_pitch_cd = MAX(plane.nav_pitch_cd, (int32_t)nav_pitch_lower_limit_cd);
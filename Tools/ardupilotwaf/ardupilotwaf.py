@@ -128,6 +128,7 @@ COMMON_VEHICLE_DEPENDENT_LIBRARIES = [
     'AP_Beacon',
     'AP_Arming',
     'AP_RCMapper',
+    'AP_Trace',
 ]
 
 def get_legacy_defines(sketch_name, bld):
@@ -1,6 +1,7 @@
 #include "AC_AttitudeControl_Heli.h"
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Scheduler/AP_Scheduler.h>
+#include <AP_Trace/AP_Trace.h>
 
 // table of user settable parameters
 const AP_Param::GroupInfo AC_AttitudeControl_Heli::var_info[] = {
@@ -439,6 +440,7 @@ void AC_AttitudeControl_Heli::rate_controller_run()
     _sysid_ang_vel_body.zero();
     _actuator_sysid.zero();
 
+    AP_TRACE(RATE_CONTROL);
 }
 
 // Update Alt_Hold angle maximum
@@ -3,6 +3,7 @@
 #include <AP_Math/AP_Math.h>
 #include <AC_PID/AC_PID.h>
 #include <AP_Scheduler/AP_Scheduler.h>
+#include <AP_Trace/AP_Trace.h>
 
 // table of user settable parameters
 const AP_Param::GroupInfo AC_AttitudeControl_Multi::var_info[] = {
@@ -468,6 +469,8 @@ void AC_AttitudeControl_Multi::rate_controller_run()
     _pd_scale = VECTORF_111;
 
     control_monitor_update();
+
+    AP_TRACE(RATE_CONTROL);
 }
 
 // sanity check parameters.  should be called once before takeoff
@@ -1,6 +1,7 @@
 #include "AC_AttitudeControl_Sub.h"
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
+#include <AP_Trace/AP_Trace.h>
 
 // table of user settable parameters
 const AP_Param::GroupInfo AC_AttitudeControl_Sub::var_info[] = {
@@ -428,6 +429,8 @@ void AC_AttitudeControl_Sub::rate_controller_run()
     _motors.set_yaw(get_rate_yaw_pid().update_all(_ang_vel_body.z, _rate_gyro.z, _dt, _motors.limit.yaw));
 
     control_monitor_update();
+
+    AP_TRACE(RATE_CONTROL);
 }
 
 // sanity check parameters.  should be called once before takeoff
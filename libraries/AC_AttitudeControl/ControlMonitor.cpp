@@ -51,13 +51,13 @@ void AC_AttitudeControl::control_monitor_log(void) const
 // @Field: RMSPitchP: LPF Root-Mean-Squared Pitch Rate controller P gain
 // @Field: RMSPitchD: LPF Root-Mean-Squared Pitch Rate controller D gain
 // @Field: RMSYaw: LPF Root-Mean-Squared Yaw Rate controller P+D gain
-    AP::logger().WriteStreaming("CTRL", "TimeUS,RMSRollP,RMSRollD,RMSPitchP,RMSPitchD,RMSYaw", "Qfffff",
-                                           AP_HAL::micros64(),
-                                           (double)safe_sqrt(_control_monitor.rms_roll_P),
-                                           (double)safe_sqrt(_control_monitor.rms_roll_D),
-                                           (double)safe_sqrt(_control_monitor.rms_pitch_P),
-                                           (double)safe_sqrt(_control_monitor.rms_pitch_D),
-                                           (double)safe_sqrt(_control_monitor.rms_yaw));
+    LOGGER_WRITE_STREAMING_FAST("CTRL", "TimeUS,RMSRollP,RMSRollD,RMSPitchP,RMSPitchD,RMSYaw", nullptr, nullptr, "Qfffff",
+                                AP_HAL::micros64(),
+                                safe_sqrt(_control_monitor.rms_roll_P),
+                                safe_sqrt(_control_monitor.rms_roll_D),
+                                safe_sqrt(_control_monitor.rms_pitch_P),
+                                safe_sqrt(_control_monitor.rms_pitch_D),
+                                safe_sqrt(_control_monitor.rms_yaw));
 
 }
 #endif  // HAL_LOGGING_ENABLED
@@ -5,6 +5,7 @@
 #include "AC_Avoid.h"
 #include "AP_OADijkstra.h"
 #include "AP_OABendyRuler.h"
+#include "AP_OADatabase.h"
 #include <AP_Logger/AP_Logger.h>
 
 #if AP_OAPATHPLANNER_BENDYRULER_ENABLED
@@ -69,6 +70,37 @@ void AP_OADijkstra::Write_Visgraph_point(const uint8_t version, const uint8_t po
 }
 #endif
 
+#if AP_OADATABASE_ENABLED
+void AP_OADatabase::Write_OADatabase()
+{
+    uint16_t queue_len;
+    uint32_t drops;
+    {
+        WITH_SEMAPHORE(_queue.sem);
+        queue_len = _queue.items->available();
+        drops = _queue.drops;
+    }
+
+    const struct log_OADatabase pkt{
+        LOG_PACKET_HEADER_INIT(LOG_OA_DATABASE_MSG),
+        time_us             : AP_HAL::micros64(),
+        count               : _database.count,
+        queue_len           : queue_len,
+        drops               : (uint16_t)MIN(drops - _stats.last_drops, (uint32_t)UINT16_MAX),
+        processed           : _stats.processed,
+        latency_max_ms      : _stats.latency_max_ms,
+        process_time_max_us : _stats.process_time_max_us
+    };
+    AP::logger().WriteBlock(&pkt, sizeof(pkt));
+
+    // restart statistics for the next message
+    _stats.processed = 0;
+    _stats.latency_max_ms = 0;
+    _stats.process_time_max_us = 0;
+    _stats.last_drops = drops;
+}
+#endif  // AP_OADATABASE_ENABLED
+
 #if AP_AVOIDANCE_ENABLED
 void AC_Avoid::Write_SimpleAvoidance(const uint8_t state, const Vector3f& desired_vel, const Vector3f& modified_vel, const bool back_up) const
 {
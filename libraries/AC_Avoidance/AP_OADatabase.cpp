@@ -19,6 +19,7 @@
 
 #include <AP_AHRS/AP_AHRS.h>
 #include <GCS_MAVLink/GCS.h>
+#include <AP_InternalError/AP_InternalError.h>
 #include <AP_Math/AP_Math.h>
 #include <AP_Vehicle/AP_Vehicle_Type.h>
 
@@ -40,6 +41,15 @@ extern const AP_HAL::HAL& hal;
     #define AP_OADATABASE_DISTANCE_FROM_HOME 3
 #endif
 
+#ifndef AP_OADATABASE_HASH_CELL_SIZE
+    #define AP_OADATABASE_HASH_CELL_SIZE 1.0f       // size (in meters) of each spatial hash grid cell
+#endif
+
+#define AP_OADATABASE_HASH_BUCKETS_MAX      4096    // maximum number of spatial hash buckets
+#define AP_OADATABASE_HASH_SEARCH_RANGE_MAX 8       // searches spanning more cells than this in each direction check every item
+#define AP_OADATABASE_EXPIRY_SWEEP_CALLS    32      // all buckets are checked for expired items over this many calls to process_queue
+#define AP_OADATABASE_BATCH_SIZE            16      // maximum number of items moved to or from the queue under a single semaphore hold
+
 const AP_Param::GroupInfo AP_OADatabase::var_info[] = {
 
     // @Param: SIZE
@@ -124,6 +134,7 @@ void AP_OADatabase::init()
 {
     init_database();
     init_queue();
+    init_hash();
 
     // initialise scalar using beam width of at least 1deg
     dist_to_radius_scalar = tanf(radians(MAX(_beam_width, 1.0f)));
@@ -131,7 +142,13 @@ void AP_OADatabase::init()
     if (!healthy()) {
         GCS_SEND_TEXT(MAV_SEVERITY_INFO, "DB init failed . Sizes queue:%u, db:%u", (unsigned int)_queue.size, (unsigned int)_database.size);
         delete _queue.items;
+        _queue.items = nullptr;
         delete[] _database.items;
+        _database.items = nullptr;
+        delete[] _hash.head;
+        _hash.head = nullptr;
+        delete[] _hash.next;
+        _hash.next = nullptr;
         return;
     }
 }
@@ -143,43 +160,101 @@ void AP_OADatabase::update()
     }
 
     process_queue();
-    database_items_remove_all_expired();
+
+#if HAL_LOGGING_ENABLED
+    Write_OADatabase();
+#endif
 }
 
-// push a location into the database
-void AP_OADatabase::queue_push(const Vector3f &pos, uint32_t timestamp_ms, float distance)
+// returns true if objects should be rejected because the vehicle is low and near home
+bool AP_OADatabase::reject_low_altitude_near_home() const
 {
-    if (!healthy()) {
-        return;
-    }
-
-    // check if this obstacle needs to be rejected from DB because of low altitude near home
 #if APM_BUILD_COPTER_OR_HELI
     if (!is_zero(_min_alt)) { 
         Vector3f current_pos;
         if (!AP::ahrs().get_relative_position_NED_home(current_pos)) {
             // we do not know where the vehicle is
-            return;
+            return true;
         }
         if (current_pos.xy().length() < AP_OADATABASE_DISTANCE_FROM_HOME) {
             // vehicle is within a small radius of home 
             if (-current_pos.z < _min_alt) {
                 // vehicle is below the minimum alt
-                return;
+                return true;
             }
         }
     }
 #endif
-    
+    return false;
+}
+
+// convert distance to obstacle into an item and check it is within the maximum distance
+// returns false if the item should be ignored
+bool AP_OADatabase::make_item(const Vector3f &pos, uint32_t timestamp_ms, float distance, OA_DbItem &item) const
+{
     // ignore objects that are far away
     if ((_dist_max > 0.0f) && (distance > _dist_max)) {
+        return false;
+    }
+
+    item = {pos, timestamp_ms, MAX(_radius_min, distance * dist_to_radius_scalar), 0, AP_OADatabase::OA_DbItemImportance::Normal};
+    return true;
+}
+
+// push a location into the database
+void AP_OADatabase::queue_push(const Vector3f &pos, uint32_t timestamp_ms, float distance)
+{
+    if (!healthy()) {
+        return;
+    }
+
+    // check if this obstacle needs to be rejected from DB because of low altitude near home
+    if (reject_low_altitude_near_home()) {
         return;
     }
 
-    const OA_DbItem item = {pos, timestamp_ms, MAX(_radius_min, distance * dist_to_radius_scalar), 0, AP_OADatabase::OA_DbItemImportance::Normal};
+    OA_DbItem item;
+    if (!make_item(pos, timestamp_ms, distance, item)) {
+        return;
+    }
     {
         WITH_SEMAPHORE(_queue.sem);
-        _queue.items->push(item);
+        if (!_queue.items->push(item)) {
+            _queue.drops++;
+        }
+    }
+}
+
+// push a batch of locations into the database
+void AP_OADatabase::queue_push(const Vector3f *pos, const float *distance, uint16_t count, uint32_t timestamp_ms)
+{
+    if (!healthy() || (count == 0)) {
+        return;
+    }
+
+    // check once if these obstacles need to be rejected from DB because of low altitude near home
+    if (reject_low_altitude_near_home()) {
+        return;
+    }
+
+    OA_DbItem items[AP_OADATABASE_BATCH_SIZE];
+    uint8_t num_items = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        if (make_item(pos[i], timestamp_ms, distance[i], items[num_items])) {
+            num_items++;
+        }
+        if ((num_items == 0) || ((num_items < ARRAY_SIZE(items)) && (i < count - 1))) {
+            continue;
+        }
+
+        // push as many items as fit into the queue
+        WITH_SEMAPHORE(_queue.sem);
+        const uint8_t num_to_push = MIN(_queue.items->space(), num_items);
+        if (num_to_push > 0) {
+            _queue.items->push(items, num_to_push);
+        }
+        _queue.drops += num_items - num_to_push;
+        num_items = 0;
     }
 }
 
@@ -208,6 +283,33 @@ void AP_OADatabase::init_database()
     _database.items = NEW_NOTHROW OA_DbItem[_database.size];
 }
 
+void AP_OADatabase::init_hash()
+{
+    if (_database.items == nullptr) {
+        return;
+    }
+
+    // aim for no more than two items per bucket when the database is full
+    uint16_t num_buckets = 16;
+    while ((num_buckets < AP_OADATABASE_HASH_BUCKETS_MAX) && (num_buckets * 2U < _database.size)) {
+        num_buckets *= 2;
+    }
+
+    _hash.head = NEW_NOTHROW uint16_t[num_buckets];
+    _hash.next = NEW_NOTHROW uint16_t[_database.size];
+    if ((_hash.head == nullptr) || (_hash.next == nullptr)) {
+        delete[] _hash.head;
+        _hash.head = nullptr;
+        delete[] _hash.next;
+        _hash.next = nullptr;
+        return;
+    }
+    for (uint16_t i = 0; i < num_buckets; i++) {
+        _hash.head[i] = HASH_END;
+    }
+    _hash.num_buckets = num_buckets;
+}
+
 // get bitmask of gcs channels item should be sent to based on its importance
 // returns 0xFF (send to all channels) if should be sent, 0 if it should not be sent
 uint8_t AP_OADatabase::get_send_to_gcs_flags(const OA_DbItemImportance importance)
@@ -241,6 +343,12 @@ bool AP_OADatabase::process_queue()
         return false;
     }
 
+    const uint32_t start_us = AP_HAL::micros();
+
+    // check a slice of the buckets for expired items so that the whole database is checked
+    // every AP_OADATABASE_EXPIRY_SWEEP_CALLS calls
+    database_items_remove_expired(MAX(_hash.num_buckets / AP_OADATABASE_EXPIRY_SWEEP_CALLS, 1));
+
     // processing queue by moving those entries into the database
     // Using a for with fixed size is better than while(!empty) because the
     // while could get us stuck here longer than expected if we're getting
@@ -251,35 +359,148 @@ bool AP_OADatabase::process_queue()
         return false;
     }
 
-    for (uint16_t queue_index=0; queue_index<queue_available; queue_index++) {
-        OA_DbItem item;
-
-        bool pop_success;
+    uint16_t queue_index = 0;
+    while (queue_index < queue_available) {
+        // pop a batch of items from the queue
+        OA_DbItem items[AP_OADATABASE_BATCH_SIZE];
+        uint8_t num_items = 0;
         {
             WITH_SEMAPHORE(_queue.sem);
-            pop_success = _queue.items->pop(item);
+            while ((num_items < ARRAY_SIZE(items)) && (queue_index < queue_available) && _queue.items->pop(items[num_items])) {
+                num_items++;
+                queue_index++;
+            }
+        }
+        if (num_items == 0) {
+            break;
         }
-        if (!pop_success) {
-            return false;
+
+        const uint32_t now_ms = AP_HAL::millis();
+        for (uint8_t i = 0; i < num_items; i++) {
+            OA_DbItem &item = items[i];
+            item.send_to_gcs = get_send_to_gcs_flags(item.importance);
+
+            // look for a similar item in the database. If found, update the existing, else add it as a new one
+            const int32_t index = find_close_item_in_database(item);
+            if (index >= 0) {
+                database_item_refresh(index, item.timestamp_ms, item.radius);
+            } else {
+                database_item_add(item);
+            }
+
+            _stats.latency_max_ms = MAX(_stats.latency_max_ms, MIN(now_ms - item.timestamp_ms, (uint32_t)UINT16_MAX));
+        }
+    }
+
+    _stats.processed += queue_index;
+    _stats.process_time_max_us = MAX(_stats.process_time_max_us, MIN(AP_HAL::micros() - start_us, (uint32_t)UINT16_MAX));
+
+    return (_queue.items->available() > 0);
+}
+
+// returns grid cell holding a position
+void AP_OADatabase::hash_cell(const Vector3f &pos, int32_t &x, int32_t &y, int32_t &z) const
+{
+    x = floorf(pos.x * (1.0f / AP_OADATABASE_HASH_CELL_SIZE));
+    y = floorf(pos.y * (1.0f / AP_OADATABASE_HASH_CELL_SIZE));
+    z = floorf(pos.z * (1.0f / AP_OADATABASE_HASH_CELL_SIZE));
+}
+
+// returns bucket holding items in a grid cell.  Many cells share each bucket
+uint16_t AP_OADatabase::hash_bucket(int32_t x, int32_t y, int32_t z) const
+{
+    const uint32_t h = ((uint32_t)x * 73856093U) ^ ((uint32_t)y * 19349663U) ^ ((uint32_t)z * 83492791U);
+    return h & (_hash.num_buckets - 1);
+}
+
+// returns bucket holding items at a position
+uint16_t AP_OADatabase::hash_bucket(const Vector3f &pos) const
+{
+    int32_t x, y, z;
+    hash_cell(pos, x, y, z);
+    return hash_bucket(x, y, z);
+}
+
+// returns pointer to the bucket head or next entry which refers to database item "index"
+// returns nullptr if the item cannot be found
+uint16_t *AP_OADatabase::hash_find_link(const uint16_t index)
+{
+    uint16_t *link = &_hash.head[hash_bucket(_database.items[index].pos)];
+    while (*link != index) {
+        if (*link == HASH_END) {
+            return nullptr;
         }
+        link = &_hash.next[*link];
+    }
+    return link;
+}
+
+// add database item "index" to its bucket
+void AP_OADatabase::hash_link(const uint16_t index)
+{
+    const uint16_t bucket = hash_bucket(_database.items[index].pos);
+    _hash.next[index] = _hash.head[bucket];
+    _hash.head[bucket] = index;
+}
+
+// remove database item "index" from its bucket
+void AP_OADatabase::hash_unlink(const uint16_t index)
+{
+    uint16_t *link = hash_find_link(index);
+    if (link == nullptr) {
+        INTERNAL_ERROR(AP_InternalError::error_t::flow_of_control);
+        return;
+    }
+    *link = _hash.next[index];
+}
 
-        item.send_to_gcs = get_send_to_gcs_flags(item.importance);
+// update buckets for database item moving from old_index to new_index
+void AP_OADatabase::hash_replace(const uint16_t old_index, const uint16_t new_index)
+{
+    uint16_t *link = hash_find_link(old_index);
+    if (link == nullptr) {
+        INTERNAL_ERROR(AP_InternalError::error_t::flow_of_control);
+        return;
+    }
+    *link = new_index;
+    _hash.next[new_index] = _hash.next[old_index];
+}
 
-        // compare item to all items in database. If found a similar item, update the existing, else add it as a new one
-        bool found = false;
+// returns index of a database item close to item or -1 if none found
+int32_t AP_OADatabase::find_close_item_in_database(const OA_DbItem &item) const
+{
+    // items are close if within the radius of either item, so search all cells within the larger radius
+    const float search_radius = MAX(item.radius, _hash.max_radius);
+    const float search_range_f = ceilf(search_radius * (1.0f / AP_OADATABASE_HASH_CELL_SIZE));
+    const uint32_t search_width = 2 * (uint32_t)MIN(search_range_f, AP_OADATABASE_HASH_SEARCH_RANGE_MAX) + 1;
+    const uint32_t search_cells = (search_range_f <= AP_OADATABASE_HASH_SEARCH_RANGE_MAX) ? search_width * search_width * search_width : UINT32_MAX;
+
+    if (search_cells >= _database.count) {
+        // checking every item is quicker than searching the cells
         for (uint16_t i=0; i<_database.count; i++) {
             if (is_close_to_item_in_database(i, item)) {
-                database_item_refresh(i, item.timestamp_ms, item.radius);
-                found = true;
-                break;
+                return i;
             }
         }
+        return -1;
+    }
 
-        if (!found) {
-            database_item_add(item);
+    const int32_t search_range = search_range_f;
+    int32_t x, y, z;
+    hash_cell(item.pos, x, y, z);
+    for (int32_t dx = -search_range; dx <= search_range; dx++) {
+        for (int32_t dy = -search_range; dy <= search_range; dy++) {
+            for (int32_t dz = -search_range; dz <= search_range; dz++) {
+                const uint16_t bucket = hash_bucket(x + dx, y + dy, z + dz);
+                for (uint16_t i = _hash.head[bucket]; i != HASH_END; i = _hash.next[i]) {
+                    if (is_close_to_item_in_database(i, item)) {
+                        return i;
+                    }
+                }
+            }
         }
     }
-    return (_queue.items->available() > 0);
+    return -1;
 }
 
 void AP_OADatabase::database_item_add(const OA_DbItem &item)
@@ -289,7 +510,11 @@ void AP_OADatabase::database_item_add(const OA_DbItem &item)
     }
     _database.items[_database.count] = item;
     _database.items[_database.count].send_to_gcs = get_send_to_gcs_flags(_database.items[_database.count].importance);
+    hash_link(_database.count);
     _database.count++;
+
+    _hash.max_radius = MAX(_hash.max_radius, item.radius);
+    _hash.sweep_max_radius = MAX(_hash.sweep_max_radius, item.radius);
 }
 
 void AP_OADatabase::database_item_remove(const uint16_t index)
@@ -303,13 +528,18 @@ void AP_OADatabase::database_item_remove(const uint16_t index)
     _database.items[index].radius = 0;
     _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
 
+    hash_unlink(index);
+
     _database.count--;
     if (_database.count == 0) {
+        _hash.max_radius = 0;
+        _hash.sweep_max_radius = 0;
         return;
     }
 
     if (index != _database.count) {
         // copy last object in array over expired object
+        hash_replace(_database.count, index);
         _database.items[index] = _database.items[_database.count];
         _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
     }
@@ -332,27 +562,42 @@ void AP_OADatabase::database_item_refresh(const uint16_t index, const uint32_t t
         _database.items[index].timestamp_ms = timestamp_ms;
         _database.items[index].radius = radius;
         _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
+
+        _hash.max_radius = MAX(_hash.max_radius, radius);
+        _hash.sweep_max_radius = MAX(_hash.sweep_max_radius, radius);
     }
 }
 
-void AP_OADatabase::database_items_remove_all_expired()
+// remove expired items from the next num_buckets buckets
+// also recalculates the largest item radius each time all buckets have been checked
+void AP_OADatabase::database_items_remove_expired(uint16_t num_buckets)
 {
-    // calculate age of all items in the _database
-
-    if (_database_expiry_seconds <= 0) {
-        // zero means never expire. This is not normal behavior but perhaps you could send a static
-        // environment once that you don't want to have to constantly update
-        return;
-    }
+    // zero means never expire. This is not normal behavior but perhaps you could send a static
+    // environment once that you don't want to have to constantly update
+    const bool expire = (_database_expiry_seconds > 0);
 
     const uint32_t now_ms = AP_HAL::millis();
     const uint32_t expiry_ms = (uint32_t)_database_expiry_seconds * 1000;
-    uint16_t index = 0;
-    while (index < _database.count) {
-        if (now_ms - _database.items[index].timestamp_ms > expiry_ms) {
-            database_item_remove(index);
-        } else {
-            index++;
+    for (uint16_t b = 0; b < num_buckets; b++) {
+        const uint16_t bucket = _hash.next_expiry_bucket;
+        uint16_t index = _hash.head[bucket];
+        while (index != HASH_END) {
+            if (expire && (now_ms - _database.items[index].timestamp_ms > expiry_ms)) {
+                // removal moves the last item into this index so restart from the start of the bucket
+                database_item_remove(index);
+                index = _hash.head[bucket];
+            } else {
+                _hash.sweep_max_radius = MAX(_hash.sweep_max_radius, _database.items[index].radius);
+                index = _hash.next[index];
+            }
+        }
+
+        _hash.next_expiry_bucket++;
+        if (_hash.next_expiry_bucket >= _hash.num_buckets) {
+            // all buckets checked so radius of all items is known
+            _hash.next_expiry_bucket = 0;
+            _hash.max_radius = _hash.sweep_max_radius;
+            _hash.sweep_max_radius = 0;
         }
     }
 }
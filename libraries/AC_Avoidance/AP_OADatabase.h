@@ -41,8 +41,12 @@ public:
     // push an object into the database.  Pos is the offset in meters from the EKF origin, angle is in degrees, distance in meters
     void queue_push(const Vector3f &pos, uint32_t timestamp_ms, float distance);
 
+    // push a batch of objects (e.g. from a full proximity scan) into the database.  The altitude check and
+    // queue semaphore are taken once for the whole batch.  pos and distance arrays must hold count elements
+    void queue_push(const Vector3f *pos, const float *distance, uint16_t count, uint32_t timestamp_ms);
+
     // returns true if database is healthy
-    bool healthy() const { return (_queue.items != nullptr) && (_database.items != nullptr); }
+    bool healthy() const { return (_queue.items != nullptr) && (_database.items != nullptr) && (_hash.head != nullptr); }
 
     // fetch an item in database. Undefined result when i >= _database.count.
     const OA_DbItem& get_item(uint32_t i) const { return _database.items[i]; }
@@ -64,11 +68,39 @@ private:
     void init_queue();
     void init_database();
 
+    // initialise spatial hash of database items
+    void init_hash();
+
+    // returns true if objects should be rejected because the vehicle is low and near home
+    bool reject_low_altitude_near_home() const;
+
+    // convert distance to obstacle into an item and check it is within the maximum distance
+    // returns false if the item should be ignored
+    bool make_item(const Vector3f &pos, uint32_t timestamp_ms, float distance, OA_DbItem &item) const;
+
     // database item management
     void database_item_add(const OA_DbItem &item);
     void database_item_refresh(const uint16_t index, const uint32_t timestamp_ms, const float radius);
     void database_item_remove(const uint16_t index);
-    void database_items_remove_all_expired();
+    void database_items_remove_expired(uint16_t num_buckets);
+
+    // spatial hash helpers.  Items are hashed by the grid cell holding their position
+    void hash_cell(const Vector3f &pos, int32_t &x, int32_t &y, int32_t &z) const;
+    uint16_t hash_bucket(int32_t x, int32_t y, int32_t z) const;
+    uint16_t hash_bucket(const Vector3f &pos) const;
+    uint16_t *hash_find_link(const uint16_t index);
+    void hash_link(const uint16_t index);
+    void hash_unlink(const uint16_t index);
+    void hash_replace(const uint16_t old_index, const uint16_t new_index);
+    static constexpr uint16_t HASH_END = UINT16_MAX;
+
+    // returns index of a database item close to item or -1 if none found
+    int32_t find_close_item_in_database(const OA_DbItem &item) const;
+
+#if HAL_LOGGING_ENABLED
+    // log queue and database statistics
+    void Write_OADatabase();
+#endif
 
     // get bitmask of gcs channels item should be sent to based on its importance
     // returns 0xFF (send to all channels) if should be sent or 0 if it should not be sent
@@ -99,6 +131,7 @@ private:
         ObjectBuffer<OA_DbItem> *items;                     // thread safe incoming queue of points from proximity sensor to be put into database
         uint16_t        size;                               // cached value of _queue_size_param.
         HAL_Semaphore   sem;                                // semaphore for multi-thread use of queue
+        uint32_t        drops;                              // number of items dropped because the queue was full
     } _queue;
     float dist_to_radius_scalar;                            // scalar to convert the distance and beam width to an object radius
 
@@ -108,6 +141,22 @@ private:
         uint16_t        size;                               // cached value of _database_size_param that sticks after initialized
     } _database;
 
+    struct {
+        uint16_t        *head;                              // index of first item in each bucket or HASH_END if empty
+        uint16_t        *next;                              // index of next item in the same bucket (one per database item)
+        uint16_t        num_buckets;                        // number of buckets (a power of two)
+        float           max_radius;                         // upper bound on the radius of all items in the database
+        float           sweep_max_radius;                   // largest radius seen during the current expiry sweep
+        uint16_t        next_expiry_bucket;                 // next bucket to be checked for expired items
+    } _hash;
+
+    struct {
+        uint32_t        processed;                          // items taken from the queue since last log
+        uint16_t        latency_max_ms;                     // highest time from an item's timestamp to it being processed
+        uint16_t        process_time_max_us;                // longest time spent in a single process_queue call
+        uint32_t        last_drops;                         // _queue.drops when last logged
+    } _stats;
+
     uint16_t _next_index_to_send[MAVLINK_COMM_NUM_BUFFERS]; // index of next object in _database to send to GCS
     uint16_t _highest_index_sent[MAVLINK_COMM_NUM_BUFFERS]; // highest index in _database sent to GCS
     uint32_t _last_send_to_gcs_ms[MAVLINK_COMM_NUM_BUFFERS];// system time that send_adsb_vehicle was last called
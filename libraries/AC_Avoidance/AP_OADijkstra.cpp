@@ -31,6 +31,7 @@
 #define OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK  32      // expanding arrays for fence points and paths to destination will grow in increments of 20 elements
 #define OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX        255     // index use to indicate we do not have a tentative short path for a node
 #define OA_DIJKSTRA_ERROR_REPORTING_INTERVAL_MS         5000    // failure messages sent to GCS every 5 seconds
+#define OA_DIJKSTRA_FENCE_BLOCKERS_NUMPOINTS_MAX        100     // fence visgraph results are only kept for reuse with this many fence points or fewer (one byte per pair of points, about 5k)
 
 /// Constructor
 AP_OADijkstra::AP_OADijkstra(AP_Int16 &options) :
@@ -38,6 +39,7 @@ AP_OADijkstra::AP_OADijkstra(AP_Int16 &options) :
         _exclusion_polygon_pts(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _exclusion_circle_pts(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _short_path_data(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
+        _short_path_heap(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _path(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _options(options)
 {
@@ -608,71 +610,222 @@ bool AP_OADijkstra::get_point(uint16_t index, Vector2f &point) const
     return false;
 }
 
-// returns true if line segment intersects polygon or circular fence
-bool AP_OADijkstra::intersects_fence(const Vector2f &seg_start, const Vector2f &seg_end) const
+// returns bitmask of fence types (from fence_types) intersected by line segment
+// if stop_at_first is true the bitmask holds only the first fence type found
+uint8_t AP_OADijkstra::fence_types_intersected(const Vector2f &seg_start, const Vector2f &seg_end, uint8_t fence_types, bool stop_at_first) const
 {
     // return immediately if fence is not enabled
     const AC_Fence *fence = AC_Fence::get_singleton();
     if (fence == nullptr) {
-        return false;
+        return 0;
     }
 
-    // determine if segment crosses any of the inclusion polygons
-    uint16_t num_points = 0;
-    for (uint8_t i = 0; i < fence->polyfence().get_inclusion_polygon_count(); i++) {
-        const Vector2f* boundary = fence->polyfence().get_inclusion_polygon(i, num_points);
-        if (boundary != nullptr) {
-            Vector2f intersection;
-            if (Polygon_intersects(boundary, num_points, seg_start, seg_end, intersection)) {
-                return true;
+    uint8_t found = 0;
+    const uint8_t polygon_types = fence_types & ((1U << FENCE_TYPE_INCLUSION) | (1U << FENCE_TYPE_EXCLUSION_POLYGON));
+    if (_fence_segment_grid.valid()) {
+        // use segment grid to check only polygon edges near the line segment
+        found |= _fence_segment_grid.intersecting_types(seg_start, seg_end, polygon_types, stop_at_first);
+        if (stop_at_first && (found != 0)) {
+            return found;
+        }
+    } else {
+        // determine if segment crosses any of the inclusion polygons
+        uint16_t num_points = 0;
+        if (polygon_types & (1U << FENCE_TYPE_INCLUSION)) {
+            for (uint8_t i = 0; i < fence->polyfence().get_inclusion_polygon_count(); i++) {
+                const Vector2f* boundary = fence->polyfence().get_inclusion_polygon(i, num_points);
+                if (boundary != nullptr) {
+                    Vector2f intersection;
+                    if (Polygon_intersects(boundary, num_points, seg_start, seg_end, intersection)) {
+                        found |= (1U << FENCE_TYPE_INCLUSION);
+                        if (stop_at_first) {
+                            return found;
+                        }
+                        break;
+                    }
+                }
             }
         }
-    }
 
-    // determine if segment crosses any of the exclusion polygons
-    for (uint8_t i = 0; i < fence->polyfence().get_exclusion_polygon_count(); i++) {
-        const Vector2f* boundary = fence->polyfence().get_exclusion_polygon(i, num_points);
-        if (boundary != nullptr) {
-            Vector2f intersection;
-            if (Polygon_intersects(boundary, num_points, seg_start, seg_end, intersection)) {
-                return true;
+        // determine if segment crosses any of the exclusion polygons
+        if (polygon_types & (1U << FENCE_TYPE_EXCLUSION_POLYGON)) {
+            for (uint8_t i = 0; i < fence->polyfence().get_exclusion_polygon_count(); i++) {
+                const Vector2f* boundary = fence->polyfence().get_exclusion_polygon(i, num_points);
+                if (boundary != nullptr) {
+                    Vector2f intersection;
+                    if (Polygon_intersects(boundary, num_points, seg_start, seg_end, intersection)) {
+                        found |= (1U << FENCE_TYPE_EXCLUSION_POLYGON);
+                        if (stop_at_first) {
+                            return found;
+                        }
+                        break;
+                    }
+                }
             }
         }
     }
 
     // determine if segment crosses any of the inclusion circles
-    for (uint8_t i = 0; i < fence->polyfence().get_inclusion_circle_count(); i++) {
-        Vector2f center_pos_cm;
-        float radius;
-        if (fence->polyfence().get_inclusion_circle(i, center_pos_cm, radius)) {
-            // intersects circle if either start or end is further from the center than the radius
-            const float radius_cm_sq = sq(radius * 100.0f) ;
-            if ((seg_start - center_pos_cm).length_squared() > radius_cm_sq) {
-                return true;
-            }
-            if ((seg_end - center_pos_cm).length_squared() > radius_cm_sq) {
-                return true;
+    if ((fence_types & (1U << FENCE_TYPE_INCLUSION)) && !(found & (1U << FENCE_TYPE_INCLUSION))) {
+        for (uint8_t i = 0; i < fence->polyfence().get_inclusion_circle_count(); i++) {
+            Vector2f center_pos_cm;
+            float radius;
+            if (fence->polyfence().get_inclusion_circle(i, center_pos_cm, radius)) {
+                // intersects circle if either start or end is further from the center than the radius
+                const float radius_cm_sq = sq(radius * 100.0f) ;
+                if (((seg_start - center_pos_cm).length_squared() > radius_cm_sq) ||
+                    ((seg_end - center_pos_cm).length_squared() > radius_cm_sq)) {
+                    found |= (1U << FENCE_TYPE_INCLUSION);
+                    if (stop_at_first) {
+                        return found;
+                    }
+                    break;
+                }
             }
         }
     }
 
     // determine if segment crosses any of the exclusion circles
-    for (uint8_t i = 0; i < fence->polyfence().get_exclusion_circle_count(); i++) {
-        Vector2f center_pos_cm;
-        float radius;
-        if (fence->polyfence().get_exclusion_circle(i, center_pos_cm, radius)) {
-            // calculate distance between circle's center and segment
-            const float dist_cm = Vector2f::closest_distance_between_line_and_point(seg_start, seg_end, center_pos_cm);
-
-            // intersects if distance is less than radius
-            if (dist_cm <= (radius * 100.0f)) {
-                return true;
+    if (fence_types & (1U << FENCE_TYPE_EXCLUSION_CIRCLE)) {
+        for (uint8_t i = 0; i < fence->polyfence().get_exclusion_circle_count(); i++) {
+            Vector2f center_pos_cm;
+            float radius;
+            if (fence->polyfence().get_exclusion_circle(i, center_pos_cm, radius)) {
+                // calculate distance between circle's center and segment
+                const float dist_cm = Vector2f::closest_distance_between_line_and_point(seg_start, seg_end, center_pos_cm);
+
+                // intersects if distance is less than radius
+                if (dist_cm <= (radius * 100.0f)) {
+                    found |= (1U << FENCE_TYPE_EXCLUSION_CIRCLE);
+                    break;
+                }
             }
         }
     }
 
-    // if we got this far then no intersection
-    return false;
+    return found;
+}
+
+// build segment grid of inclusion and exclusion polygon edges used by fence_types_intersected
+// returns true on success.  on failure intersects_fence checks every polygon edge
+bool AP_OADijkstra::create_fence_segment_grid()
+{
+    _fence_segment_grid.clear();
+
+    const AC_Fence *fence = AC_Fence::get_singleton();
+    if (fence == nullptr) {
+        return false;
+    }
+
+    // count polygon edges
+    uint16_t num_points;
+    uint32_t num_segments = 0;
+    for (uint8_t i = 0; i < fence->polyfence().get_inclusion_polygon_count(); i++) {
+        if (fence->polyfence().get_inclusion_polygon(i, num_points) != nullptr) {
+            num_segments += num_points;
+        }
+    }
+    for (uint8_t i = 0; i < fence->polyfence().get_exclusion_polygon_count(); i++) {
+        if (fence->polyfence().get_exclusion_polygon(i, num_points) != nullptr) {
+            num_segments += num_points;
+        }
+    }
+    if (num_segments > UINT16_MAX || !_fence_segment_grid.init(num_segments)) {
+        return false;
+    }
+
+    // add polygon edges
+    for (uint8_t i = 0; i < fence->polyfence().get_inclusion_polygon_count(); i++) {
+        const Vector2f* boundary = fence->polyfence().get_inclusion_polygon(i, num_points);
+        if ((boundary != nullptr) && !_fence_segment_grid.add_polygon(boundary, num_points, 1U << FENCE_TYPE_INCLUSION)) {
+            _fence_segment_grid.clear();
+            return false;
+        }
+    }
+    for (uint8_t i = 0; i < fence->polyfence().get_exclusion_polygon_count(); i++) {
+        const Vector2f* boundary = fence->polyfence().get_exclusion_polygon(i, num_points);
+        if ((boundary != nullptr) && !_fence_segment_grid.add_polygon(boundary, num_points, 1U << FENCE_TYPE_EXCLUSION_POLYGON)) {
+            _fence_segment_grid.clear();
+            return false;
+        }
+    }
+
+    if (!_fence_segment_grid.build()) {
+        _fence_segment_grid.clear();
+        return false;
+    }
+    return true;
+}
+
+// returns the fence type of a point returned by get_point
+AP_OADijkstra::FenceType AP_OADijkstra::get_point_fence_type(uint16_t index) const
+{
+    if (index < _inclusion_polygon_numpoints) {
+        return FENCE_TYPE_INCLUSION;
+    }
+    if (index < _inclusion_polygon_numpoints + _exclusion_polygon_numpoints) {
+        return FENCE_TYPE_EXCLUSION_POLYGON;
+    }
+    return FENCE_TYPE_EXCLUSION_CIRCLE;
+}
+
+// returns a crc of a fence type's geometry and points (with margin)
+// used to detect which fence types have changed since the visgraph was last built
+uint32_t AP_OADijkstra::get_fence_type_crc(FenceType type) const
+{
+    const AC_Fence *fence = AC_Fence::get_singleton();
+    if (fence == nullptr) {
+        return 0;
+    }
+
+    uint32_t crc = 0;
+    uint16_t num_points;
+    Vector2f center_pos_cm;
+    float radius;
+    switch (type) {
+    case FENCE_TYPE_INCLUSION:
+        for (uint8_t i = 0; i < fence->polyfence().get_inclusion_polygon_count(); i++) {
+            const Vector2f* boundary = fence->polyfence().get_inclusion_polygon(i, num_points);
+            if (boundary != nullptr) {
+                crc = crc_crc32(crc, (const uint8_t *)boundary, num_points * sizeof(Vector2f));
+            }
+        }
+        for (uint8_t i = 0; i < fence->polyfence().get_inclusion_circle_count(); i++) {
+            if (fence->polyfence().get_inclusion_circle(i, center_pos_cm, radius)) {
+                crc = crc_crc32(crc, (const uint8_t *)&center_pos_cm, sizeof(center_pos_cm));
+                crc = crc_crc32(crc, (const uint8_t *)&radius, sizeof(radius));
+            }
+        }
+        for (uint16_t i = 0; i < _inclusion_polygon_numpoints; i++) {
+            crc = crc_crc32(crc, (const uint8_t *)&_inclusion_polygon_pts[i], sizeof(Vector2f));
+        }
+        break;
+    case FENCE_TYPE_EXCLUSION_POLYGON:
+        for (uint8_t i = 0; i < fence->polyfence().get_exclusion_polygon_count(); i++) {
+            const Vector2f* boundary = fence->polyfence().get_exclusion_polygon(i, num_points);
+            if (boundary != nullptr) {
+                crc = crc_crc32(crc, (const uint8_t *)boundary, num_points * sizeof(Vector2f));
+            }
+        }
+        for (uint16_t i = 0; i < _exclusion_polygon_numpoints; i++) {
+            crc = crc_crc32(crc, (const uint8_t *)&_exclusion_polygon_pts[i], sizeof(Vector2f));
+        }
+        break;
+    case FENCE_TYPE_EXCLUSION_CIRCLE:
+        for (uint8_t i = 0; i < fence->polyfence().get_exclusion_circle_count(); i++) {
+            if (fence->polyfence().get_exclusion_circle(i, center_pos_cm, radius)) {
+                crc = crc_crc32(crc, (const uint8_t *)&center_pos_cm, sizeof(center_pos_cm));
+                crc = crc_crc32(crc, (const uint8_t *)&radius, sizeof(radius));
+            }
+        }
+        for (uint16_t i = 0; i < _exclusion_circle_numpoints; i++) {
+            crc = crc_crc32(crc, (const uint8_t *)&_exclusion_circle_pts[i], sizeof(Vector2f));
+        }
+        break;
+    case FENCE_TYPE_COUNT:
+        break;
+    }
+    return crc;
 }
 
 // create visibility graph for all fence (with margin) points
@@ -693,22 +846,74 @@ bool AP_OADijkstra::create_fence_visgraph(AP_OADijkstra_Error &err_id)
         return false;
     }
 
+    // index polygon edges to speed up intersection checks.  failure is not fatal because intersects_fence
+    // falls back to checking every edge
+    create_fence_segment_grid();
+
+    // destination visgraph and adjacency lists refer to the old fence
+    _destination_visgraph_ok = false;
+    free_fence_adjacency();
+
+    // find fence types that have changed since the visgraph was last built
+    const uint16_t numpoints = total_numpoints();
+    const uint16_t first_point[FENCE_TYPE_COUNT] {
+        0,
+        _inclusion_polygon_numpoints,
+        uint16_t(_inclusion_polygon_numpoints + _exclusion_polygon_numpoints)
+    };
+    uint32_t crc[FENCE_TYPE_COUNT];
+    uint8_t changed_types = 0;
+    for (uint8_t t = 0; t < FENCE_TYPE_COUNT; t++) {
+        crc[t] = get_fence_type_crc((FenceType)t);
+        const uint16_t num_type_points = ((t + 1 < FENCE_TYPE_COUNT) ? first_point[t+1] : numpoints) - first_point[t];
+        const uint16_t old_num_type_points = ((t + 1 < FENCE_TYPE_COUNT) ? _fence_blockers_first_point[t+1] : _fence_blockers_numpoints) - _fence_blockers_first_point[t];
+        if ((_fence_blockers == nullptr) || (crc[t] != _fence_type_crc[t]) || (num_type_points != old_num_type_points)) {
+            changed_types |= (1U << t);
+        }
+    }
+
+    // record which fence types block each line so the next rebuild need only recheck lines against changed fences
+    // this uses memory proportional to the square of the number of points so is skipped for large fences
+    // if it is skipped or cannot be allocated, the graph is built without it and the next rebuild will be a full rebuild
+    const uint32_t num_pairs = (numpoints > 1) ? fence_blockers_index(numpoints - 2, numpoints - 1, numpoints) + 1 : 0;
+    uint8_t *blockers = ((num_pairs > 0) && (numpoints <= OA_DIJKSTRA_FENCE_BLOCKERS_NUMPOINTS_MAX)) ? NEW_NOTHROW uint8_t[num_pairs] : nullptr;
+
     // clear fence points visibility graph
     _fence_visgraph.clear();
 
     // calculate distance from each point to all other points
-    for (uint8_t i = 0; i < total_numpoints() - 1; i++) {
+    for (uint8_t i = 0; i < numpoints - 1; i++) {
         Vector2f start_seg;
         if (get_point(i, start_seg)) {
-            for (uint8_t j = i + 1; j < total_numpoints(); j++) {
+            const FenceType type_i = get_point_fence_type(i);
+            for (uint8_t j = i + 1; j < numpoints; j++) {
                 Vector2f end_seg;
                 if (get_point(j, end_seg)) {
+                    uint8_t blocking_types;
+                    if (blockers == nullptr) {
+                        blocking_types = intersects_fence(start_seg, end_seg) ? FENCE_TYPES_ALL : 0;
+                    } else {
+                        const FenceType type_j = get_point_fence_type(j);
+                        if ((changed_types & ((1U << type_i) | (1U << type_j))) == 0) {
+                            // neither point has moved so reuse the previous result for unchanged fences
+                            const uint16_t old_i = _fence_blockers_first_point[type_i] + (i - first_point[type_i]);
+                            const uint16_t old_j = _fence_blockers_first_point[type_j] + (j - first_point[type_j]);
+                            blocking_types = _fence_blockers[fence_blockers_index(old_i, old_j, _fence_blockers_numpoints)] & ~changed_types;
+                            if (changed_types != 0) {
+                                blocking_types |= fence_types_intersected(start_seg, end_seg, changed_types, false);
+                            }
+                        } else {
+                            blocking_types = fence_types_intersected(start_seg, end_seg, FENCE_TYPES_ALL, false);
+                        }
+                        blockers[fence_blockers_index(i, j, numpoints)] = blocking_types;
+                    }
                     // if line segment does not intersect with any inclusion or exclusion zones add to visgraph
-                    if (!intersects_fence(start_seg, end_seg)) {
+                    if (blocking_types == 0) {
                         if (!_fence_visgraph.add_item({AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, i},
                                                       {AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, j},
                                                       (start_seg - end_seg).length())) {
                             // failure to add a point can only be caused by out-of-memory
+                            delete[] blockers;
                             err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
                             return false;
                         }
@@ -718,6 +923,65 @@ bool AP_OADijkstra::create_fence_visgraph(AP_OADijkstra_Error &err_id)
         }
     }
 
+    // keep results for the next rebuild
+    delete[] _fence_blockers;
+    _fence_blockers = blockers;
+    _fence_blockers_numpoints = numpoints;
+    memcpy(_fence_blockers_first_point, first_point, sizeof(_fence_blockers_first_point));
+    memcpy(_fence_type_crc, crc, sizeof(_fence_type_crc));
+
+    // failure to create adjacency lists is not fatal, update_visible_node_distances will search the whole graph
+    create_fence_adjacency();
+
+    return true;
+}
+
+// free fence visgraph adjacency lists
+void AP_OADijkstra::free_fence_adjacency()
+{
+    delete[] _fence_adjacency_start;
+    _fence_adjacency_start = nullptr;
+    delete[] _fence_adjacency;
+    _fence_adjacency = nullptr;
+}
+
+// create adjacency lists holding the fence visgraph items which include each fence point
+// returns true on success
+bool AP_OADijkstra::create_fence_adjacency()
+{
+    free_fence_adjacency();
+
+    const uint16_t numpoints = total_numpoints();
+    const uint32_t num_entries = 2U * _fence_visgraph.num_items();
+    if (num_entries > UINT16_MAX) {
+        return false;
+    }
+    _fence_adjacency_start = NEW_NOTHROW uint16_t[numpoints + 1];
+    _fence_adjacency = NEW_NOTHROW uint16_t[MAX(num_entries, 1U)];
+    if ((_fence_adjacency_start == nullptr) || (_fence_adjacency == nullptr)) {
+        free_fence_adjacency();
+        return false;
+    }
+
+    // count items for each point (offset by one for the prefix sum below)
+    for (uint16_t i = 0; i < _fence_visgraph.num_items(); i++) {
+        _fence_adjacency_start[_fence_visgraph[i].id1.id_num + 1]++;
+        _fence_adjacency_start[_fence_visgraph[i].id2.id_num + 1]++;
+    }
+    for (uint16_t p = 0; p < numpoints; p++) {
+        _fence_adjacency_start[p+1] += _fence_adjacency_start[p];
+    }
+
+    // fill in lists using _fence_adjacency_start as the insertion point, then shift back
+    for (uint16_t i = 0; i < _fence_visgraph.num_items(); i++) {
+        _fence_adjacency[_fence_adjacency_start[_fence_visgraph[i].id1.id_num]++] = i;
+        _fence_adjacency[_fence_adjacency_start[_fence_visgraph[i].id2.id_num]++] = i;
+    }
+    for (uint16_t p = numpoints; p > 0; p--) {
+        _fence_adjacency_start[p] = _fence_adjacency_start[p-1];
+    }
+    _fence_adjacency_start[0] = 0;
+
     return true;
 }
 
@@ -767,12 +1031,32 @@ void AP_OADijkstra::update_visible_node_distances(node_index curr_node_idx)
     // get current node for convenience
     const ShortPathNode &curr_node = _short_path_data[curr_node_idx];
 
+    // use adjacency lists to find fence visgraph items visible from fence points
+    const bool use_adjacency = (_fence_adjacency_start != nullptr) &&
+                               (curr_node.id.id_type == AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT) &&
+                               (curr_node.id.id_num < total_numpoints());
+    if (use_adjacency) {
+        for (uint16_t k = _fence_adjacency_start[curr_node.id.id_num]; k < _fence_adjacency_start[curr_node.id.id_num + 1]; k++) {
+            const AP_OAVisGraph::VisGraphItem &item = _fence_visgraph[_fence_adjacency[k]];
+            const AP_OAVisGraph::OAItemID &matching_id = (curr_node.id == item.id1) ? item.id2 : item.id1;
+            node_index item_node_idx;
+            if (find_node_from_id(matching_id, item_node_idx)) {
+                update_node_distance(item_node_idx, curr_node_idx, curr_node.distance_cm + item.distance_cm);
+            }
+        }
+    }
+
     // for each visibility graph
     const AP_OAVisGraph* visgraphs[] = {&_fence_visgraph, &_destination_visgraph};
     for (uint8_t v=0; v<ARRAY_SIZE(visgraphs); v++) {
 
-        // skip if empty
+        // skip fence visgraph if already handled with adjacency lists
         const AP_OAVisGraph &curr_visgraph = *visgraphs[v];
+        if (use_adjacency && (&curr_visgraph == &_fence_visgraph)) {
+            continue;
+        }
+
+        // skip if empty
         if (curr_visgraph.num_items() == 0) {
             continue;
         }
@@ -787,18 +1071,82 @@ void AP_OADijkstra::update_visible_node_distances(node_index curr_node_idx)
                 node_index item_node_idx;
                 if (find_node_from_id(matching_id, item_node_idx)) {
                     // if current node's distance + distance to item is less than item's current distance, update item's distance
-                    const float dist_to_item_via_current_node = _short_path_data[curr_node_idx].distance_cm + item.distance_cm;
-                    if (dist_to_item_via_current_node < _short_path_data[item_node_idx].distance_cm) {
-                        // update item's distance and set "distance_from_idx" to current node's index
-                        _short_path_data[item_node_idx].distance_cm = dist_to_item_via_current_node;
-                        _short_path_data[item_node_idx].distance_from_idx = curr_node_idx;
-                    }
+                    update_node_distance(item_node_idx, curr_node_idx, curr_node.distance_cm + item.distance_cm);
                 }
             }
         }
     }
 }
 
+// update a node's tentative distance if it is shorter than its current distance
+void AP_OADijkstra::update_node_distance(node_index node_idx, node_index from_idx, float distance_cm)
+{
+    ShortPathNode &node = _short_path_data[node_idx];
+    if (node.visited || (distance_cm >= node.distance_cm)) {
+        return;
+    }
+    const bool in_heap = (node.distance_cm < FLT_MAX);
+
+    // update item's distance and set "distance_from_idx" to current node's index
+    node.distance_cm = distance_cm;
+    node.distance_from_idx = from_idx;
+
+    if (in_heap) {
+        // distance has decreased so node can only move towards the top of the heap
+        heap_sift_up(node.heap_pos);
+        return;
+    }
+    // add node to bottom of heap.  heap was sized to hold all nodes in calc_shortest_path
+    node.heap_pos = _short_path_heap_numitems;
+    _short_path_heap[_short_path_heap_numitems++] = node_idx;
+    heap_sift_up(node.heap_pos);
+}
+
+// swap two nodes in the heap
+void AP_OADijkstra::heap_swap(uint16_t pos1, uint16_t pos2)
+{
+    const node_index node1 = _short_path_heap[pos1];
+    const node_index node2 = _short_path_heap[pos2];
+    _short_path_heap[pos1] = node2;
+    _short_path_heap[pos2] = node1;
+    _short_path_data[node2].heap_pos = pos1;
+    _short_path_data[node1].heap_pos = pos2;
+}
+
+// move node at pos towards the top of the heap until its parent's key is no larger
+void AP_OADijkstra::heap_sift_up(uint16_t pos)
+{
+    while (pos > 0) {
+        const uint16_t parent = (pos - 1) / 2;
+        if (heap_key(_short_path_heap[parent]) <= heap_key(_short_path_heap[pos])) {
+            break;
+        }
+        heap_swap(pos, parent);
+        pos = parent;
+    }
+}
+
+// move node at pos towards the bottom of the heap until its children's keys are no smaller
+void AP_OADijkstra::heap_sift_down(uint16_t pos)
+{
+    while (true) {
+        const uint16_t left = 2 * pos + 1;
+        const uint16_t right = left + 1;
+        uint16_t smallest = pos;
+        if ((left < _short_path_heap_numitems) && (heap_key(_short_path_heap[left]) < heap_key(_short_path_heap[smallest]))) {
+            smallest = left;
+        }
+        if ((right < _short_path_heap_numitems) && (heap_key(_short_path_heap[right]) < heap_key(_short_path_heap[smallest]))) {
+            smallest = right;
+        }
+        if (smallest == pos) {
+            return;
+        }
+        heap_swap(pos, smallest);
+        pos = smallest;
+    }
+}
+
 // find a node's index into _short_path_data array from it's id (i.e. id type and id number)
 // returns true if successful and node_idx is updated
 bool AP_OADijkstra::find_node_from_id(const AP_OAVisGraph::OAItemID &id, node_index &node_idx) const
@@ -831,45 +1179,27 @@ bool AP_OADijkstra::find_node_from_id(const AP_OAVisGraph::OAItemID &id, node_in
     return false;
 }
 
-// find index of node with lowest tentative distance (ignore visited nodes)
+// find index of node with lowest tentative distance (ignore visited nodes), remove it from the heap and mark it visited
 // returns true if successful and node_idx argument is updated
-bool AP_OADijkstra::find_closest_node_idx(node_index &node_idx) const
+bool AP_OADijkstra::find_closest_node_idx(node_index &node_idx)
 {
-    node_index lowest_idx = 0;
-    float lowest_dist = FLT_MAX;
-
-    // scan through all nodes looking for closest
-    for (node_index i=0; i<_short_path_data_numpoints; i++) {
-        const ShortPathNode &node = _short_path_data[i];
-        if (node.visited || is_equal(_short_path_data[i].distance_cm, FLT_MAX)) {
-            // if node is already visited OR cannot be reached yet, we can't use it
-            continue;
-        }
-        // figure out the pos of this node
-        Vector2f node_pos;
-        float dist_with_heuristics = FLT_MAX;
-        if (convert_node_to_point(node.id, node_pos)) {
-            // heuristics is is simple Euclidean distance from the node to the destination
-            // This should be admissible, therefore optimal path is guaranteed
-            const float heuristics = (node_pos-_path_destination).length();
-            dist_with_heuristics = node.distance_cm + heuristics;
-        } else {
-            // shouldn't happen
-            return false;
-        }
-        if (dist_with_heuristics < lowest_dist) {
-            // for NOW, this is the closest node
-            lowest_idx = i;
-            lowest_dist = dist_with_heuristics;
-        }
+    // heap only holds unvisited nodes which can be reached
+    if (_short_path_heap_numitems == 0) {
+        return false;
     }
 
-    if (lowest_dist < FLT_MAX) {
-        // found the closest node
-        node_idx = lowest_idx;
-        return true;
+    // closest node is at the top of the heap, heuristics are the Euclidean distance from the node to the destination
+    // This should be admissible, therefore optimal path is guaranteed
+    node_idx = _short_path_heap[0];
+    _short_path_data[node_idx].visited = true;
+
+    // move last node to the top and restore heap order
+    _short_path_heap_numitems--;
+    if (_short_path_heap_numitems > 0) {
+        heap_swap(0, _short_path_heap_numitems);
+        heap_sift_down(0);
     }
-    return false;
+    return true;
 }
 
 // calculate shortest path from origin to destination
@@ -885,47 +1215,59 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
     }
 
     // create visgraphs of origin and destination to fence points
+    // the destination visgraph only changes if the destination or fence changes
     if (!update_visgraph(_source_visgraph, {AP_OAVisGraph::OATYPE_SOURCE, 0}, _path_source, true, _path_destination)) {
         err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
         return false;
     }
-    if (!update_visgraph(_destination_visgraph, {AP_OAVisGraph::OATYPE_DESTINATION, 0}, _path_destination)) {
-        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
-        return false;
+    if (!_destination_visgraph_ok || (_destination_visgraph_pos != _path_destination)) {
+        _destination_visgraph_ok = update_visgraph(_destination_visgraph, {AP_OAVisGraph::OATYPE_DESTINATION, 0}, _path_destination);
+        if (!_destination_visgraph_ok) {
+            err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
+            return false;
+        }
+        _destination_visgraph_pos = _path_destination;
     }
 
-    // expand _short_path_data if necessary
-    if (!_short_path_data.expand_to_hold(2 + total_numpoints())) {
+    // expand _short_path_data and heap if necessary
+    if (!_short_path_data.expand_to_hold(2 + total_numpoints()) || !_short_path_heap.expand_to_hold(2 + total_numpoints())) {
         err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
         return false;
     }
 
-    // add origin and destination (node_type, id, visited, distance_from_idx, distance_cm) to short_path_data array
-    _short_path_data[0] = {{AP_OAVisGraph::OATYPE_SOURCE, 0}, false, 0, 0};
-    _short_path_data[1] = {{AP_OAVisGraph::OATYPE_DESTINATION, 0}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX};
+    // add origin and destination (node_type, id, visited, distance_from_idx, distance_cm, heuristic_cm, heap_pos) to short_path_data array
+    _short_path_data[0] = {{AP_OAVisGraph::OATYPE_SOURCE, 0}, false, 0, 0, (_path_source - _path_destination).length(), 0};
+    _short_path_data[1] = {{AP_OAVisGraph::OATYPE_DESTINATION, 0}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX, 0, 0};
     _short_path_data_numpoints = 2;
+    _short_path_heap_numitems = 0;
 
-    // add all inclusion and exclusion fence points to short_path_data array (node_type, id, visited, distance_from_idx, distance_cm)
+    // add all inclusion and exclusion fence points to short_path_data array
     for (uint8_t i=0; i<total_numpoints(); i++) {
-        _short_path_data[_short_path_data_numpoints++] = {{AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, i}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX};
+        Vector2f node_pos;
+        if (!get_point(i, node_pos)) {
+            // shouldn't happen
+            err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
+            return false;
+        }
+        _short_path_data[_short_path_data_numpoints++] = {{AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, i}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX, (node_pos - _path_destination).length(), 0};
     }
 
     // start algorithm from source point
     node_index current_node_idx = 0;
 
+    // mark source node as visited
+    _short_path_data[current_node_idx].visited = true;
+
     // update nodes visible from source point
     for (uint16_t i = 0; i < _source_visgraph.num_items(); i++) {
         node_index node_idx;
         if (find_node_from_id(_source_visgraph[i].id2, node_idx)) {
-            _short_path_data[node_idx].distance_cm = _source_visgraph[i].distance_cm;
-            _short_path_data[node_idx].distance_from_idx = current_node_idx;
+            update_node_distance(node_idx, current_node_idx, _source_visgraph[i].distance_cm);
         } else {
             err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
             return false;
         }
     }
-    // mark source node as visited
-    _short_path_data[current_node_idx].visited = true;
 
     // move current_node_idx to node with lowest distance
     while (find_closest_node_idx(current_node_idx)) {
@@ -937,9 +1279,6 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
         }
         // update distances to all neighbours of current node
         update_visible_node_distances(current_node_idx);
-
-        // mark current node as visited
-        _short_path_data[current_node_idx].visited = true;
     }
 
     // extract path starting from destination
@@ -8,6 +8,7 @@
 #include <AP_Common/Location.h>
 #include <AP_Math/AP_Math.h>
 #include "AP_OAVisGraph.h"
+#include "AP_OASegmentGrid.h"
 #include <AP_Logger/AP_Logger_config.h>
 
 /*
@@ -15,6 +16,9 @@
  */
 
 class AP_OADijkstra {
+
+    friend class AP_OADijkstra_Test;
+
 public:
 
     AP_OADijkstra(AP_Int16 &options);
@@ -116,8 +120,34 @@ private:
     // also returns the type of point
     bool get_point(uint16_t index, Vector2f& point) const;
 
+    // fence types used to record which fences block a line segment
+    enum FenceType : uint8_t {
+        FENCE_TYPE_INCLUSION = 0,           // inclusion polygons and circles
+        FENCE_TYPE_EXCLUSION_POLYGON,       // exclusion polygons
+        FENCE_TYPE_EXCLUSION_CIRCLE,        // exclusion circles
+        FENCE_TYPE_COUNT
+    };
+    static const uint8_t FENCE_TYPES_ALL = (1U << FENCE_TYPE_COUNT) - 1;
+
     // returns true if line segment intersects polygon or circular fence
-    bool intersects_fence(const Vector2f &seg_start, const Vector2f &seg_end) const;
+    bool intersects_fence(const Vector2f &seg_start, const Vector2f &seg_end) const {
+        return fence_types_intersected(seg_start, seg_end, FENCE_TYPES_ALL, true) != 0;
+    }
+
+    // returns bitmask of fence types (from fence_types) intersected by line segment
+    // if stop_at_first is true the bitmask holds only the first fence type found
+    uint8_t fence_types_intersected(const Vector2f &seg_start, const Vector2f &seg_end, uint8_t fence_types, bool stop_at_first) const;
+
+    // build segment grid of inclusion and exclusion polygon edges used by fence_types_intersected
+    // returns true on success.  on failure intersects_fence checks every polygon edge
+    bool create_fence_segment_grid();
+
+    // returns the fence type of a point returned by get_point
+    FenceType get_point_fence_type(uint16_t index) const;
+
+    // returns a crc of a fence type's geometry and points (with margin)
+    // used to detect which fence types have changed since the visgraph was last built
+    uint32_t get_fence_type_crc(FenceType type) const;
 
     // create visibility graph for all fence (with margin) points
     // returns true on success.  returns false on failure and err_id is updated
@@ -161,6 +191,26 @@ private:
     AP_OAVisGraph _fence_visgraph;          // holds distances between all inclusion/exclusion fence points (with margin)
     AP_OAVisGraph _source_visgraph;         // holds distances from source point to all other nodes
     AP_OAVisGraph _destination_visgraph;    // holds distances from the destination to all other nodes
+    bool _destination_visgraph_ok;          // true if _destination_visgraph is valid for _destination_visgraph_pos and the current fence
+    Vector2f _destination_visgraph_pos;     // destination used to build _destination_visgraph (offset in cm from EKF origin)
+
+    // fence visgraph adjacency lists allowing the neighbours of a fence point to be found without searching the whole graph
+    uint16_t *_fence_adjacency_start;       // for each fence point, index of its first entry in _fence_adjacency (numpoints+1 entries)
+    uint16_t *_fence_adjacency;             // indexes into _fence_visgraph of items including each fence point
+    void free_fence_adjacency();
+    bool create_fence_adjacency();
+
+    // data kept from the last fence visgraph build so that only lines affected by changed fences are rechecked
+    AP_OASegmentGrid _fence_segment_grid;   // inclusion and exclusion polygon edges
+    uint8_t *_fence_blockers;               // for each pair of fence points, bitmask of fence types blocking the line between them.  nullptr for large fences
+    uint16_t _fence_blockers_numpoints;     // total number of fence points when _fence_blockers was built
+    uint16_t _fence_blockers_first_point[FENCE_TYPE_COUNT]; // index of first point of each fence type when _fence_blockers was built
+    uint32_t _fence_type_crc[FENCE_TYPE_COUNT]; // crc of each fence type when _fence_blockers was built
+
+    // returns index into _fence_blockers for the line between fence points i and j (where i < j)
+    static uint32_t fence_blockers_index(uint16_t i, uint16_t j, uint16_t numpoints) {
+        return (uint32_t)i * (2U * numpoints - i - 1) / 2 + (j - i - 1);
+    }
 
     // updates visibility graph for a given position which is an offset (in cm) from the ekf origin
     // to add an additional position (i.e. the destination) set add_extra_position = true and provide the position in the extra_position argument
@@ -174,6 +224,8 @@ private:
         bool visited;                   // true if all this node's neighbour's distances have been updated
         node_index distance_from_idx;   // index into _short_path_data from where distance was updated (or 255 if not set)
         float distance_cm;              // distance from source (number is tentative until this node is the current node and/or visited = true)
+        float heuristic_cm;             // straight line distance from node to destination
+        uint16_t heap_pos;              // position of node in _short_path_heap (only valid if node is in heap)
     };
     AP_ExpandingArray<ShortPathNode> _short_path_data;
     node_index _short_path_data_numpoints;  // number of elements in _short_path_data array
@@ -182,13 +234,25 @@ private:
     // curr_node_idx is an index into the _short_path_data array
     void update_visible_node_distances(node_index curr_node_idx);
 
+    // update a node's tentative distance if it is shorter than its current distance
+    void update_node_distance(node_index node_idx, node_index from_idx, float distance_cm);
+
+    // binary min-heap of unvisited nodes with a tentative distance, ordered by distance plus heuristic
+    // a node is in the heap if its distance_cm is less than FLT_MAX and it has not been visited
+    AP_ExpandingArray<node_index> _short_path_heap;
+    uint16_t _short_path_heap_numitems;     // number of nodes in heap
+    float heap_key(node_index node_idx) const { return _short_path_data[node_idx].distance_cm + _short_path_data[node_idx].heuristic_cm; }
+    void heap_swap(uint16_t pos1, uint16_t pos2);
+    void heap_sift_up(uint16_t pos);
+    void heap_sift_down(uint16_t pos);
+
     // find a node's index into _short_path_data array from it's id (i.e. id type and id number)
     // returns true if successful and node_idx is updated
     bool find_node_from_id(const AP_OAVisGraph::OAItemID &id, node_index &node_idx) const;
 
-    // find index of node with lowest tentative distance (ignore visited nodes)
+    // find index of node with lowest tentative distance (ignore visited nodes), remove it from the heap and mark it visited
     // returns true if successful and node_idx argument is updated
-    bool find_closest_node_idx(node_index &node_idx) const;
+    bool find_closest_node_idx(node_index &node_idx);
 
     // final path variables and functions
     AP_ExpandingArray<AP_OAVisGraph::OAItemID> _path;   // ids of points on return path in reverse order (i.e. destination is first element)
@@ -0,0 +1,285 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AP_OASegmentGrid.h"
+
+#if AP_OAPATHPLANNER_DIJKSTRA_ENABLED
+
+#define OA_SEGMENT_GRID_CELLS_MAX           16  // maximum number of cells along each axis
+#define OA_SEGMENT_GRID_ITEMS_PER_SEGMENT   8   // grid is coarsened if segments appear in more cells than this on average
+
+// release all memory and mark the grid invalid
+void AP_OASegmentGrid::clear()
+{
+    delete[] _segments;
+    _segments = nullptr;
+    delete[] _cell_start;
+    _cell_start = nullptr;
+    delete[] _cell_items;
+    _cell_items = nullptr;
+    _max_segments = 0;
+    _num_segments = 0;
+}
+
+// prepare to hold up to max_segments segments
+bool AP_OASegmentGrid::init(uint16_t max_segments)
+{
+    clear();
+    if (max_segments == 0) {
+        return true;
+    }
+    _segments = NEW_NOTHROW Segment[max_segments];
+    if (_segments == nullptr) {
+        return false;
+    }
+    _max_segments = max_segments;
+    return true;
+}
+
+// add the edges of polygon V of N points
+bool AP_OASegmentGrid::add_polygon(const Vector2f *V, uint16_t N, uint8_t type)
+{
+    // match Polygon_intersects's treatment of closed polygons
+    if (Polygon_complete(V, N)) {
+        N--;
+    }
+    if (_num_segments + N > _max_segments) {
+        return false;
+    }
+    for (uint16_t i = 0; i < N; i++) {
+        const uint16_t j = (i+1 >= N) ? 0 : i+1;
+        _segments[_num_segments++] = {V[i], V[j], type};
+    }
+    return true;
+}
+
+// build the grid once all segments have been added
+bool AP_OASegmentGrid::build()
+{
+    if (_num_segments == 0) {
+        // nothing to index, but queries are still valid
+        _num_cells = 1;
+        _cell_scale.zero();
+        _min.zero();
+        _max.zero();
+        _cell_start = NEW_NOTHROW uint32_t[2] {0, 0};
+        _cell_items = NEW_NOTHROW uint16_t[1];
+        return valid();
+    }
+
+    _min = _segments[0].start;
+    _max = _segments[0].start;
+    for (uint16_t i = 0; i < _num_segments; i++) {
+        const Segment &seg = _segments[i];
+        _min.x = MIN(_min.x, MIN(seg.start.x, seg.end.x));
+        _min.y = MIN(_min.y, MIN(seg.start.y, seg.end.y));
+        _max.x = MAX(_max.x, MAX(seg.start.x, seg.end.x));
+        _max.y = MAX(_max.y, MAX(seg.start.y, seg.end.y));
+    }
+
+    // start with about one segment per cell and coarsen the grid if
+    // long segments would make it too large
+    const Vector2f range = _max - _min;
+    _num_cells = constrain_int16(sqrtf(_num_segments), 1, OA_SEGMENT_GRID_CELLS_MAX);
+    uint32_t total;
+    while (true) {
+        _cell_scale.x = is_positive(range.x) ? _num_cells / range.x : 0;
+        _cell_scale.y = is_positive(range.y) ? _num_cells / range.y : 0;
+        total = populate_cells(nullptr, nullptr);
+        if (total <= (uint32_t)_num_segments * OA_SEGMENT_GRID_ITEMS_PER_SEGMENT || _num_cells == 1) {
+            break;
+        }
+        _num_cells /= 2;
+    }
+
+    const uint16_t num_cells_total = _num_cells * _num_cells;
+    _cell_start = NEW_NOTHROW uint32_t[num_cells_total+1];
+    _cell_items = NEW_NOTHROW uint16_t[total];
+    if (_cell_start == nullptr || _cell_items == nullptr) {
+        delete[] _cell_start;
+        _cell_start = nullptr;
+        delete[] _cell_items;
+        _cell_items = nullptr;
+        return false;
+    }
+    populate_cells(_cell_start, _cell_items);
+    return true;
+}
+
+// cell coordinate of a position along each axis.  These are
+// monotonic so anything within a bounding box is always found in the
+// cells covered by its corners
+uint8_t AP_OASegmentGrid::cell_x(float x) const
+{
+    const float c = (x - _min.x) * _cell_scale.x;
+    if (c <= 0) {
+        return 0;
+    }
+    if (c >= _num_cells - 1) {
+        return _num_cells - 1;
+    }
+    return uint8_t(c);
+}
+
+uint8_t AP_OASegmentGrid::cell_y(float y) const
+{
+    const float c = (y - _min.y) * _cell_scale.y;
+    if (c <= 0) {
+        return 0;
+    }
+    if (c >= _num_cells - 1) {
+        return _num_cells - 1;
+    }
+    return uint8_t(c);
+}
+
+// returns the total number of cell memberships of all segments
+uint32_t AP_OASegmentGrid::populate_cells(uint32_t *cell_start, uint16_t *cell_items) const
+{
+    const uint16_t num_cells_total = _num_cells * _num_cells;
+    if (cell_start != nullptr) {
+        memset(cell_start, 0, (num_cells_total+1)*sizeof(cell_start[0]));
+    }
+
+    // count segments in each cell (offset by one for the prefix sum below)
+    uint32_t total = 0;
+    for (uint16_t i = 0; i < _num_segments; i++) {
+        const Segment &seg = _segments[i];
+        const uint8_t x1 = cell_x(MIN(seg.start.x, seg.end.x));
+        const uint8_t x2 = cell_x(MAX(seg.start.x, seg.end.x));
+        const uint8_t y1 = cell_y(MIN(seg.start.y, seg.end.y));
+        const uint8_t y2 = cell_y(MAX(seg.start.y, seg.end.y));
+        total += (x2 - x1 + 1) * (y2 - y1 + 1);
+        if (cell_start == nullptr) {
+            continue;
+        }
+        for (uint8_t y = y1; y <= y2; y++) {
+            for (uint8_t x = x1; x <= x2; x++) {
+                cell_start[y * _num_cells + x + 1]++;
+            }
+        }
+    }
+    if (cell_start == nullptr) {
+        return total;
+    }
+
+    // convert counts to offsets then fill in each cell using
+    // cell_start[] as the insertion point
+    for (uint16_t c = 0; c < num_cells_total; c++) {
+        cell_start[c+1] += cell_start[c];
+    }
+    for (uint16_t i = 0; i < _num_segments; i++) {
+        const Segment &seg = _segments[i];
+        const uint8_t x1 = cell_x(MIN(seg.start.x, seg.end.x));
+        const uint8_t x2 = cell_x(MAX(seg.start.x, seg.end.x));
+        const uint8_t y1 = cell_y(MIN(seg.start.y, seg.end.y));
+        const uint8_t y2 = cell_y(MAX(seg.start.y, seg.end.y));
+        for (uint8_t y = y1; y <= y2; y++) {
+            for (uint8_t x = x1; x <= x2; x++) {
+                cell_items[cell_start[y * _num_cells + x]++] = i;
+            }
+        }
+    }
+    // each insertion point now holds the start of the following cell
+    for (uint16_t c = num_cells_total; c > 0; c--) {
+        cell_start[c] = cell_start[c-1];
+    }
+    cell_start[0] = 0;
+
+    return total;
+}
+
+// returns true if the line from p1 to p2 crosses segment seg
+// uses the same tests as Polygon_intersects
+bool AP_OASegmentGrid::segment_crossed(const Segment &seg, const Vector2f &p1, const Vector2f &p2)
+{
+    const Vector2f &v1 = seg.start;
+    const Vector2f &v2 = seg.end;
+    if (v1.x > p1.x && v2.x > p1.x && v1.x > p2.x && v2.x > p2.x) {
+        return false;
+    }
+    if (v1.y > p1.y && v2.y > p1.y && v1.y > p2.y && v2.y > p2.y) {
+        return false;
+    }
+    if (v1.x < p1.x && v2.x < p1.x && v1.x < p2.x && v2.x < p2.x) {
+        return false;
+    }
+    if (v1.y < p1.y && v2.y < p1.y && v1.y < p2.y && v2.y < p2.y) {
+        return false;
+    }
+    Vector2f intersection;
+    return Vector2f::segment_intersection(v1, v2, p1, p2, intersection);
+}
+
+// returns the bitmask of types (from type_mask) of segments intersected by the line from p1 to p2
+uint8_t AP_OASegmentGrid::find_intersections(const Vector2f &p1, const Vector2f &p2, uint8_t type_mask, bool stop_at_first) const
+{
+    if (!valid() || _num_segments == 0) {
+        return 0;
+    }
+
+    const Vector2f line_min {MIN(p1.x, p2.x), MIN(p1.y, p2.y)};
+    const Vector2f line_max {MAX(p1.x, p2.x), MAX(p1.y, p2.y)};
+    if (line_max.x < _min.x || line_min.x > _max.x ||
+        line_max.y < _min.y || line_min.y > _max.y) {
+        return 0;
+    }
+
+    // walk each row of cells the line passes through, checking only
+    // the cells in that row which the line crosses
+    uint8_t found = 0;
+    const uint8_t row_first = cell_y(line_min.y);
+    const uint8_t row_last = cell_y(line_max.y);
+    for (uint8_t row = row_first; row <= row_last; row++) {
+        float x_lo = line_min.x;
+        float x_hi = line_max.x;
+        if (row_first != row_last) {
+            // rows differ so the line is not horizontal and
+            // _cell_scale.y is non-zero
+            const float dy = p2.y - p1.y;
+            const float row_y_lo = _min.y + row / _cell_scale.y;
+            const float row_y_hi = _min.y + (row + 1) / _cell_scale.y;
+            const float t1 = constrain_float((row_y_lo - p1.y) / dy, 0.0f, 1.0f);
+            const float t2 = constrain_float((row_y_hi - p1.y) / dy, 0.0f, 1.0f);
+            const float x1 = p1.x + t1 * (p2.x - p1.x);
+            const float x2 = p1.x + t2 * (p2.x - p1.x);
+            x_lo = MIN(x1, x2);
+            x_hi = MAX(x1, x2);
+            // pad by half a cell to allow for rounding errors
+            if (is_positive(_cell_scale.x)) {
+                x_lo -= 0.5f / _cell_scale.x;
+                x_hi += 0.5f / _cell_scale.x;
+            }
+        }
+        const uint8_t col_first = cell_x(x_lo);
+        const uint8_t col_last = cell_x(x_hi);
+        for (uint8_t col = col_first; col <= col_last; col++) {
+            const uint16_t cell = row * _num_cells + col;
+            for (uint32_t k = _cell_start[cell]; k < _cell_start[cell+1]; k++) {
+                const Segment &seg = _segments[_cell_items[k]];
+                if ((seg.type & type_mask & ~found) && segment_crossed(seg, p1, p2)) {
+                    found |= seg.type;
+                    if (stop_at_first || (found & type_mask) == type_mask) {
+                        return found & type_mask;
+                    }
+                }
+            }
+        }
+    }
+
+    return found & type_mask;
+}
+
+#endif  // AP_OAPATHPLANNER_DIJKSTRA_ENABLED
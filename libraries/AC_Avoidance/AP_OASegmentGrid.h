@@ -0,0 +1,92 @@
+#pragma once
+
+#include "AC_Avoidance_config.h"
+
+#if AP_OAPATHPLANNER_DIJKSTRA_ENABLED
+
+#include <AP_Common/AP_Common.h>
+#include <AP_Math/AP_Math.h>
+
+/*
+ * Uniform grid of line segments (i.e. fence polygon edges) used to
+ * quickly find whether a line crosses any of them.  Each segment is
+ * stored in every cell its bounding box overlaps, and a query only
+ * checks the segments in the cells the line passes through.
+ *
+ * Usage is init(), then add_polygon() for each polygon, then build().
+ */
+class AP_OASegmentGrid {
+public:
+    AP_OASegmentGrid() {}
+    ~AP_OASegmentGrid() { clear(); }
+
+    CLASS_NO_COPY(AP_OASegmentGrid);  /* Do not allow copies */
+
+    // release all memory and mark the grid invalid
+    void clear();
+
+    // prepare to hold up to max_segments segments
+    // returns false on allocation failure
+    bool init(uint16_t max_segments) WARN_IF_UNUSED;
+
+    // add the edges of polygon V of N points.  type is a bitmask
+    // used to select segments in intersects()
+    // returns false if more than max_segments would be added
+    bool add_polygon(const Vector2f *V, uint16_t N, uint8_t type) WARN_IF_UNUSED;
+
+    // build the grid once all segments have been added
+    // returns false on allocation failure
+    bool build() WARN_IF_UNUSED;
+
+    // true once build() has succeeded
+    bool valid() const { return _cell_items != nullptr; }
+
+    // returns true if the line from p1 to p2 intersects any segment
+    // whose type is included in type_mask.  Gives the same result as
+    // Polygon_intersects() on the source polygons
+    bool intersects(const Vector2f &p1, const Vector2f &p2, uint8_t type_mask) const WARN_IF_UNUSED {
+        return find_intersections(p1, p2, type_mask, true) != 0;
+    }
+
+    // returns the bitmask of types (from type_mask) of segments
+    // intersected by the line from p1 to p2.  If stop_at_first is
+    // true the search ends at the first intersection found
+    uint8_t intersecting_types(const Vector2f &p1, const Vector2f &p2, uint8_t type_mask, bool stop_at_first = false) const WARN_IF_UNUSED {
+        return find_intersections(p1, p2, type_mask, stop_at_first);
+    }
+
+private:
+
+    struct Segment {
+        Vector2f start;
+        Vector2f end;
+        uint8_t type;
+    };
+
+    // cell coordinate of a position along each axis
+    uint8_t cell_x(float x) const;
+    uint8_t cell_y(float y) const;
+
+    // returns the total number of cell memberships of all segments.
+    // If cell_start and cell_items are supplied they are filled in
+    uint32_t populate_cells(uint32_t *cell_start, uint16_t *cell_items) const;
+
+    // implements intersects() and intersecting_types()
+    uint8_t find_intersections(const Vector2f &p1, const Vector2f &p2, uint8_t type_mask, bool stop_at_first) const;
+
+    // returns true if the line from p1 to p2 crosses segment seg
+    static bool segment_crossed(const Segment &seg, const Vector2f &p1, const Vector2f &p2);
+
+    Segment *_segments = nullptr;
+    uint16_t _max_segments;     // size of _segments array
+    uint16_t _num_segments;     // number of segments added
+
+    Vector2f _min;              // bounding box of all segments
+    Vector2f _max;
+    uint8_t _num_cells;         // number of cells along each axis
+    Vector2f _cell_scale;       // cells per cm along each axis
+    uint32_t *_cell_start = nullptr;    // _num_cells^2+1 offsets into _cell_items
+    uint16_t *_cell_items = nullptr;    // segment indexes in each cell
+};
+
+#endif  // AP_OAPATHPLANNER_DIJKSTRA_ENABLED
@@ -6,7 +6,8 @@
     LOG_OA_BENDYRULER_MSG, \
     LOG_OA_DIJKSTRA_MSG, \
     LOG_SIMPLE_AVOID_MSG, \
-    LOG_OD_VISGRAPH_MSG
+    LOG_OD_VISGRAPH_MSG, \
+    LOG_OA_DATABASE_MSG
 
 // @LoggerMessage: OABR
 // @Description: Object avoidance (Bendy Ruler) diagnostics
@@ -106,6 +107,26 @@ struct PACKED log_OD_Visgraph {
   int32_t Lon;
 };
 
+// @LoggerMessage: OADB
+// @Description: Object avoidance database statistics
+// @Field: TimeUS: Time since system startup
+// @Field: Cnt: Number of objects in the database
+// @Field: QLen: Number of objects waiting in the queue
+// @Field: Drop: Number of objects dropped since the last message because the queue was full
+// @Field: Proc: Number of objects taken from the queue since the last message
+// @Field: LatMax: Longest time from an object being detected to it being added to the database
+// @Field: PTMax: Longest time spent processing the queue
+struct PACKED log_OADatabase {
+  LOG_PACKET_HEADER;
+  uint64_t time_us;
+  uint16_t count;
+  uint16_t queue_len;
+  uint16_t drops;
+  uint32_t processed;
+  uint16_t latency_max_ms;
+  uint16_t process_time_max_us;
+};
+
 #define LOG_STRUCTURE_FROM_AVOIDANCE \
     { LOG_OA_BENDYRULER_MSG, sizeof(log_OABendyRuler), \
       "OABR","QBBHHHBfLLiLLi","TimeUS,Type,Act,DYaw,Yaw,DP,RChg,Mar,DLt,DLg,DAlt,OLt,OLg,OAlt", "s--ddd-mDUmDUm", "F-------GGBGGB" , true }, \
@@ -114,4 +135,6 @@ struct PACKED log_OD_Visgraph {
     { LOG_SIMPLE_AVOID_MSG, sizeof(log_SimpleAvoid), \
       "SA",  "QBffffffB","TimeUS,State,DVelX,DVelY,DVelZ,MVelX,MVelY,MVelZ,Back", "s-nnnnnn-", "F--------", true }, \
      { LOG_OD_VISGRAPH_MSG, sizeof(log_OD_Visgraph), \
-      "OAVG", "QBBLL", "TimeUS,version,point_num,Lat,Lon", "s--DU", "F--GG", true},
+      "OAVG", "QBBLL", "TimeUS,version,point_num,Lat,Lon", "s--DU", "F--GG", true}, \
+    { LOG_OA_DATABASE_MSG, sizeof(log_OADatabase), \
+      "OADB", "QHHHIHH", "TimeUS,Cnt,QLen,Drop,Proc,LatMax,PTMax", "s----ss", "F----CF", true},
@@ -0,0 +1,147 @@
+/*
+  time AP_OADijkstra rebuilding its fence visibility graph: a full
+  rebuild, and the rebuild after one exclusion polygon has moved.
+  The argument is the number of polygon points in the fence
+ */
+#include <AP_gbenchmark.h>
+
+#include <AC_Fence/AC_Fence.h>
+#include <AC_Avoidance/AP_OADijkstra.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if AP_OAPATHPLANNER_DIJKSTRA_ENABLED
+
+#define NUM_EXCLUSIONS 4
+#define EXCLUSION_POINTS 10
+
+// access to the fences loaded by AC_PolyFence_loader
+class AC_PolyFence_loader_Test
+{
+public:
+    // load a jagged 200m wide inclusion polygon with NUM_EXCLUSIONS 20m exclusion polygons inside it.
+    // the polygons have num_points points in total and exclusion polygon 0 is moved by offset (in cm)
+    static void load(AC_PolyFence_loader &loader, uint8_t num_points, const Vector2f &offset)
+    {
+        static AC_PolyFence_loader::InclusionBoundary inclusion;
+        static AC_PolyFence_loader::ExclusionBoundary exclusion[NUM_EXCLUSIONS];
+        static Vector2f points[UINT8_MAX];
+
+        inclusion.points = &points[0];
+        inclusion.count = num_points - NUM_EXCLUSIONS * EXCLUSION_POINTS;
+        make_polygon(Vector2f{}, 10000, inclusion.count, inclusion.points);
+        for (uint8_t e = 0; e < NUM_EXCLUSIONS; e++) {
+            const float angle = e * M_2PI / NUM_EXCLUSIONS;
+            Vector2f centre = Vector2f{cosf(angle), sinf(angle)} * 4000;
+            if (e == 0) {
+                centre += offset;
+            }
+            exclusion[e].points = &points[inclusion.count + e * EXCLUSION_POINTS];
+            exclusion[e].count = EXCLUSION_POINTS;
+            make_polygon(centre, 1000, EXCLUSION_POINTS, exclusion[e].points);
+        }
+
+        loader._loaded_inclusion_boundary = &inclusion;
+        loader._num_loaded_inclusion_boundaries = 1;
+        loader._loaded_exclusion_boundary = exclusion;
+        loader._num_loaded_exclusion_boundaries = NUM_EXCLUSIONS;
+        loader._load_attempted = true;
+        loader._load_time_ms++;
+    }
+
+private:
+    // a jagged polygon around centre
+    static void make_polygon(const Vector2f &centre, float radius, uint16_t n, Vector2f *V)
+    {
+        for (uint16_t i = 0; i < n; i++) {
+            const float angle = i * M_2PI / n;
+            V[i] = centre + Vector2f{cosf(angle), sinf(angle)} * (radius * ((i & 1) ? 0.8f : 1.0f));
+        }
+    }
+};
+
+// access to the fence visgraph of AP_OADijkstra
+class AP_OADijkstra_Test
+{
+public:
+    // rebuild the fence visgraph after the fence has changed, as AP_OADijkstra::update does
+    bool rebuild()
+    {
+        AP_OADijkstra::AP_OADijkstra_Error err_id = AP_OADijkstra::AP_OADijkstra_Error::DIJKSTRA_ERROR_NONE;
+        const float margin_cm = dijkstra._polyfence_margin * 100.0f;
+        dijkstra.create_inclusion_polygon_with_margin(margin_cm, err_id);
+        dijkstra.create_exclusion_polygon_with_margin(margin_cm, err_id);
+        dijkstra.create_exclusion_circle_with_margin(margin_cm, err_id);
+        return (err_id == AP_OADijkstra::AP_OADijkstra_Error::DIJKSTRA_ERROR_NONE) && dijkstra.create_fence_visgraph(err_id);
+    }
+
+    // forget the results kept from the last rebuild so the next rebuild checks every line against every fence
+    void forget_previous_visgraph()
+    {
+        delete[] dijkstra._fence_blockers;
+        dijkstra._fence_blockers = nullptr;
+    }
+
+    uint16_t num_points() const { return dijkstra.total_numpoints(); }
+    uint16_t num_edges() const { return dijkstra._fence_visgraph.num_items(); }
+
+private:
+    AP_Int16 options;
+    AP_OADijkstra dijkstra{options};
+};
+
+// created with new so they are zeroed as on the vehicle
+static AC_Fence &fence = *new AC_Fence();
+static AP_OADijkstra_Test &dijkstra_test = *new AP_OADijkstra_Test();
+
+/*
+  rebuild after exclusion polygon 0 has moved, moving it back and forth.
+  if forget is true the results kept from the previous rebuild are
+  discarded so every line is checked against every fence
+ */
+static void rebuild_after_move(benchmark::State& state, bool forget)
+{
+    const Vector2f offsets[2] { Vector2f{}, Vector2f{500, -300} };
+    AC_PolyFence_loader_Test::load(fence.polyfence(), state.range(0), offsets[0]);
+    dijkstra_test.forget_previous_visgraph();
+    if (!dijkstra_test.rebuild()) {
+        state.SkipWithError("rebuild failed");
+        return;
+    }
+
+    uint8_t n = 0;
+    while (state.KeepRunning()) {
+        n ^= 1;
+        AC_PolyFence_loader_Test::load(fence.polyfence(), state.range(0), offsets[n]);
+        if (forget) {
+            dijkstra_test.forget_previous_visgraph();
+        }
+        if (!dijkstra_test.rebuild()) {
+            state.SkipWithError("rebuild failed");
+            break;
+        }
+    }
+    state.counters["points"] = dijkstra_test.num_points();
+    state.counters["edges"] = dijkstra_test.num_edges();
+}
+
+// full rebuild, checking every line against every fence
+static void BM_VisgraphRebuildFull(benchmark::State& state)
+{
+    rebuild_after_move(state, true);
+}
+
+// rebuild reusing the previous results.  for fences of up to 100 points
+// lines between inclusion points are only rechecked against the exclusion
+// polygons, larger fences are fully rebuilt
+static void BM_VisgraphRebuildIncremental(benchmark::State& state)
+{
+    rebuild_after_move(state, false);
+}
+
+BENCHMARK(BM_VisgraphRebuildFull)->Arg(150)->Arg(250)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_VisgraphRebuildIncremental)->Arg(150)->Arg(250)->Unit(benchmark::kMillisecond);
+
+#endif  // AP_OAPATHPLANNER_DIJKSTRA_ENABLED
+
+BENCHMARK_MAIN();
@@ -0,0 +1,185 @@
+#include <AP_gtest.h>
+#include <AP_Common/AP_Common.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/tests/random_test.h>
+#include <AC_Avoidance/AP_OASegmentGrid.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if AP_OAPATHPLANNER_DIJKSTRA_ENABLED
+
+#define MAX_POLYGONS 6
+#define MAX_POLYGON_POINTS 60
+
+struct TestFence {
+    Vector2f points[MAX_POLYGONS][MAX_POLYGON_POINTS+1];
+    uint16_t num_points[MAX_POLYGONS];
+    uint8_t type[MAX_POLYGONS];
+    uint8_t num_polygons;
+};
+
+// an inclusion polygon with exclusion polygons scattered inside and
+// over its edges, in cm from the origin like the fence
+static void make_fence(TestRandom &rng, TestFence &fence)
+{
+    fence.num_polygons = 1 + rng.next() % MAX_POLYGONS;
+    for (uint8_t p = 0; p < fence.num_polygons; p++) {
+        const bool inclusion = (p == 0);
+        const uint16_t n = 3 + rng.next() % (MAX_POLYGON_POINTS - 3);
+        const bool shuffle = !inclusion && (rng.next() % 4 == 0);
+        const bool closed = (rng.next() % 2 == 0);
+        const Vector2f centre = inclusion ? Vector2f{} : Vector2f{rng.next_float(-15000, 15000),
+                                                                  rng.next_float(-15000, 15000)};
+        const float radius = inclusion ? rng.next_float(10000, 20000) : rng.next_float(200, 3000);
+        make_test_polygon(rng, centre, radius, 0.3f, n, shuffle, fence.points[p]);
+        if (closed) {
+            // the first point repeated at the end
+            fence.points[p][n] = fence.points[p][0];
+        }
+        fence.num_points[p] = closed ? n + 1 : n;
+        fence.type[p] = inclusion ? 1U : 2U;
+    }
+}
+
+static bool build_grid(const TestFence &fence, AP_OASegmentGrid &grid)
+{
+    uint16_t num_segments = 0;
+    for (uint8_t p = 0; p < fence.num_polygons; p++) {
+        num_segments += fence.num_points[p];
+    }
+    if (!grid.init(num_segments)) {
+        return false;
+    }
+    for (uint8_t p = 0; p < fence.num_polygons; p++) {
+        if (!grid.add_polygon(fence.points[p], fence.num_points[p], fence.type[p])) {
+            return false;
+        }
+    }
+    return grid.build();
+}
+
+// the types of the polygons crossed by the line, found by checking
+// every polygon with Polygon_intersects
+static uint8_t reference_types(const TestFence &fence, const Vector2f &p1, const Vector2f &p2)
+{
+    uint8_t found = 0;
+    for (uint8_t p = 0; p < fence.num_polygons; p++) {
+        Vector2f intersection;
+        if (Polygon_intersects(fence.points[p], fence.num_points[p], p1, p2, intersection)) {
+            found |= fence.type[p];
+        }
+    }
+    return found;
+}
+
+// a random line, with some lines between polygon points, along
+// the axes or of zero length as those are the likely places for
+// differences
+static void make_line(TestRandom &rng, const TestFence &fence, Vector2f &p1, Vector2f &p2)
+{
+    p1 = Vector2f{rng.next_float(-25000, 25000), rng.next_float(-25000, 25000)};
+    p2 = Vector2f{rng.next_float(-25000, 25000), rng.next_float(-25000, 25000)};
+    switch (rng.next() % 8) {
+    case 0: {
+        const uint8_t p = rng.next() % fence.num_polygons;
+        const uint8_t q = rng.next() % fence.num_polygons;
+        p1 = fence.points[p][rng.next() % fence.num_points[p]];
+        p2 = fence.points[q][rng.next() % fence.num_points[q]];
+        break;
+    }
+    case 1:
+        p2.x = p1.x;
+        break;
+    case 2:
+        p2.y = p1.y;
+        break;
+    case 3:
+        p2 = p1;
+        break;
+    case 4:
+        // short line near the fence
+        p2 = p1 + Vector2f{rng.next_float(-500, 500), rng.next_float(-500, 500)};
+        break;
+    default:
+        break;
+    }
+}
+
+TEST(AP_OASegmentGrid, matches_polygon_intersects)
+{
+    TestRandom rng{0x1234567};
+    for (uint16_t f = 0; f < 200; f++) {
+        TestFence fence {};
+        make_fence(rng, fence);
+        AP_OASegmentGrid grid;
+        ASSERT_TRUE(build_grid(fence, grid));
+        for (uint16_t i = 0; i < 500; i++) {
+            Vector2f p1, p2;
+            make_line(rng, fence, p1, p2);
+            const uint8_t expected = reference_types(fence, p1, p2);
+            EXPECT_EQ(expected, grid.intersecting_types(p1, p2, 0xFF));
+            // the line reversed
+            EXPECT_EQ(expected, grid.intersecting_types(p2, p1, 0xFF));
+            // each type on its own
+            EXPECT_EQ((expected & 1U) != 0, grid.intersects(p1, p2, 1U));
+            EXPECT_EQ((expected & 2U) != 0, grid.intersects(p1, p2, 2U));
+            // stopping early finds one of the types crossed
+            const uint8_t first = grid.intersecting_types(p1, p2, 0xFF, true);
+            EXPECT_EQ(expected != 0, first != 0);
+            EXPECT_EQ(0, first & ~expected);
+        }
+    }
+}
+
+TEST(AP_OASegmentGrid, closed_polygon)
+{
+    TestRandom rng{0x7654321};
+    Vector2f V[21];
+    make_test_polygon(rng, Vector2f{}, 10000, 0.3f, 20, false, V);
+    V[20] = V[0];
+
+    // a closed polygon gives the same grid as the open one
+    AP_OASegmentGrid open_grid;
+    AP_OASegmentGrid closed_grid;
+    ASSERT_TRUE(open_grid.init(20));
+    ASSERT_TRUE(open_grid.add_polygon(V, 20, 1));
+    ASSERT_TRUE(open_grid.build());
+    ASSERT_TRUE(closed_grid.init(20));
+    ASSERT_TRUE(closed_grid.add_polygon(V, 21, 1));
+    ASSERT_TRUE(closed_grid.build());
+
+    for (uint16_t i = 0; i < 2000; i++) {
+        const Vector2f p1 {rng.next_float(-12000, 12000), rng.next_float(-12000, 12000)};
+        const Vector2f p2 {rng.next_float(-12000, 12000), rng.next_float(-12000, 12000)};
+        Vector2f intersection;
+        const bool expected = Polygon_intersects(V, 21, p1, p2, intersection);
+        EXPECT_EQ(expected, open_grid.intersects(p1, p2, 1));
+        EXPECT_EQ(expected, closed_grid.intersects(p1, p2, 1));
+    }
+}
+
+TEST(AP_OASegmentGrid, empty_and_full)
+{
+    // an empty grid is valid and nothing intersects it
+    AP_OASegmentGrid grid;
+    EXPECT_FALSE(grid.valid());
+    ASSERT_TRUE(grid.init(4));
+    ASSERT_TRUE(grid.build());
+    EXPECT_TRUE(grid.valid());
+    EXPECT_FALSE(grid.intersects(Vector2f{-100, -100}, Vector2f{100, 100}, 0xFF));
+
+    // more segments than the grid was sized for are refused
+    const Vector2f square[] { {0, 0}, {0, 100}, {100, 100}, {100, 0} };
+    AP_OASegmentGrid small;
+    ASSERT_TRUE(small.init(3));
+    EXPECT_FALSE(small.add_polygon(square, ARRAY_SIZE(square), 1));
+
+    // clear() invalidates the grid
+    grid.clear();
+    EXPECT_FALSE(grid.valid());
+}
+
+#endif  // AP_OAPATHPLANNER_DIJKSTRA_ENABLED
+
+AP_GTEST_MAIN()
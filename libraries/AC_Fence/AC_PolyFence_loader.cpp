@@ -241,7 +241,7 @@ bool AC_PolyFence_loader::breached(const Location& loc) const
     // check we are inside each inclusion zone:
     for (uint8_t i=0; i<_num_loaded_inclusion_boundaries; i++) {
         const InclusionBoundary &boundary = _loaded_inclusion_boundary[i];
-        if (Polygon_outside(pos, boundary.points_lla, boundary.count)) {
+        if (boundary.index.outside(pos)) {
             num_inclusion_outside++;
         }
     }
@@ -249,7 +249,7 @@ bool AC_PolyFence_loader::breached(const Location& loc) const
     // check we are outside each exclusion zone:
     for (uint8_t i=0; i<_num_loaded_exclusion_boundaries; i++) {
         const ExclusionBoundary &boundary = _loaded_exclusion_boundary[i];
-        if (!Polygon_outside(pos, boundary.points_lla, boundary.count)) {
+        if (!boundary.index.outside(pos)) {
             return true;
         }
     }
@@ -735,6 +735,11 @@ bool AC_PolyFence_loader::load_from_eeprom()
                 storage_valid = false;
                 break;
             }
+            // build the spatial index used by breached().  If this
+            // fails breached() falls back to checking every edge
+            if (!boundary.index.init(boundary.points_lla, boundary.count)) {
+                Debug("Fence: failed to index polygon");
+            }
             _num_loaded_inclusion_boundaries++;
             break;
         }
@@ -754,6 +759,11 @@ bool AC_PolyFence_loader::load_from_eeprom()
                 storage_valid = false;
                 break;
             }
+            // build the spatial index used by breached().  If this
+            // fails breached() falls back to checking every edge
+            if (!boundary.index.init(boundary.points_lla, boundary.count)) {
+                Debug("Fence: failed to index polygon");
+            }
             _num_loaded_exclusion_boundaries++;
             break;
         }
@@ -29,7 +29,7 @@ class AC_PolyFenceItem {
 public:
     AC_PolyFenceType type;
     Vector2l loc;
-    uint8_t vertex_count;
+    uint8_t vertex_count;   // stored in one byte, so at most 255 per polygon
     float radius;
 };
 
@@ -42,6 +42,8 @@ public:
 class AC_PolyFence_loader
 {
 
+    friend class AC_PolyFence_loader_Test;
+
 public:
 
     AC_PolyFence_loader(AP_Int8 &total, const AP_Int16 &options) :
@@ -287,6 +289,7 @@ private:
         Vector2f *points; // pointer into the _loaded_offsets_from_origin array
         Vector2l *points_lla; // pointer into the _loaded_points_lla array
         uint8_t count; // count of points in the boundary
+        PolygonIndex<int32_t> index; // spatial index over points_lla
     };
     InclusionBoundary *_loaded_inclusion_boundary;
 
@@ -297,6 +300,7 @@ private:
         Vector2f *points; // pointer into the _loaded_offsets_from_origin array
         Vector2l *points_lla; // pointer into the _loaded_points_lla_lla array
         uint8_t count; // count of points in the boundary
+        PolygonIndex<int32_t> index; // spatial index over points_lla
     };
     ExclusionBoundary *_loaded_exclusion_boundary;
 
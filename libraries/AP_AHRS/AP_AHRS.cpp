@@ -39,6 +39,7 @@
 #include <GCS_MAVLink/GCS.h>
 #include <AP_InertialSensor/AP_InertialSensor.h>
 #include <AP_CustomRotations/AP_CustomRotations.h>
+#include <AP_Trace/AP_Trace.h>
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
 #include <SITL/SITL.h>
 #endif
@@ -361,6 +362,58 @@ void AP_AHRS::update_state(void)
     state.velocity_NED_ok = _get_velocity_NED(state.velocity_NED);
 }
 
+void AP_AHRS::publish_snapshot(void)
+{
+    const uint32_t seq = _snapshot_seq.load(std::memory_order_relaxed);
+    _snapshot_seq.store(seq + 1, std::memory_order_relaxed);
+    // order the odd sequence before the writes below
+    std::atomic_thread_fence(std::memory_order_release);
+
+    _snapshot.time_us = AP_HAL::micros64();
+    _snapshot.roll = roll;
+    _snapshot.pitch = pitch;
+    _snapshot.yaw = yaw;
+    _snapshot.quat = state.quat;
+    _snapshot.quat_ok = state.quat_ok;
+    _snapshot.gyro = state.gyro_estimate;
+    _snapshot.location = state.location;
+    _snapshot.location_ok = state.location_ok;
+    _snapshot.velocity_NED = state.velocity_NED;
+    _snapshot.velocity_NED_ok = state.velocity_NED_ok;
+    _snapshot.ground_speed_vec = state.ground_speed_vec;
+    _snapshot.ground_speed = state.ground_speed;
+    _snapshot.wind_estimate = state.wind_estimate;
+    _snapshot.wind_estimate_ok = state.wind_estimate_ok;
+    _snapshot.home = _home;
+    _snapshot.home_is_set = _home_is_set;
+
+    _snapshot_seq.store(seq + 2, std::memory_order_release);
+}
+
+bool AP_AHRS::get_snapshot(Snapshot &snap)
+{
+    for (uint8_t i = 0; i < 4; i++) {
+        const uint32_t seq = _snapshot_seq.load(std::memory_order_acquire);
+        if (seq & 1U) {
+            // being written
+            continue;
+        }
+        snap = _snapshot;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_snapshot_seq.load(std::memory_order_relaxed) == seq) {
+            snap.version = seq / 2;
+            return snap.version != 0;
+        }
+    }
+    // the writer may be a lower priority thread which can't finish
+    // while we spin, take the semaphore update() holds while
+    // publishing
+    WITH_SEMAPHORE(_rsem);
+    snap = _snapshot;
+    snap.version = _snapshot_seq.load(std::memory_order_relaxed) / 2;
+    return snap.version != 0;
+}
+
 void AP_AHRS::update(bool skip_ins_update)
 {
     // periodically checks to see if we should update the AHRS
@@ -481,6 +534,7 @@ void AP_AHRS::update(bool skip_ins_update)
 
     // update published state
     update_state();
+    publish_snapshot();
 
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
     /*
@@ -491,6 +545,8 @@ void AP_AHRS::update(bool skip_ins_update)
         hal.scheduler->delay_microseconds(random() % sitl->loop_time_jitter_us);
     }
 #endif
+
+    AP_TRACE(AHRS_UPDATE);
 }
 
 /*
@@ -25,6 +25,8 @@
 
 #include <AP_HAL/Semaphores.h>
 
+#include <atomic>
+
 #include "AP_AHRS_Backend.h"
 #include <AP_NavEKF2/AP_NavEKF2.h>
 #include <AP_NavEKF3/AP_NavEKF3.h>
@@ -76,6 +78,36 @@ public:
         return _rsem;
     }
 
+    /*
+      state published at the end of each update() for consumers in
+      other threads, which get a consistent copy from get_snapshot()
+      without taking the AHRS semaphore
+     */
+    struct Snapshot {
+        uint32_t version;           // number of updates published
+        uint64_t time_us;           // time of the update
+        float roll;                 // radians
+        float pitch;                // radians
+        float yaw;                  // radians
+        Quaternion quat;            // body to NED
+        bool quat_ok;
+        Vector3f gyro;              // rad/s, corrected for drift
+        Location location;
+        bool location_ok;
+        Vector3f velocity_NED;      // m/s
+        bool velocity_NED_ok;
+        Vector2f ground_speed_vec;  // m/s
+        float ground_speed;         // m/s
+        Vector3f wind_estimate;     // m/s
+        bool wind_estimate_ok;
+        Location home;
+        bool home_is_set;
+    };
+
+    // copy the state of the last update(). Returns false if there
+    // has not been one
+    bool get_snapshot(Snapshot &snap);
+
     // return the smoothed gyro vector corrected for drift
     const Vector3f &get_gyro(void) const { return state.gyro_estimate; }
 
@@ -704,6 +736,14 @@ private:
     // multi-thread access support
     HAL_Semaphore _rsem;
 
+    /*
+      seqlock over _snapshot: the sequence is odd while update() is
+      writing it, and a reader retries if it changed while copying
+     */
+    std::atomic<uint32_t> _snapshot_seq{0};
+    Snapshot _snapshot;
+    void publish_snapshot(void);
+
     /*
      * Parameters
      */
@@ -4,6 +4,8 @@
   STM32 boards
  */
 
+#pragma once
+
 class MultiHeap {
 public:
     /*
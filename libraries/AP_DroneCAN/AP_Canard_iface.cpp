@@ -10,6 +10,7 @@ extern const AP_HAL::HAL& hal;
 #define LOG_TAG "DroneCANIface"
 #include <canard.h>
 #include <AP_CANManager/AP_CANSensor.h>
+#include <AP_Common/ExpandingString.h>
 
 #define DEBUG_PKTS 0
 
@@ -74,6 +75,14 @@ bool CanardInterface::broadcast(const Canard::Transfer &bcast_transfer) {
     }
     WITH_SEMAPHORE(_sem_tx);
 
+    if (is_motor_command(bcast_transfer.data_type_id)) {
+        const int16_t ret = send_direct(bcast_transfer);
+        if (ret >= 0) {
+            return ret > 0;
+        }
+        // fall through to the queue
+    }
+
 #if AP_TEST_DRONECAN_DRIVERS
     if (this == &test_iface) {
         test_iface_sem.take_blocking();
@@ -107,10 +116,146 @@ bool CanardInterface::broadcast(const Canard::Transfer &bcast_transfer) {
         protocol_stats.tx_errors++;
     } else {
         protocol_stats.tx_frames += ret;
+#if AP_DRONECAN_MSG_STATS_ENABLED
+        update_tx_msg_stats(tx_transfer.transfer_type, tx_transfer.data_type_id);
+#endif
     }
     return ret > 0;
 }
 
+/*
+  send a motor command broadcast straight to the CAN interfaces. The
+  canard transmit queue is shared with every other message and is
+  only drained by processTx(), so going through it costs a list walk
+  and leaves the frames behind anything already queued. Here the
+  frames are built on the stack and handed to the HAL back to back.
+  Returns the number of frames sent, 0 if no bus got the whole
+  transfer, or -1 if the transfer has to go through the queue
+ */
+int16_t CanardInterface::send_direct(const Canard::Transfer &transfer)
+{
+    const uint8_t node_id = canard.node_id;
+    if (transfer.transfer_type != CanardTransferTypeBroadcast ||
+        node_id == CANARD_BROADCAST_NODE_ID) {
+        return -1;
+    }
+#if AP_TEST_DRONECAN_DRIVERS
+    if (this == &test_iface) {
+        return -1;
+    }
+#endif
+
+    const uint32_t can_id = (uint32_t(transfer.priority) << 24) |
+                            (uint32_t(transfer.data_type_id) << 8) |
+                            node_id | AP_HAL::CANFrame::FlagEFF;
+    const uint8_t transfer_id = *transfer.inout_transfer_id & 0x1F;
+    const uint8_t *payload = (const uint8_t *)transfer.payload;
+    const uint16_t len = transfer.payload_len;
+
+    // tail byte flags
+    const uint8_t SOT = 0x80;
+    const uint8_t EOT = 0x40;
+    const uint8_t TOGGLE = 0x20;
+
+    AP_HAL::CANFrame frames[direct_tx_max_frames];
+    uint8_t num_frames = 0;
+
+#if HAL_CANFD_SUPPORTED && CANARD_ENABLE_CANFD
+    if (transfer.canfd) {
+        if (len >= AP_HAL::CANFrame::MaxDataLen) {
+            return -1;
+        }
+        // pad to the next valid FD length, the tail goes last
+        const uint8_t frame_len = AP_HAL::CANFrame::dlcToDataLength(AP_HAL::CANFrame::dataLengthToDlc(len+1));
+        AP_HAL::CANFrame &f = frames[num_frames++];
+        f.id = can_id;
+        f.canfd = true;
+        memcpy(f.data, payload, len);
+        f.data[frame_len-1] = SOT | EOT | transfer_id;
+        f.dlc = AP_HAL::CANFrame::dataLengthToDlc(frame_len);
+    } else
+#endif
+    if (len < AP_HAL::CANFrame::NonFDCANMaxDataLen) {
+        AP_HAL::CANFrame &f = frames[num_frames++];
+        f.id = can_id;
+        memcpy(f.data, payload, len);
+        f.data[len] = SOT | EOT | transfer_id;
+        f.dlc = len + 1;
+    } else {
+        // multi-frame: the transfer CRC, seeded with the data type
+        // signature, goes little endian at the start of the first frame
+        const uint8_t per_frame = AP_HAL::CANFrame::NonFDCANMaxDataLen - 1;
+        if (len + 2U > uint32_t(per_frame) * direct_tx_max_frames) {
+            return -1;
+        }
+        uint8_t sig[8];
+        for (uint8_t i = 0; i < sizeof(sig); i++) {
+            sig[i] = uint8_t(transfer.data_type_signature >> (8*i));
+        }
+        uint16_t crc = crc16_ccitt(sig, sizeof(sig), 0xFFFF);
+        crc = crc16_ccitt(payload, len, crc);
+
+        uint16_t ofs = 0;
+        uint8_t toggle = 0;
+        while (ofs < len) {
+            AP_HAL::CANFrame &f = frames[num_frames];
+            f.id = can_id;
+            uint8_t n = 0;
+            if (num_frames == 0) {
+                f.data[n++] = uint8_t(crc & 0xFF);
+                f.data[n++] = uint8_t(crc >> 8);
+            }
+            const uint8_t chunk = MIN(uint16_t(per_frame - n), uint16_t(len - ofs));
+            memcpy(&f.data[n], &payload[ofs], chunk);
+            n += chunk;
+            ofs += chunk;
+            f.data[n++] = (num_frames == 0 ? SOT : 0) | (ofs == len ? EOT : 0) | toggle | transfer_id;
+            f.dlc = n;
+            toggle ^= TOGGLE;
+            num_frames++;
+        }
+    }
+
+    const uint64_t deadline = AP_HAL::micros64() + transfer.timeout_ms * 1000U;
+    int16_t sent = 0;
+    uint8_t complete = 0;
+    for (uint8_t i = 0; i < num_ifaces; i++) {
+        if (ifaces[i] == nullptr) {
+            continue;
+        }
+        uint8_t j = 0;
+        for (; j < num_frames; j++) {
+            if (ifaces[i]->send(frames[j], deadline, 0) <= 0) {
+                // the rest of the transfer is useless without this frame
+                break;
+            }
+        }
+        sent += j;
+        if (j == num_frames) {
+            complete++;
+        } else {
+            // this bus got none or only the start of the transfer
+            protocol_stats.tx_errors++;
+        }
+    }
+
+    if (sent > 0) {
+        protocol_stats.tx_frames += sent;
+        direct_tx_frames += sent;
+        // move on to the next transfer ID even if a bus only got part
+        // of the transfer. Receivers drop the incomplete transfer when
+        // the next start of transfer arrives with a different ID
+        *transfer.inout_transfer_id = (transfer_id + 1) & 0x1F;
+    }
+    if (complete == 0) {
+        return 0;
+    }
+#if AP_DRONECAN_MSG_STATS_ENABLED
+    update_tx_msg_stats(transfer.transfer_type, transfer.data_type_id);
+#endif
+    return sent;
+}
+
 bool CanardInterface::request(uint8_t destination_node_id, const Canard::Transfer &req_transfer) {
     if (!initialized) {
         return false;
@@ -139,6 +284,9 @@ bool CanardInterface::request(uint8_t destination_node_id, const Canard::Transfe
         protocol_stats.tx_errors++;
     } else {
         protocol_stats.tx_frames += ret;
+#if AP_DRONECAN_MSG_STATS_ENABLED
+        update_tx_msg_stats(tx_transfer.transfer_type, tx_transfer.data_type_id);
+#endif
     }
     return ret > 0;
 }
@@ -171,13 +319,22 @@ bool CanardInterface::respond(uint8_t destination_node_id, const Canard::Transfe
         protocol_stats.tx_errors++;
     } else {
         protocol_stats.tx_frames += ret;
+#if AP_DRONECAN_MSG_STATS_ENABLED
+        update_tx_msg_stats(tx_transfer.transfer_type, tx_transfer.data_type_id);
+#endif
     }
     return ret > 0;
 }
 
 void CanardInterface::onTransferReception(CanardInstance* ins, CanardRxTransfer* transfer) {
     CanardInterface* iface = (CanardInterface*) ins->user_reference;
+#if AP_DRONECAN_MSG_STATS_ENABLED
+    const uint32_t start_us = AP_HAL::micros();
+    iface->handle_message(*transfer);
+    iface->update_rx_msg_stats(*transfer, AP_HAL::micros() - start_us);
+#else
     iface->handle_message(*transfer);
+#endif
 }
 
 bool CanardInterface::shouldAcceptTransfer(const CanardInstance* ins,
@@ -186,8 +343,133 @@ bool CanardInterface::shouldAcceptTransfer(const CanardInstance* ins,
                                            CanardTransferType transfer_type,
                                            uint8_t source_node_id) {
     CanardInterface* iface = (CanardInterface*) ins->user_reference;
-    return iface->accept_message(data_type_id, *out_data_type_signature);
+    return iface->accept_transfer(data_type_id, transfer_type, *out_data_type_signature);
+}
+
+/*
+  find the rx_table entry for key, adding it if add is true. Returns
+  nullptr if not found or the table is full
+ */
+CanardInterface::rx_entry *CanardInterface::find_rx_entry(uint32_t key, bool add)
+{
+    uint8_t idx = (key * 2654435761U) >> 26;
+    for (uint8_t i=0; i<rx_table_size; i++) {
+        rx_entry &e = rx_table[idx];
+        if (e.key == key) {
+            return &e;
+        }
+        if (e.key == 0) {
+            if (!add) {
+                return nullptr;
+            }
+            e.key = key;
+            return &e;
+        }
+        idx = (idx + 1) % rx_table_size;
+    }
+    return nullptr;
+}
+
+bool CanardInterface::accept_transfer(uint16_t data_type_id, CanardTransferType transfer_type, uint64_t &signature)
+{
+    rx_entry *e = find_rx_entry(transfer_key(transfer_type, data_type_id), true);
+    if (e == nullptr) {
+        return accept_message(data_type_id, signature);
+    }
+    if (e->accepted) {
+        signature = e->signature;
+        return true;
+    }
+    const uint32_t now_ms = AP_HAL::millis();
+    if (e->checked_ms != 0 && now_ms - e->checked_ms < reject_recheck_ms) {
+        return false;
+    }
+    e->accepted = accept_message(data_type_id, e->signature);
+    // zero is taken to mean never checked
+    e->checked_ms = MAX(now_ms, 1U);
+    signature = e->signature;
+    return e->accepted;
+}
+
+#if AP_DRONECAN_MSG_STATS_ENABLED
+void CanardInterface::update_rx_msg_stats(const CanardRxTransfer &transfer, uint32_t handler_us)
+{
+    rx_entry *e = find_rx_entry(transfer_key(CanardTransferType(transfer.transfer_type), transfer.data_type_id), false);
+    if (e == nullptr) {
+        return;
+    }
+    e->transfers++;
+    e->handler_us += handler_us;
+}
+
+void CanardInterface::update_tx_msg_stats(CanardTransferType transfer_type, uint16_t data_type_id)
+{
+    const uint32_t key = transfer_key(transfer_type, data_type_id);
+    uint8_t idx = (key * 2654435761U) >> 27;
+    for (uint8_t i=0; i<tx_table_size; i++) {
+        tx_entry &e = tx_table[idx];
+        if (e.key == 0) {
+            e.key = key;
+        }
+        if (e.key == key) {
+            e.transfers++;
+            return;
+        }
+        idx = (idx + 1) % tx_table_size;
+    }
+}
+
+static char transfer_type_char(uint32_t key)
+{
+    switch (CanardTransferType((key >> 16) - 1)) {
+    case CanardTransferTypeBroadcast:
+        return 'B';
+    case CanardTransferTypeRequest:
+        return 'Q';
+    case CanardTransferTypeResponse:
+        return 'R';
+    }
+    return '?';
+}
+
+void CanardInterface::msg_stats_info(ExpandingString &str, uint8_t driver_index)
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    const float dt = MAX(now_ms - last_msg_stats_ms, 1U) * 0.001f;
+    last_msg_stats_ms = now_ms;
+    {
+        WITH_SEMAPHORE(_sem_rx);
+        for (auto &e : rx_table) {
+            if (e.transfers == 0) {
+                continue;
+            }
+            str.printf("%-3u RX  %c    %-5u %-8u %-8.1f %u\n",
+                       unsigned(driver_index),
+                       transfer_type_char(e.key),
+                       unsigned(e.key & 0xFFFF),
+                       unsigned(e.transfers),
+                       (double)((e.transfers - e.last_transfers) / dt),
+                       unsigned(e.handler_us / e.transfers));
+            e.last_transfers = e.transfers;
+        }
+    }
+    {
+        WITH_SEMAPHORE(_sem_tx);
+        for (auto &e : tx_table) {
+            if (e.key == 0) {
+                continue;
+            }
+            str.printf("%-3u TX  %c    %-5u %-8u %-8.1f -\n",
+                       unsigned(driver_index),
+                       transfer_type_char(e.key),
+                       unsigned(e.key & 0xFFFF),
+                       unsigned(e.transfers),
+                       (double)((e.transfers - e.last_transfers) / dt));
+            e.last_transfers = e.transfers;
+        }
+    }
 }
+#endif  // AP_DRONECAN_MSG_STATS_ENABLED
 
 #if AP_TEST_DRONECAN_DRIVERS
 void CanardInterface::processTestRx() {
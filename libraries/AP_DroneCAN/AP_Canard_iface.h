@@ -1,14 +1,21 @@
 #pragma once
 #include <AP_HAL/AP_HAL.h>
+
+#ifndef AP_DRONECAN_MSG_STATS_ENABLED
+#define AP_DRONECAN_MSG_STATS_ENABLED (HAL_ENABLE_DRONECAN_DRIVERS && HAL_MEM_CLASS >= HAL_MEM_CLASS_1000)
+#endif
+
 #if HAL_ENABLE_DRONECAN_DRIVERS
 #include <canard/interface.h>
 #include <dronecan_msgs.h>
 
 class AP_DroneCAN;
 class CANSensor;
+class ExpandingString;
 
 class CanardInterface : public Canard::Interface {
     friend class AP_DroneCAN;
+    friend class CanardInterface_Test;
 public:
 
     /// @brief delete copy constructor and assignment operator
@@ -37,6 +44,9 @@ public:
     bool respond(uint8_t destination_node_id, const Canard::Transfer &res_transfer) override;
 
     void processTx(bool raw_commands_only);
+
+    // frames sent by send_direct()
+    uint32_t get_direct_tx_frames() const { return direct_tx_frames; }
     void processRx();
 
     void process(uint32_t duration);
@@ -64,7 +74,67 @@ public:
     void update_rx_protocol_stats(int16_t res);
 
     uint8_t get_node_id() const override { return canard.node_id; }
+
+#if AP_DRONECAN_MSG_STATS_ENABLED
+    // print transfer counts, rates and handler time by data type
+    void msg_stats_info(ExpandingString &str, uint8_t driver_index);
+#endif
+
 private:
+    // accept_message() with its result cached in rx_table
+    bool accept_transfer(uint16_t data_type_id, CanardTransferType transfer_type, uint64_t &signature);
+
+    static uint32_t transfer_key(CanardTransferType transfer_type, uint16_t data_type_id) {
+        // never zero, which marks an unused entry
+        return (uint32_t(transfer_type) + 1U) << 16 | data_type_id;
+    }
+
+    /*
+      accept_message() searches the list of every subscriber, so its
+      result is kept here for each data type seen on the bus. A
+      subscriber may be added at any time, so a rejection is only
+      trusted for reject_recheck_ms. Open addressed by transfer_key(),
+      protected by _sem_rx
+     */
+    static const uint8_t rx_table_size = 64;
+    static const uint16_t reject_recheck_ms = 1000;
+    struct rx_entry {
+        uint32_t key;
+        bool accepted;
+        uint32_t checked_ms;
+        uint64_t signature;
+#if AP_DRONECAN_MSG_STATS_ENABLED
+        uint32_t transfers;
+        uint32_t handler_us;        // total time in handle_message()
+        uint32_t last_transfers;    // transfers at the last msg_stats_info()
+#endif
+    } rx_table[rx_table_size];
+    rx_entry *find_rx_entry(uint32_t key, bool add);
+
+    // motor commands skip the transmit queue, see send_direct()
+    static bool is_motor_command(uint16_t data_type_id) {
+        return data_type_id == UAVCAN_EQUIPMENT_ESC_RAWCOMMAND_ID ||
+               data_type_id == COM_HOBBYWING_ESC_RAWCOMMAND_ID;
+    }
+    int16_t send_direct(const Canard::Transfer &transfer);
+    static const uint8_t direct_tx_max_frames = 8;
+    uint32_t direct_tx_frames;
+
+#if AP_DRONECAN_MSG_STATS_ENABLED
+    void update_rx_msg_stats(const CanardRxTransfer &transfer, uint32_t handler_us);
+    void update_tx_msg_stats(CanardTransferType transfer_type, uint16_t data_type_id);
+
+    // transmitted transfers, protected by _sem_tx
+    static const uint8_t tx_table_size = 32;
+    struct tx_entry {
+        uint32_t key;
+        uint32_t transfers;
+        uint32_t last_transfers;
+    } tx_table[tx_table_size];
+
+    uint32_t last_msg_stats_ms;
+#endif
+
     CanardInstance canard;
     AP_HAL::CANIface* ifaces[HAL_NUM_CAN_IFACES];
 #if AP_TEST_DRONECAN_DRIVERS
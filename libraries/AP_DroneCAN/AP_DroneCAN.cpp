@@ -49,6 +49,7 @@
 #include <AP_Notify/AP_Notify.h>
 #include <AP_OpenDroneID/AP_OpenDroneID.h>
 #include <AP_Mount/AP_Mount_Xacti.h>
+#include <AP_Common/ExpandingString.h>
 #include <string.h>
 
 #if AP_DRONECAN_SERIAL_ENABLED
@@ -307,6 +308,21 @@ AP_DroneCAN *AP_DroneCAN::get_dronecan(uint8_t driver_index)
     return static_cast<AP_DroneCAN*>(AP::can().get_driver(driver_index));
 }
 
+#if AP_DRONECAN_MSG_STATS_ENABLED
+void AP_DroneCAN::msg_stats_info(ExpandingString &str)
+{
+    // a header to allow for machine parsers to determine format
+    str.printf("DCANV1\n");
+    str.printf("DRV DIR TYPE ID    COUNT    RATE     AVGUS\n");
+    for (uint8_t i=0; i<HAL_MAX_CAN_PROTOCOL_DRIVERS; i++) {
+        AP_DroneCAN *dronecan = get_dronecan(i);
+        if (dronecan != nullptr) {
+            dronecan->canard_iface.msg_stats_info(str, i);
+        }
+    }
+}
+#endif
+
 bool AP_DroneCAN::add_interface(AP_HAL::CANIface* can_iface)
 {
     if (!canard_iface.add_interface(can_iface)) {
@@ -852,13 +868,13 @@ void AP_DroneCAN::SRV_send_esc(void)
         }
         esc_msg.cmd.len = k;
 
+        const uint32_t direct_frames = canard_iface.get_direct_tx_frames();
         if (esc_raw.broadcast(esc_msg)) {
             _esc_send_count++;
         } else {
             _fail_send_count++;
         }
-        // immediately push data to CAN bus
-        canard_iface.processTx(true);
+        SRV_esc_sent(direct_frames);
     }
 
     for (uint8_t i = 0; i < DRONECAN_SRV_NUMBER; i++) {
@@ -905,21 +921,44 @@ void AP_DroneCAN::SRV_send_esc_hobbywing(void)
         }
         esc_msg.command.len = k;
 
+        const uint32_t direct_frames = canard_iface.get_direct_tx_frames();
         if (esc_hobbywing_raw.broadcast(esc_msg)) {
             _esc_send_count++;
         } else {
             _fail_send_count++;
         }
-        // immediately push data to CAN bus
-        canard_iface.processTx(true);
+        SRV_esc_sent(direct_frames);
     }
 }
 #endif // AP_DRONECAN_HOBBYWING_ESC_SUPPORT
 
+/*
+  called after an ESC command broadcast. The command normally goes
+  straight to the CAN interfaces (see CanardInterface::send_direct());
+  if it had to be queued instead then push it out now. Otherwise
+  record the time from SRV_push_servos() to the last frame being
+  handed to the interface
+ */
+void AP_DroneCAN::SRV_esc_sent(uint32_t direct_frames_before)
+{
+    const uint32_t frames = canard_iface.get_direct_tx_frames() - direct_frames_before;
+    if (frames == 0) {
+        canard_iface.processTx(true);
+        return;
+    }
+    const uint32_t latency_us = AP_HAL::micros() - _SRV_push_us;
+    _esc_latency.count++;
+    _esc_latency.frames += frames;
+    _esc_latency.sum_us += latency_us;
+    _esc_latency.max_us = MAX(_esc_latency.max_us, latency_us);
+}
+
 void AP_DroneCAN::SRV_push_servos()
 {
     WITH_SEMAPHORE(SRV_sem);
 
+    _SRV_push_us = AP_HAL::micros();
+
     for (uint8_t i = 0; i < DRONECAN_SRV_NUMBER; i++) {
         // Check if this channels has any function assigned
         if (SRV_Channels::channel_function(i) >= SRV_Channel::k_none) {
@@ -1886,6 +1925,36 @@ void AP_DroneCAN::logging(void)
                                 _esc_send_count,
                                 _srv_send_count,
                                 _fail_send_count);
+
+    // ESC command latency over the last second
+    decltype(_esc_latency) lat;
+    {
+        WITH_SEMAPHORE(SRV_sem);
+        lat = _esc_latency;
+        _esc_latency = {};
+    }
+    if (lat.count == 0) {
+        return;
+    }
+// @LoggerMessage: CANL
+// @Description: DroneCAN ESC command transmit latency
+// @Field: TimeUS: Time since system startup
+// @Field: I: driver instance
+// @Field: N: number of ESC commands sent
+// @Field: Fr: number of frames sent for those commands
+// @Field: LAvg: average time from output push to the last frame being handed to the CAN interface
+// @Field: LMax: maximum time from output push to the last frame being handed to the CAN interface
+    AP::logger().WriteStreaming("CANL",
+                                "TimeUS,I,N,Fr,LAvg,LMax",
+                                "s#--ss",
+                                "F---FF",
+                                "QBIIII",
+                                AP_HAL::micros64(),
+                                _driver_index,
+                                lat.count,
+                                lat.frames,
+                                lat.sum_us / lat.count,
+                                lat.max_us);
 #endif // HAL_LOGGING_ENABLED
 }
 
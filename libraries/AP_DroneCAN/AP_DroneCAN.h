@@ -86,6 +86,11 @@ public:
 
     // Return uavcan from @driver_index or nullptr if it's not ready or doesn't exist
     static AP_DroneCAN *get_dronecan(uint8_t driver_index);
+
+#if AP_DRONECAN_MSG_STATS_ENABLED
+    // per data type transfer statistics of all DroneCAN drivers
+    static void msg_stats_info(ExpandingString &str);
+#endif
     bool prearm_check(char* fail_msg, uint8_t fail_msg_len) const;
 
     void init(uint8_t driver_index, bool enable_filters) override;
@@ -182,6 +187,7 @@ private:
     ///// SRV output /////
     void SRV_send_actuator();
     void SRV_send_esc();
+    void SRV_esc_sent(uint32_t direct_frames_before);
 #if AP_DRONECAN_HIMARK_SERVO_SUPPORT
     void SRV_send_himark();
 #endif
@@ -257,8 +263,17 @@ private:
     uint32_t _SRV_armed_mask; // mask of servo outputs that are active
     uint32_t _ESC_armed_mask; // mask of ESC outputs that are active
     uint32_t _SRV_last_send_us;
+    uint32_t _SRV_push_us;      // time of the last SRV_push_servos()
     HAL_Semaphore SRV_sem;
 
+    // ESC command latency from SRV_push_servos(), reset when logged
+    struct {
+        uint32_t count;
+        uint32_t frames;
+        uint32_t sum_us;
+        uint32_t max_us;
+    } _esc_latency;
+
     // last log time
     uint32_t last_log_ms;
 
@@ -0,0 +1,226 @@
+#include <AP_gtest.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_DroneCAN/AP_Canard_iface.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if HAL_ENABLE_DRONECAN_DRIVERS
+
+#include <canard.h>
+
+// a CAN interface which records the frames sent to it and can be
+// made to refuse frames after a number have been sent
+class FrameRecorder : public AP_HAL::CANIface
+{
+public:
+    bool init(const uint32_t bitrate, const OperatingMode mode) override { return true; }
+    bool is_initialized() const override { return true; }
+    int8_t get_iface_num() const override { return 0; }
+    bool add_to_rx_queue(const CanRxItem &rx_item) override { return false; }
+
+    int16_t send(const AP_HAL::CANFrame &frame, uint64_t tx_deadline, CanIOFlags flags) override
+    {
+        if (num_frames >= accept_frames || num_frames >= ARRAY_SIZE(frames)) {
+            return 0;
+        }
+        frames[num_frames++] = frame;
+        return 1;
+    }
+
+    AP_HAL::CANFrame frames[16];
+    uint8_t num_frames;
+    uint8_t accept_frames = UINT8_MAX;
+};
+
+// access to the internals of CanardInterface
+class CanardInterface_Test
+{
+public:
+    CanardInterface_Test() :
+        iface(1)
+    {
+        iface.init(arena, sizeof(arena), node_id);
+    }
+
+    // add_interface() without the CAN manager logging
+    void add(AP_HAL::CANIface *can_iface)
+    {
+        iface.ifaces[iface.num_ifaces++] = can_iface;
+    }
+
+    int16_t send_direct(const Canard::Transfer &transfer) { return iface.send_direct(transfer); }
+    uint32_t tx_errors() const { return iface.protocol_stats.tx_errors; }
+    uint32_t tx_frames() const { return iface.protocol_stats.tx_frames; }
+
+    static const uint8_t node_id = 10;
+
+private:
+    uint8_t arena[1024];
+    CanardInterface iface;
+};
+
+static void on_reception(CanardInstance *ins, CanardRxTransfer *transfer) {}
+
+static bool should_accept(const CanardInstance *ins,
+                          uint64_t *out_data_type_signature,
+                          uint16_t data_type_id,
+                          CanardTransferType transfer_type,
+                          uint8_t source_node_id)
+{
+    return false;
+}
+
+static Canard::Transfer esc_transfer(uint8_t *transfer_id, const uint8_t *payload, uint16_t len, bool canfd)
+{
+    Canard::Transfer transfer {};
+    transfer.transfer_type = CanardTransferTypeBroadcast;
+    transfer.data_type_signature = UAVCAN_EQUIPMENT_ESC_RAWCOMMAND_SIGNATURE;
+    transfer.data_type_id = UAVCAN_EQUIPMENT_ESC_RAWCOMMAND_ID;
+    transfer.inout_transfer_id = transfer_id;
+    transfer.priority = CANARD_TRANSFER_PRIORITY_HIGH;
+    transfer.payload = payload;
+    transfer.payload_len = len;
+#if CANARD_ENABLE_CANFD
+    transfer.canfd = canfd;
+#endif
+    transfer.timeout_ms = 2;
+    return transfer;
+}
+
+/*
+  check send_direct() produces the same frames as libcanard for a
+  transfer: CAN ID, tail bytes with toggle and transfer ID, the
+  transfer CRC seeded with the data type signature and CAN FD padding
+ */
+static void check_against_canard(uint16_t len, bool canfd, uint8_t transfer_id)
+{
+    uint8_t payload[64];
+    for (uint16_t i = 0; i < len; i++) {
+        payload[i] = uint8_t(i * 37 + 11);
+    }
+
+    FrameRecorder bus;
+    CanardInterface_Test direct;
+    direct.add(&bus);
+    uint8_t direct_tid = transfer_id;
+    const int16_t sent = direct.send_direct(esc_transfer(&direct_tid, payload, len, canfd));
+
+    static uint8_t canard_arena[4096];
+    CanardInstance canard;
+    canardInit(&canard, canard_arena, sizeof(canard_arena), on_reception, should_accept, nullptr);
+    canardSetLocalNodeID(&canard, CanardInterface_Test::node_id);
+    uint8_t canard_tid = transfer_id;
+    const Canard::Transfer transfer = esc_transfer(&canard_tid, payload, len, canfd);
+    CanardTxTransfer tx_transfer;
+    canardInitTxTransfer(&tx_transfer);
+    tx_transfer.transfer_type = transfer.transfer_type;
+    tx_transfer.data_type_signature = transfer.data_type_signature;
+    tx_transfer.data_type_id = transfer.data_type_id;
+    tx_transfer.inout_transfer_id = transfer.inout_transfer_id;
+    tx_transfer.priority = transfer.priority;
+    tx_transfer.payload = payload;
+    tx_transfer.payload_len = len;
+#if CANARD_ENABLE_CANFD
+    tx_transfer.canfd = canfd;
+#endif
+#if CANARD_MULTI_IFACE
+    tx_transfer.iface_mask = 1;
+#endif
+    const int16_t expected = canardBroadcastObj(&canard, &tx_transfer);
+
+    ASSERT_GT(expected, 0);
+    ASSERT_EQ(sent, expected);
+    ASSERT_EQ(bus.num_frames, expected);
+    EXPECT_EQ(direct_tid, canard_tid);
+
+    for (uint8_t i = 0; i < bus.num_frames; i++) {
+        const CanardCANFrame *ref = canardPeekTxQueue(&canard);
+        ASSERT_NE(ref, nullptr);
+        const AP_HAL::CANFrame &f = bus.frames[i];
+        EXPECT_EQ(f.id, ref->id);
+        ASSERT_EQ(AP_HAL::CANFrame::dlcToDataLength(f.dlc), ref->data_len);
+        EXPECT_EQ(memcmp(f.data, ref->data, ref->data_len), 0) << "frame " << unsigned(i);
+#if CANARD_ENABLE_CANFD
+        EXPECT_EQ(f.canfd, ref->canfd);
+#endif
+        canardPopTxQueue(&canard);
+    }
+    EXPECT_EQ(canardPeekTxQueue(&canard), nullptr);
+}
+
+TEST(CanardDirect, SingleFrame)
+{
+    for (uint16_t len = 0; len < AP_HAL::CANFrame::NonFDCANMaxDataLen; len++) {
+        check_against_canard(len, false, 3);
+    }
+}
+
+TEST(CanardDirect, MultiFrame)
+{
+    // every length up to the limit of the stack frame buffer, so the
+    // CRC and final tail land in each position of the last frame
+    for (uint16_t len = AP_HAL::CANFrame::NonFDCANMaxDataLen; len <= 54; len++) {
+        check_against_canard(len, false, 7);
+    }
+}
+
+TEST(CanardDirect, TransferIdWraps)
+{
+    check_against_canard(4, false, 31);
+    check_against_canard(20, false, 31);
+}
+
+#if HAL_CANFD_SUPPORTED && CANARD_ENABLE_CANFD
+TEST(CanardDirect, CANFDPadding)
+{
+    for (uint16_t len = 0; len < AP_HAL::CANFrame::MaxDataLen; len++) {
+        check_against_canard(len, true, 5);
+    }
+}
+#endif
+
+#if HAL_NUM_CAN_IFACES > 1
+TEST(CanardDirect, FailureMidTransfer)
+{
+    uint8_t payload[20] {};
+    FrameRecorder good_bus;
+    FrameRecorder bad_bus;
+    bad_bus.accept_frames = 1;
+    CanardInterface_Test direct;
+    direct.add(&good_bus);
+    direct.add(&bad_bus);
+
+    // one bus gets the whole transfer, the other only the first frame
+    uint8_t tid = 0;
+    int16_t sent = direct.send_direct(esc_transfer(&tid, payload, sizeof(payload), false));
+    EXPECT_EQ(good_bus.num_frames, 3);
+    EXPECT_EQ(bad_bus.num_frames, 1);
+    EXPECT_EQ(sent, 4);
+    EXPECT_EQ(direct.tx_frames(), 4U);
+    EXPECT_EQ(direct.tx_errors(), 1U);
+    EXPECT_EQ(tid, 1);
+
+    // no bus gets the whole transfer, it is not counted as sent but
+    // the transfer ID still moves on past the partial transfer
+    good_bus.accept_frames = good_bus.num_frames + 2;
+    bad_bus.accept_frames = bad_bus.num_frames;
+    sent = direct.send_direct(esc_transfer(&tid, payload, sizeof(payload), false));
+    EXPECT_EQ(sent, 0);
+    EXPECT_EQ(good_bus.num_frames, 5);
+    EXPECT_EQ(direct.tx_frames(), 6U);
+    EXPECT_EQ(direct.tx_errors(), 3U);
+    EXPECT_EQ(tid, 2);
+
+    // nothing sent leaves the transfer ID alone
+    good_bus.accept_frames = good_bus.num_frames;
+    sent = direct.send_direct(esc_transfer(&tid, payload, sizeof(payload), false));
+    EXPECT_EQ(sent, 0);
+    EXPECT_EQ(direct.tx_errors(), 5U);
+    EXPECT_EQ(tid, 2);
+}
+#endif
+
+#endif // HAL_ENABLE_DRONECAN_DRIVERS
+
+AP_GTEST_MAIN()
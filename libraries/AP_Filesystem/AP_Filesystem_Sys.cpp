@@ -26,6 +26,10 @@
 #include <AP_CANManager/AP_CANManager.h>
 #include <AP_Scheduler/AP_Scheduler.h>
 #include <AP_Common/ExpandingString.h>
+#include <GCS_MAVLink/GCS.h>
+#include <AP_Scripting/AP_Scripting.h>
+#include <AP_DroneCAN/AP_DroneCAN.h>
+#include <AP_Trace/AP_Trace.h>
 
 extern const AP_HAL::HAL& hal;
 
@@ -40,6 +44,13 @@ static const SysFileList sysfs_file_list[] = {
     {"memory.txt"},
     {"uarts.txt"},
     {"timers.txt"},
+    {"buses.txt"},
+#if AP_MAVLINK_MSG_STATS_ENABLED
+    {"mavlink_msgs.txt"},
+#endif
+#if AP_SCRIPTING_ENABLED
+    {"scripts.txt"},
+#endif
 #if HAL_MAX_CAN_PROTOCOL_DRIVERS
     {"can_log.txt"},
 #endif
@@ -47,6 +58,12 @@ static const SysFileList sysfs_file_list[] = {
     {"can0_stats.txt"},
     {"can1_stats.txt"},
 #endif
+#if AP_DRONECAN_MSG_STATS_ENABLED
+    {"can_stats.txt"},
+#endif
+#if AP_TRACE_JSON_ENABLED
+    {"trace.json"},
+#endif
 #if !defined(HAL_BOOTLOADER_BUILD) && (defined(STM32F7) || defined(STM32H7))
     {"persistent.parm"},
 #endif
@@ -120,6 +137,22 @@ int AP_Filesystem_Sys::open(const char *fname, int flags, bool allow_absolute_pa
     if (strcmp(fname, "timers.txt") == 0) {
         hal.util->timer_info(*r.str);
     }
+    if (strcmp(fname, "buses.txt") == 0) {
+        hal.util->bus_info(*r.str);
+    }
+#if AP_MAVLINK_MSG_STATS_ENABLED
+    if (strcmp(fname, "mavlink_msgs.txt") == 0) {
+        gcs().message_stats_info(*r.str);
+    }
+#endif
+#if AP_SCRIPTING_ENABLED
+    if (strcmp(fname, "scripts.txt") == 0) {
+        AP_Scripting *scripting = AP::scripting();
+        if (scripting != nullptr) {
+            scripting->mem_info(*r.str);
+        }
+    }
+#endif
 #if HAL_CANMANAGER_ENABLED
     if (strcmp(fname, "can_log.txt") == 0) {
         AP::can().log_retrieve(*r.str);
@@ -137,6 +170,16 @@ int AP_Filesystem_Sys::open(const char *fname, int flags, bool allow_absolute_pa
             hal.can[can_stats_num]->get_stats(*r.str);
         }
     }
+#endif
+#if AP_DRONECAN_MSG_STATS_ENABLED
+    if (strcmp(fname, "can_stats.txt") == 0) {
+        AP_DroneCAN::msg_stats_info(*r.str);
+    }
+#endif
+#if AP_TRACE_JSON_ENABLED
+    if (strcmp(fname, "trace.json") == 0) {
+        AP::trace().trace_json(*r.str);
+    }
 #endif
     if (strcmp(fname, "persistent.parm") == 0) {
         hal.util->load_persistent_params(*r.str);
@@ -79,6 +79,12 @@ public:
 
     virtual bool     in_main_thread() const = 0;
 
+    /*
+      return a value identifying the calling thread, constant for the
+      life of the thread. Returns nullptr if not supported
+     */
+    virtual const void *current_thread() const { return nullptr; }
+
     /*
       disable interrupts and return a context that can be used to
       restore the interrupt state. This can be used to protect
@@ -197,6 +197,9 @@ public:
     // request information on timer frequencies
     virtual void timer_info(ExpandingString &str) {}
 
+    // request information on SPI and I2C bus usage
+    virtual void bus_info(ExpandingString &str) {}
+
     // generate Random values
     virtual bool get_random_vals(uint8_t* data, size_t size) { return false; }
 
@@ -0,0 +1,58 @@
+/*
+ * This file is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BusStats.h"
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Common/ExpandingString.h>
+
+#include "PollerThread.h"
+
+namespace Linux {
+
+void BusStats::info(ExpandingString &str, const char *type, uint16_t bus,
+                    const PollerThread &thread)
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    const uint32_t dt_ms = now_ms - last_info_ms;
+    last_info_ms = now_ms;
+
+    const uint32_t wakeups = thread.get_wakeups() - last_wakeups;
+    const uint32_t callbacks = thread.get_callbacks() - last_callbacks;
+    last_wakeups = thread.get_wakeups();
+    last_callbacks = thread.get_callbacks();
+
+    str.printf("%s%-2u %-6u %-8u %-4u %-5.1f %-5u %-5u %-5u %-5u %.2f\n",
+               type, unsigned(bus),
+               unsigned(ioctls),
+               unsigned(bytes),
+               unsigned(errors),
+               dt_ms > 0 ? busy_us * 0.1 / dt_ms : 0.0,
+               unsigned(ioctls > 0 ? busy_us / ioctls : 0),
+               unsigned(max_us),
+               unsigned(lock_waits > 0 ? lock_wait_us / lock_waits : 0),
+               unsigned(lock_wait_max_us),
+               wakeups > 0 ? double(callbacks) / wakeups : 0.0);
+
+    ioctls = 0;
+    bytes = 0;
+    errors = 0;
+    busy_us = 0;
+    max_us = 0;
+    lock_waits = 0;
+    lock_wait_us = 0;
+    lock_wait_max_us = 0;
+}
+
+}
@@ -0,0 +1,78 @@
+/*
+ * This file is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+class ExpandingString;
+
+namespace Linux {
+
+class PollerThread;
+
+/*
+ * Transfer and locking statistics of a SPI or I2C bus. Updated with
+ * the bus semaphore held, read without it by info()
+ */
+class BusStats {
+public:
+    /* One ioctl moving @bytes bytes that took @us microseconds */
+    void transfer(uint32_t bytes, uint32_t us, bool ok)
+    {
+        ioctls++;
+        this->bytes += bytes;
+        busy_us += us;
+        if (us > max_us) {
+            max_us = us;
+        }
+        if (!ok) {
+            errors++;
+        }
+    }
+
+    /* The bus thread waited @us microseconds for the bus semaphore */
+    void lock_wait(uint32_t us)
+    {
+        lock_waits++;
+        lock_wait_us += us;
+        if (us > lock_wait_max_us) {
+            lock_wait_max_us = us;
+        }
+    }
+
+    /*
+     * Print one line of statistics since the last call. Busy is the
+     * percentage of time spent in transfers, Lat the average and max
+     * ioctl time and Wait the average and max time the bus thread
+     * waited for the bus
+     */
+    void info(ExpandingString &str, const char *type, uint16_t bus,
+              const PollerThread &thread);
+
+private:
+    uint32_t ioctls;
+    uint32_t bytes;
+    uint32_t errors;
+    uint32_t busy_us;
+    uint32_t max_us;
+    uint32_t lock_waits;
+    uint32_t lock_wait_us;
+    uint32_t lock_wait_max_us;
+    uint32_t last_info_ms;
+    uint32_t last_wakeups;
+    uint32_t last_callbacks;
+};
+
+}
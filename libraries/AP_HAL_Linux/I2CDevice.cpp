@@ -44,7 +44,9 @@
 
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
+#include <AP_Common/ExpandingString.h>
 
+#include "BusStats.h"
 #include "PollerThread.h"
 #include "Scheduler.h"
 #include "Semaphores.h"
@@ -91,6 +93,7 @@ public:
 
     PollerThread thread;
     Semaphore sem;
+    BusStats stats;
     int fd = -1;
     uint8_t bus;
     uint8_t ref;
@@ -105,7 +108,9 @@ I2CBus::~I2CBus()
 
 void I2CBus::start_cb()
 {
+    const uint32_t start_us = AP_HAL::micros();
     sem.take_blocking();
+    stats.lock_wait(AP_HAL::micros() - start_us);
 }
 
 void I2CBus::end_cb()
@@ -190,9 +195,11 @@ bool I2CDevice::transfer(const uint8_t *send, uint32_t send_len,
 
     int r;
     unsigned retries = _retries;
+    const uint32_t start_us = AP_HAL::micros();
     do {
         r = ::ioctl(_bus.fd, I2C_RDWR, &i2c_data);
     } while (r == -1 && retries-- > 0);
+    _bus.stats.transfer(send_len + recv_len, AP_HAL::micros() - start_us, r != -1);
 
     return r != -1;
 }
@@ -229,9 +236,11 @@ bool I2CDevice::read_registers_multiple(uint8_t first_reg, uint8_t *recv,
 
         int r;
         unsigned retries = _retries;
+        const uint32_t start_us = AP_HAL::micros();
         do {
             r = ::ioctl(_bus.fd, I2C_RDWR, &i2c_data);
         } while (r == -1 && retries-- > 0);
+        _bus.stats.transfer(n * (1 + recv_len), AP_HAL::micros() - start_us, r != -1);
 
         if (r == -1) {
             return false;
@@ -339,6 +348,13 @@ void I2CDeviceManager::_unregister(I2CBus &b)
     }
 }
 
+void I2CDeviceManager::bus_info(ExpandingString &str)
+{
+    for (auto it = _buses.begin(); it != _buses.end(); it++) {
+        (*it)->stats.info(str, "I2C", (*it)->bus, (*it)->thread);
+    }
+}
+
 void I2CDeviceManager::teardown()
 {
     for (auto it = _buses.begin(); it != _buses.end(); it++) {
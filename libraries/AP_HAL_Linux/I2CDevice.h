@@ -107,6 +107,9 @@ public:
      */
     void teardown();
 
+    /* Print transfer statistics of each bus since the last call */
+    void bus_info(ExpandingString &str);
+
     /*
       get mask of bus numbers for all configured I2C buses
      */
@@ -37,15 +37,10 @@ void TimerPollable::on_can_read()
         return;
     }
 
-    if (_wrapper) {
-        _wrapper->start_cb();
-    }
+    _thread._hold_wrapper(_wrapper);
+    _thread._callbacks++;
 
     _cb();
-
-    if (_wrapper) {
-        _wrapper->end_cb();
-    }
 }
 
 bool TimerPollable::setup_timer(uint32_t timeout_usec)
@@ -68,18 +63,35 @@ bool TimerPollable::setup_timer(uint32_t timeout_usec)
     return true;
 }
 
+static struct timespec usec_to_timespec(uint64_t usec)
+{
+    struct timespec ts;
+    ts.tv_sec = usec / AP_USEC_PER_SEC;
+    ts.tv_nsec = (usec % AP_USEC_PER_SEC) * AP_NSEC_PER_USEC;
+    return ts;
+}
+
 bool TimerPollable::adjust_timer(uint32_t timeout_usec)
 {
-    if (_fd < 0) {
+    if (_fd < 0 || timeout_usec == 0) {
         return false;
     }
 
+    /*
+     * Start on the next multiple of the period so that timers with the
+     * same or harmonic periods expire in the same wakeup
+     */
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const uint64_t now_usec = uint64_t(now.tv_sec) * AP_USEC_PER_SEC + now.tv_nsec / AP_NSEC_PER_USEC;
+    const uint64_t start_usec = (now_usec / timeout_usec + 1) * timeout_usec;
+
     struct itimerspec spec = { };
 
-    spec.it_interval.tv_nsec = timeout_usec * AP_NSEC_PER_USEC;
-    spec.it_value.tv_nsec = timeout_usec * AP_NSEC_PER_USEC;
+    spec.it_interval = usec_to_timespec(timeout_usec);
+    spec.it_value = usec_to_timespec(start_usec);
 
-    if (timerfd_settime(_fd, 0, &spec, nullptr) < 0) {
+    if (timerfd_settime(_fd, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) {
         return false;
     }
 
@@ -93,7 +105,7 @@ TimerPollable *PollerThread::add_timer(TimerPollable::PeriodicCb cb,
     if (!_poller) {
         return nullptr;
     }
-    TimerPollable *p = NEW_NOTHROW TimerPollable(cb, wrapper);
+    TimerPollable *p = NEW_NOTHROW TimerPollable(*this, cb, wrapper);
     if (!p || !p->setup_timer(timeout_usec) ||
         !_poller.register_pollable(p, POLLIN)) {
         delete p;
@@ -140,6 +152,8 @@ void PollerThread::mainloop()
 
     while (!_should_exit) {
         _poller.poll();
+        _release_wrapper();
+        _wakeups++;
         _cleanup_timers();
     }
 
@@ -147,6 +161,26 @@ void PollerThread::mainloop()
     _should_exit = false;
 }
 
+void PollerThread::_hold_wrapper(TimerPollable::WrapperCb *wrapper)
+{
+    if (wrapper == _held_wrapper) {
+        return;
+    }
+    _release_wrapper();
+    if (wrapper) {
+        wrapper->start_cb();
+    }
+    _held_wrapper = wrapper;
+}
+
+void PollerThread::_release_wrapper()
+{
+    if (_held_wrapper) {
+        _held_wrapper->end_cb();
+        _held_wrapper = nullptr;
+    }
+}
+
 bool PollerThread::stop()
 {
     if (!is_started()) {
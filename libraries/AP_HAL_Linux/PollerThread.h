@@ -26,6 +26,8 @@
 
 namespace Linux {
 
+class PollerThread;
+
 class TimerPollable : public Pollable {
     friend class PollerThread;
 
@@ -48,12 +50,14 @@ public:
     bool adjust_timer(uint32_t timeout_usec);
 
 protected:
-    TimerPollable(PeriodicCb cb, WrapperCb *wrapper)
-        : _cb(cb)
+    TimerPollable(PollerThread &thread, PeriodicCb cb, WrapperCb *wrapper)
+        : _thread(thread)
+        , _cb(cb)
         , _wrapper(wrapper)
     {
     }
 
+    PollerThread &_thread;
     PeriodicCb _cb;
     WrapperCb *_wrapper;
     bool _removeme = false;
@@ -74,11 +78,29 @@ public:
 
     bool stop() override;
 
+    /* Number of wakeups and of callbacks run since the thread started */
+    uint32_t get_wakeups() const { return _wakeups; }
+    uint32_t get_callbacks() const { return _callbacks; }
+
 protected:
+    friend class TimerPollable;
+
     void _cleanup_timers();
 
+    /*
+     * Timers are aligned on multiples of their period, so callbacks of
+     * one bus with related periods expire together. The wrapper (the
+     * bus semaphore) is then taken once for all the callbacks run in
+     * one wakeup and released by _release_wrapper() afterwards
+     */
+    void _hold_wrapper(TimerPollable::WrapperCb *wrapper);
+    void _release_wrapper();
+
     Poller _poller{};
     std::vector<TimerPollable*> _timers{};
+    TimerPollable::WrapperCb *_held_wrapper = nullptr;
+    uint32_t _wakeups = 0;
+    uint32_t _callbacks = 0;
 };
 
 }
@@ -29,7 +29,9 @@
 
 #include <AP_HAL/AP_HAL.h>
 #include <AP_HAL/utility/OwnPtr.h>
+#include <AP_Common/ExpandingString.h>
 
+#include "BusStats.h"
 #include "GPIO.h"
 #include "PollerThread.h"
 #include "Scheduler.h"
@@ -189,6 +191,7 @@ public:
 
     PollerThread thread;
     Semaphore sem;
+    BusStats stats;
     int fd[MAX_SUBDEVS];
     uint16_t bus;
     int16_t last_mode = -1;
@@ -210,7 +213,9 @@ SPIBus::~SPIBus()
 
 void SPIBus::start_cb()
 {
+    const uint32_t start_us = AP_HAL::micros();
     sem.take_blocking();
+    stats.lock_wait(AP_HAL::micros() - start_us);
 }
 
 void SPIBus::end_cb()
@@ -344,9 +349,11 @@ bool SPIDevice::transfer(const uint8_t *send, uint32_t send_len,
         _bus.last_mode = _desc.mode;
     }
 
+    const uint32_t start_us = AP_HAL::micros();
     _cs_assert();
     r = ioctl(fd, SPI_IOC_MESSAGE(nmsgs), &msgs);
     _cs_release();
+    _bus.stats.transfer(send_len + recv_len, AP_HAL::micros() - start_us, r != -1);
 
     if (r == -1) {
         hal.console->printf("SPIDevice: error transferring data fd=%d (%s)\n",
@@ -375,16 +382,22 @@ bool SPIDevice::transfer_fullduplex(const uint8_t *send, uint8_t *recv,
     msgs[0].bits_per_word = _desc.bits_per_word;
     msgs[0].cs_change = 0;
 
-    int r = ioctl(fd, SPI_IOC_WR_MODE, &_desc.mode);
-    if (r < 0) {
-        hal.console->printf("SPIDevice: error on setting mode fd=%d (%s)\n",
-                            fd, strerror(errno));
-        return false;
+    int r;
+    if (_desc.mode != _bus.last_mode) {
+        r = ioctl(fd, SPI_IOC_WR_MODE, &_desc.mode);
+        if (r < 0) {
+            hal.console->printf("SPIDevice: error on setting mode fd=%d (%s)\n",
+                                fd, strerror(errno));
+            return false;
+        }
+        _bus.last_mode = _desc.mode;
     }
 
+    const uint32_t start_us = AP_HAL::micros();
     _cs_assert();
     r = ioctl(fd, SPI_IOC_MESSAGE(1), &msgs);
     _cs_release();
+    _bus.stats.transfer(len, AP_HAL::micros() - start_us, r != -1);
 
     if (r == -1) {
         hal.console->printf("SPIDevice: error transferring data fd=%d (%s)\n",
@@ -528,6 +541,13 @@ void SPIDeviceManager::_unregister(SPIBus &b)
     }
 }
 
+void SPIDeviceManager::bus_info(ExpandingString &str)
+{
+    for (auto it = _buses.begin(); it != _buses.end(); it++) {
+        (*it)->stats.info(str, "SPI", (*it)->bus, (*it)->thread);
+    }
+}
+
 void SPIDeviceManager::teardown()
 {
     for (auto it = _buses.begin(); it != _buses.end(); it++) {
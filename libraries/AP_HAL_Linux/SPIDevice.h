@@ -105,6 +105,9 @@ public:
     /* See AP_HAL::SPIDeviceManager::get_device_name() */
     const char *get_device_name(uint8_t idx) override;
 
+    /* Print transfer statistics of each bus since the last call */
+    void bus_info(ExpandingString &str);
+
 protected:
     void _unregister(SPIBus &b);
     AP_HAL::OwnPtr<AP_HAL::SPIDevice> _create_device(SPIBus &b, SPIDesc &device_desc) const;
@@ -18,6 +18,9 @@ public:
 protected:
     int _write_fd(const uint8_t *buf, uint16_t n) override;
     int _read_fd(uint8_t *buf, uint16_t n) override;
+    int _read_poll_fd() const override {
+        return _external ? UARTDriver::_read_poll_fd() : -1;
+    }
 
     AP_HAL::OwnPtr<AP_HAL::SPIDevice> _dev;
 
@@ -279,6 +279,7 @@ void Scheduler::_run_io(void)
 void Scheduler::_run_uarts()
 {
     // process any pending serial bytes
+    UARTDriver::poll_read_ready();
     for (uint8_t i=0;i<hal.num_serial; i++) {
         hal.serial(i)->_timer_tick();
     }
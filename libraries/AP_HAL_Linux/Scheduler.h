@@ -33,6 +33,7 @@ public:
     void     register_io_process(AP_HAL::MemberProc) override;
 
     bool     in_main_thread() const override;
+    const void *current_thread() const override { return (const void *)pthread_self(); }
 
     void     register_timer_failsafe(AP_HAL::Proc, uint32_t period_us) override;
 
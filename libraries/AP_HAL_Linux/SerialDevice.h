@@ -23,4 +23,11 @@ public:
 
     /* Depends on lower level to implement, most devices are fine with defaults */
     virtual void set_parity(int v) { }
+
+    /*
+     * File descriptor which becomes readable when data arrives, or -1 if
+     * the device has to be read to find out. See
+     * Linux::UARTDriver::poll_read_ready()
+     */
+    virtual int get_read_fd() const { return -1; }
 };
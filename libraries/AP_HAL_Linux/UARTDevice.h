@@ -21,6 +21,8 @@ public:
     }
     virtual void set_parity(int v) override;
 
+    virtual int get_read_fd() const override { return _fd; }
+
 private:
     void _disable_crlf();
     AP_HAL::UARTDriver::flow_control _flow_control = AP_HAL::UARTDriver::flow_control::FLOW_CONTROL_DISABLE;
@@ -18,6 +18,7 @@
 #include <unistd.h>
 
 #include <AP_HAL/AP_HAL.h>
+#include <AP_Common/ExpandingString.h>
 
 #include "ConsoleDevice.h"
 #include "TCPServerDevice.h"
@@ -32,6 +33,10 @@ extern const AP_HAL::HAL& hal;
 
 using namespace Linux;
 
+#if HAL_UART_STATS_ENABLED
+uint32_t UARTDriver::_poll_calls;
+#endif
+
 UARTDriver::UARTDriver(bool default_console) :
     _device{new ConsoleDevice()}
 {
@@ -314,7 +319,16 @@ int UARTDriver::_write_fd(const uint8_t *buf, uint16_t n)
         return 0;
     }
 
-    return _device->write(buf, n);
+#if HAL_UART_STATS_ENABLED
+    _io_calls++;
+#endif
+    const int ret = _device->write(buf, n);
+#if HAL_UART_STATS_ENABLED
+    if (ret > 0) {
+        _tx_stats_bytes += ret;
+    }
+#endif
+    return ret;
 }
 
 /*
@@ -322,7 +336,72 @@ int UARTDriver::_write_fd(const uint8_t *buf, uint16_t n)
  */
 int UARTDriver::_read_fd(uint8_t *buf, uint16_t n)
 {
-    return _device->read(buf, n);
+#if HAL_UART_STATS_ENABLED
+    _io_calls++;
+#endif
+    const int ret = _device->read(buf, n);
+#if HAL_UART_STATS_ENABLED
+    if (ret > 0) {
+        _rx_stats_bytes += ret;
+    }
+#endif
+    return ret;
+}
+
+int UARTDriver::_read_poll_fd() const
+{
+    return _device->get_read_fd();
+}
+
+/*
+  an idle port used to cost a read() on every tick, and two syscalls
+  for UDP ports as the socket is polled before recv(). One poll() over
+  all the ports replaces them
+ */
+void UARTDriver::poll_read_ready(void)
+{
+    struct pollfd fds[AP_HAL::HAL::num_serial];
+    UARTDriver *drivers[AP_HAL::HAL::num_serial];
+    nfds_t nfds = 0;
+
+    for (uint8_t i = 0; i < hal.num_serial; i++) {
+        UARTDriver *uart = UARTDriver::from(hal.serial(i));
+        if (uart == nullptr || !uart->_initialised) {
+            continue;
+        }
+        const int fd = uart->_read_poll_fd();
+        if (fd < 0) {
+            uart->_read_ready = true;
+            continue;
+        }
+        uart->_read_ready = false;
+        fds[nfds].fd = fd;
+        fds[nfds].events = POLLIN;
+        fds[nfds].revents = 0;
+        drivers[nfds] = uart;
+        nfds++;
+    }
+
+    if (nfds == 0) {
+        return;
+    }
+
+#if HAL_UART_STATS_ENABLED
+    _poll_calls++;
+#endif
+    if (::poll(fds, nfds, 0) < 0) {
+        // fall back to reading every port
+        for (nfds_t i = 0; i < nfds; i++) {
+            drivers[i]->_read_ready = true;
+        }
+        return;
+    }
+    for (nfds_t i = 0; i < nfds; i++) {
+        // errors and hangups are left for read() to report
+        if (fds[i].revents != 0) {
+            drivers[i]->_read_ready = true;
+        }
+    }
 }
 
 
@@ -390,8 +469,15 @@ void UARTDriver::_timer_tick(void)
         num_send--;
     }
 
+    if (!_read_ready) {
+        // nothing waiting, see poll_read_ready()
+        _in_timer = false;
+        return;
+    }
+
     // try to fill the read buffer
     int ret;
+    bool received = false;
     ByteBuffer::IoVec vec[2];
 
     const auto n_vec = _readbuf.reserve(vec, _readbuf.space());
@@ -401,6 +487,9 @@ void UARTDriver::_timer_tick(void)
             break;
         }
         _readbuf.commit((unsigned)ret);
+        if (ret > 0) {
+            received = true;
+        }
 
         // update receive timestamp
         _receive_timestamp[_receive_timestamp_idx^1] = AP_HAL::micros64();
@@ -412,9 +501,30 @@ void UARTDriver::_timer_tick(void)
         }
     }
 
+    if (received) {
+        _data_ready.signal();
+    }
+
     _in_timer = false;
 }
 
+/*
+  wait for data to arrive, or a timeout. Return true if data has
+  arrived, false on timeout
+ */
+bool UARTDriver::wait_timeout(uint16_t n, uint32_t timeout_ms)
+{
+    const uint32_t t0 = AP_HAL::millis();
+    while (available() < n) {
+        const uint32_t now = AP_HAL::millis();
+        if (now - t0 >= timeout_ms) {
+            break;
+        }
+        _data_ready.wait((timeout_ms - (now - t0)) * 1000U);
+    }
+    return available() >= n;
+}
+
 void UARTDriver::configure_parity(uint8_t v) {
     UARTDriver::parity = v;
     _device->set_parity(v);
@@ -450,3 +560,22 @@ uint32_t UARTDriver::bw_in_bytes_per_second() const
     const uint32_t bitrate = (_connected && _ip != nullptr) ? 10E6 : _baudrate;
     return bitrate/10; // convert bits to bytes minus overhead
 }
+
+#if HAL_UART_STATS_ENABLED
+// request information on uart I/O for @SYS/uarts.txt for this uart
+void UARTDriver::uart_info(ExpandingString &str, StatsTracker &stats, const uint32_t dt_ms)
+{
+    const uint32_t tx_bytes = stats.tx.update(_tx_stats_bytes);
+    const uint32_t rx_bytes = stats.rx.update(_rx_stats_bytes);
+    const uint32_t io_calls = _io_calls - _last_info_io_calls;
+    _last_info_io_calls = _io_calls;
+
+    str.printf("TX=%8u RX=%8u TXBD=%6u RXBD=%6u IO/s=%5u %s\n",
+               unsigned(tx_bytes),
+               unsigned(rx_bytes),
+               unsigned((tx_bytes * 10000) / dt_ms),
+               unsigned((rx_bytes * 10000) / dt_ms),
+               unsigned((io_calls * 1000) / dt_ms),
+               device_path != nullptr ? device_path : "");
+}
+#endif
@@ -27,6 +27,15 @@ public:
     bool _write_pending_bytes(void);
     virtual void _timer_tick(void) override;
 
+    bool wait_timeout(uint16_t n, uint32_t timeout_ms) override;
+
+    /*
+     * Find the ports with data waiting using one poll() for all of
+     * them, so that _timer_tick() only reads those. Ports without a
+     * file descriptor to poll are read on every tick as before
+     */
+    static void poll_read_ready(void);
+
     virtual enum flow_control get_flow_control(void) override
     {
         return _device->get_flow_control();
@@ -58,6 +67,18 @@ public:
 
     virtual uint32_t get_baud_rate() const override { return _baudrate; }
 
+#if HAL_UART_STATS_ENABLED
+    // Getters for cumulative tx and rx counts
+    uint32_t get_total_tx_bytes() const override { return _tx_stats_bytes; }
+    uint32_t get_total_rx_bytes() const override { return _rx_stats_bytes; }
+
+    // request information on uart I/O for @SYS/uarts.txt for this uart
+    void uart_info(ExpandingString &str, StatsTracker &stats, const uint32_t dt_ms) override;
+
+    // number of poll() calls made by poll_read_ready()
+    static uint32_t get_poll_calls() { return _poll_calls; }
+#endif
+
 private:
     AP_HAL::OwnPtr<SerialDevice> _device;
     bool _console;
@@ -78,6 +99,18 @@ private:
     uint64_t _receive_timestamp[2];
     uint8_t _receive_timestamp_idx;
 
+    // set by poll_read_ready() when the port has data or can't be polled
+    bool _read_ready = true;
+
+#if HAL_UART_STATS_ENABLED
+    uint32_t _tx_stats_bytes;
+    uint32_t _rx_stats_bytes;
+    // read and write calls to the device
+    uint32_t _io_calls;
+    uint32_t _last_info_io_calls;
+    static uint32_t _poll_calls;
+#endif
+
 protected:
     const char *device_path;
     volatile bool _initialised;
@@ -90,8 +123,14 @@ protected:
     virtual int _write_fd(const uint8_t *buf, uint16_t n);
     virtual int _read_fd(uint8_t *buf, uint16_t n);
 
+    // file descriptor for poll_read_ready(), -1 to read on every tick
+    virtual int _read_poll_fd() const;
+
     Linux::Semaphore _write_mutex;
 
+    // signalled by _timer_tick() when bytes are received, for wait_timeout()
+    Linux::BinarySemaphore _data_ready;
+
     bool _discard_input() override;
     void _begin(uint32_t b, uint16_t rxS, uint16_t txS) override;
     void _end() override;
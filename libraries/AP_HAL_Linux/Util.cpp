@@ -8,8 +8,12 @@
 #include <unistd.h>
 
 #include <AP_HAL/AP_HAL.h>
+#include <AP_Common/ExpandingString.h>
 
 #include "Heat_Pwm.h"
+#include "I2CDevice.h"
+#include "SPIDevice.h"
+#include "UARTDriver.h"
 #include "Util.h"
 
 using namespace Linux;
@@ -318,6 +322,44 @@ bool Util::get_random_vals(uint8_t* data, size_t size)
     return true;
 }
 
+/*
+  per bus transfer statistics since the last call. CB/WAKE is the
+  average number of periodic callbacks run per wakeup of the bus thread
+ */
+void Util::bus_info(ExpandingString &str)
+{
+    str.printf("BUS   IOCTLS BYTES    ERR  BUSY%% LAVG  LMAX  WAVG  WMAX  CB/WAKE\n");
+    SPIDeviceManager::from(hal.spi)->bus_info(str);
+    I2CDeviceManager::from(hal.i2c_mgr)->bus_info(str);
+}
+
+#if HAL_UART_STATS_ENABLED
+// request information on uart I/O
+void Util::uart_info(ExpandingString &str)
+{
+    // Calculate time since last call
+    const uint32_t now_ms = AP_HAL::millis();
+    const uint32_t dt_ms = now_ms - sys_uart_stats.last_ms;
+    sys_uart_stats.last_ms = now_ms;
+
+    // a header to allow for machine parsers to determine format
+    str.printf("UARTV1\n");
+    for (uint8_t i = 0; i < hal.num_serial; i++) {
+        auto *uart = hal.serial(i);
+        if (uart) {
+            str.printf("SERIAL%u ", i);
+            uart->uart_info(str, sys_uart_stats.serial[i], dt_ms);
+        }
+    }
+
+    // poll() calls shared by all the ports, see UARTDriver::poll_read_ready()
+    const uint32_t poll_calls = UARTDriver::get_poll_calls();
+    str.printf("POLL    IO/s=%5u\n",
+               unsigned(((poll_calls - sys_uart_stats.last_poll_calls) * 1000) / dt_ms));
+    sys_uart_stats.last_poll_calls = poll_calls;
+}
+#endif // HAL_UART_STATS_ENABLED
+
 bool Util::parse_cpu_set(const char *str, cpu_set_t *cpu_set) const
 {
     unsigned long cpu1, cpu2;
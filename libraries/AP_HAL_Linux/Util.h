@@ -101,7 +101,23 @@ public:
     // fills data with random values of requested size
     bool get_random_vals(uint8_t* data, size_t size) override;
 
+    // request information on SPI and I2C bus usage
+    void bus_info(ExpandingString &str) override;
+
+#if HAL_UART_STATS_ENABLED
+    // request information on uart I/O
+    void uart_info(ExpandingString &str) override;
+#endif
+
 private:
+#if HAL_UART_STATS_ENABLED
+    struct {
+        AP_HAL::UARTDriver::StatsTracker serial[AP_HAL::HAL::num_serial];
+        uint32_t last_ms;
+        uint32_t last_poll_calls;
+    } sys_uart_stats;
+#endif
+
 #if CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_DISCO
     static ToneAlarm_Disco _toneAlarm;
 #else
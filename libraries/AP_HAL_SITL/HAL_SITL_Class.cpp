@@ -180,6 +180,12 @@ void HAL_SITL::setup_signal_handlers() const
     sigaction(SIGINT, &sa, NULL);
     sigaction(SIGHUP, &sa, NULL);
     sigaction(SIGQUIT, &sa, NULL);
+#else
+    if (_sitl_state->max_speed()) {
+        // exit cleanly so the time profile is printed
+        sigaction(SIGINT, &sa, NULL);
+        sigaction(SIGHUP, &sa, NULL);
+    }
 #endif
 
 }
@@ -278,6 +284,7 @@ void HAL_SITL::run(int argc, char * const argv[], Callbacks* callbacks) const
     while (true) {
         if (HALSITL::Scheduler::_should_exit) {
             ::fprintf(stderr, "Exitting\n");
+            _sitl_state->print_profile();
             exit(0);
         }
         if (fill_count++ % 10 == 0) {
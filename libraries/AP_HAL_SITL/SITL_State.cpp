@@ -21,7 +21,11 @@
 #include <arpa/inet.h>
 #include <fcntl.h>
 
+#include <time.h>
+
 #include <AP_Param/AP_Param.h>
+#include <AP_Common/ExpandingString.h>
+#include <AP_Scheduler/AP_Scheduler.h>
 #include <SITL/SIM_JSBSim.h>
 #include <AP_HAL/utility/Socket_native.h>
 
@@ -29,6 +33,14 @@ extern const AP_HAL::HAL& hal;
 
 using namespace HALSITL;
 
+// AP_HAL::micros64() is simulation time, so profiling uses this
+static uint64_t wall_time_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000ULL + ts.tv_nsec / 1000U;
+}
+
 void SITL_State::_set_param_default(const char *parm)
 {
     char *pdup = strdup(parm);
@@ -183,7 +195,7 @@ void SITL_State::wait_clock(uint64_t wait_time_usec)
     // MAVProxy/pymavlink take too long to process packets and it ends
     // up seeing traffic well into our past and hits time-out
     // conditions.
-    if (speedup > 1 && hal.scheduler->in_main_thread()) {
+    if ((speedup > 1 || _max_speed) && hal.scheduler->in_main_thread()) {
         while (true) {
             const int queue_length = ((HALSITL::UARTDriver*)hal.serial(0))->get_system_outqueue_length();
             // ::fprintf(stderr, "queue_length=%d\n", (signed)queue_length);
@@ -253,6 +265,8 @@ void SITL_State::_fdm_input_local(void)
     // replace outputs from multicast
     multicast_servo_update(input);
 
+    const uint64_t physics_start_us = _max_speed ? wall_time_us() : 0;
+
     // update the model
     sitl_model->update_home();
     sitl_model->update_model(input);
@@ -260,6 +274,10 @@ void SITL_State::_fdm_input_local(void)
     // get FDM output from the model
     sitl_model->fill_fdm(_sitl->state);
 
+    if (_max_speed) {
+        _physics_wall_us += wall_time_us() - physics_start_us;
+    }
+
 #if HAL_NUM_CAN_IFACES
     if (CANIface::num_interfaces() > 0) {
         multicast_state_send();
@@ -470,6 +488,34 @@ void SITL_State::init(int argc, char * const argv[])
 {
     _scheduler = Scheduler::from(hal.scheduler);
     _parse_command_line(argc, argv);
+    _start_wall_us = wall_time_us();
+}
+
+/*
+  print where the wall clock time went in max-speed mode: the
+  physics model, each scheduler task, and everything else (threads,
+  sockets and scheduler overhead)
+ */
+void SITL_State::print_profile() const
+{
+    if (!_max_speed) {
+        return;
+    }
+    const uint64_t wall_us = wall_time_us() - _start_wall_us;
+    const uint64_t sim_us = AP_HAL::micros64();
+    ::fprintf(stderr, "Profile: %.1fs simulated in %.1fs (%.1fx)\n",
+              sim_us * 1.0e-6, wall_us * 1.0e-6,
+              wall_us > 0 ? double(sim_us) / wall_us : 0.0);
+    ::fprintf(stderr, "%-32s %10.1f %5.1f%%\n", "physics",
+              _physics_wall_us * 0.001,
+              wall_us > 0 ? _physics_wall_us * 100.0 / wall_us : 0.0);
+#if AP_SCHEDULER_WALL_PROFILE_ENABLED
+    ExpandingString str;
+    AP::scheduler().wall_profile_info(str);
+    if (!str.has_failed_allocation() && str.get_length() > 0) {
+        ::fprintf(stderr, "%s", str.get_string());
+    }
+#endif
 }
 
 /*
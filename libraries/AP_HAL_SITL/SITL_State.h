@@ -55,6 +55,12 @@ public:
     
     uint8_t get_instance() const { return _instance; }
 
+    // true if simulating as fast as possible rather than to the wall clock
+    bool max_speed() const { return _max_speed; }
+
+    // print where the wall clock time went in max-speed mode
+    void print_profile() const;
+
 private:
     void _parse_command_line(int argc, char * const argv[]);
     void _set_param_default(const char *parm);
@@ -89,6 +95,11 @@ private:
 
     bool _synthetic_clock_mode;
 
+    // max-speed mode and its time profile
+    bool _max_speed;
+    uint64_t _start_wall_us;
+    uint64_t _physics_wall_us;
+
     bool _use_rtscts;
     bool _use_fg_view;
     
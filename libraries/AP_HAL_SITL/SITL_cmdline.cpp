@@ -44,6 +44,7 @@
 #include <AP_Filesystem/AP_Filesystem.h>
 
 #include <AP_Vehicle/AP_Vehicle_Type.h>
+#include <AP_Scheduler/AP_Scheduler.h>
 
 #include <signal.h>
 #include <stdio.h>
@@ -117,6 +118,10 @@ void SITL_State::_usage(void)
            "\t--start-time TIMESTR     set simulation start time in UNIX timestamp\n"
            "\t--sysid ID               set SYSID_THISMAV\n"
            "\t--slave number           set the number of JSON slaves\n"
+           "\t--max-speed              run as fast as possible and print a time profile on exit\n"
+           "\t--seed N                 seed the simulation's random number generators\n"
+           "\t--lockstep N             step in lock-step with instances 0 to N-1 instead of to the wall clock\n"
+           "\t--lockstep-group N       lock-step group, defaults to the base port less 10 per instance\n"
         );
 }
 
@@ -208,6 +213,8 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
     int opt;
     float speedup = 1.0f;
     float sim_rate_hz = 0;
+    uint8_t lockstep_instances = 0;
+    int32_t lockstep_group = -1;
     _instance = 0;
     _synthetic_clock_mode = false;
     // default to CMAC
@@ -277,6 +284,10 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         CMDLINE_START_TIME,
         CMDLINE_SYSID,
         CMDLINE_SLAVE,
+        CMDLINE_LOCKSTEP,
+        CMDLINE_LOCKSTEP_GROUP,
+        CMDLINE_MAX_SPEED,
+        CMDLINE_SEED,
 #if STORAGE_USE_FLASH
         CMDLINE_SET_STORAGE_FLASH_ENABLED,
 #endif
@@ -337,6 +348,10 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         {"start-time",      true,   0, CMDLINE_START_TIME},
         {"sysid",           true,   0, CMDLINE_SYSID},
         {"slave",           true,   0, CMDLINE_SLAVE},
+        {"lockstep",        true,   0, CMDLINE_LOCKSTEP},
+        {"lockstep-group",  true,   0, CMDLINE_LOCKSTEP_GROUP},
+        {"max-speed",       false,  0, CMDLINE_MAX_SPEED},
+        {"seed",            true,   0, CMDLINE_SEED},
 #if STORAGE_USE_FLASH
         {"set-storage-flash-enabled", true,   0, CMDLINE_SET_STORAGE_FLASH_ENABLED},
 #endif
@@ -546,6 +561,29 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
 #endif
             break;
         }
+        case CMDLINE_LOCKSTEP: {
+            const int32_t instances = atoi(gopt.optarg);
+            if (instances < 1 || instances > 255) {
+                fprintf(stderr, "lockstep must be between 1 and 255 instances\n");
+                exit(1);
+            }
+            lockstep_instances = instances;
+            break;
+        }
+        case CMDLINE_LOCKSTEP_GROUP:
+            lockstep_group = strtoul(gopt.optarg, nullptr, 0);
+            break;
+        case CMDLINE_MAX_SPEED:
+            _max_speed = true;
+            break;
+        case CMDLINE_SEED: {
+            // the sensor noise comes from rand() and random()
+            const unsigned seed = strtoul(gopt.optarg, nullptr, 0);
+            srand(seed);
+            srandom(seed);
+            printf("Random seed %u\n", seed);
+            break;
+        }
         default:
             _usage();
             exit(1);
@@ -584,6 +622,20 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
             sitl_model->set_interface_ports(simulator_address, simulator_port_in, simulator_port_out);
             sitl_model->set_speedup(speedup);
             sitl_model->set_instance(_instance);
+            if (_max_speed) {
+                sitl_model->set_max_speed();
+            }
+#if AP_SIM_LOCKSTEP_ENABLED
+            if (lockstep_instances > 0) {
+                // groups run at the same time can't share ports, so by
+                // default the base port of instance 0, with ports 10
+                // apart per instance as -I gives, keeps them apart
+                if (lockstep_group < 0) {
+                    lockstep_group = _base_port - _instance * 10;
+                }
+                sitl_model->set_lockstep(lockstep_instances, lockstep_group);
+            }
+#endif
             sitl_model->set_autotest_dir(autotest_dir);
             sitl_model->set_config(config);
             _synthetic_clock_mode = true;
@@ -601,6 +653,12 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         exit(1);
     }
 
+#if AP_SCHEDULER_WALL_PROFILE_ENABLED
+    if (_max_speed) {
+        AP::scheduler().enable_wall_profile();
+    }
+#endif
+
     if (AP::sitl()) {
         // Set SITL start time.
         AP::sitl()->start_time_UTC = start_time_UTC;
@@ -28,6 +28,7 @@ public:
     void register_timer_failsafe(AP_HAL::Proc, uint32_t period_us) override;
 
     bool in_main_thread() const override;
+    const void *current_thread() const override { return (const void *)pthread_self(); }
     bool is_system_initialized() override { return _initialized; };
     void set_system_initialized() override;
 
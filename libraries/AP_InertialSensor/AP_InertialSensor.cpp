@@ -20,6 +20,7 @@
 #if !APM_BUILD_TYPE(APM_BUILD_Rover)
 #include <AP_Motors/AP_Motors_Class.h>
 #endif
+#include <AP_Trace/AP_Trace.h>
 #include <GCS_MAVLink/GCS.h>
 
 #include "AP_InertialSensor_BMI160.h"
@@ -1961,6 +1962,9 @@ void AP_InertialSensor::update(void)
         }
 
     _last_update_usec = AP_HAL::micros();
+
+    AP_TRACE_AT(IMU_SAMPLE, _gyro_last_sample_us[_first_usable_gyro]);
+    AP_TRACE(INS_UPDATE);
     
     _have_sample = false;
 
@@ -159,6 +159,107 @@ void AP_InertialSensor_Backend::_rotate_and_correct_gyro(uint8_t instance, Vecto
     gyro.rotate(_imu._board_orientation);
 }
 
+void AP_InertialSensor_Backend::SampleTransform::apply(Vector3f *v, uint8_t n) const
+{
+    for (uint8_t i = 0; i < n; i++) {
+        const Vector3f s = v[i];
+        v[i].x = m.a.x*s.x + m.a.y*s.y + m.a.z*s.z + offset.x;
+        v[i].y = m.b.x*s.x + m.b.y*s.y + m.b.z*s.z + offset.y;
+        v[i].z = m.c.x*s.x + m.c.y*s.y + m.c.z*s.z + offset.z;
+    }
+}
+
+/*
+  combine the steps of _rotate_and_correct_accel() into one
+  transform. The temperature correction is an offset for the current
+  temperature, and the scaling applies to the rows of the sensor
+  rotation
+ */
+void AP_InertialSensor_Backend::get_accel_transform(uint8_t instance, SampleTransform &t) const
+{
+    Matrix3f sensor_rotation;
+    Matrix3f board_rotation;
+    sensor_rotation.from_rotation(_imu._accel_orientation[instance]);
+    board_rotation.from_rotation(_imu._board_orientation);
+
+    Vector3f offset;
+    if (!_imu._calibrating_accel && (_imu._acal == nullptr
+#if HAL_INS_ACCELCAL_ENABLED
+        || !_imu._acal->running()
+#endif
+    )) {
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+        _imu.tcal(instance).correct_accel(_imu.get_temperature(instance), _imu.caltemp_accel(instance), offset);
+#endif
+        offset -= _imu._accel_offset(instance);
+
+        const Vector3f &accel_scale = _imu._accel_scale(instance).get();
+        sensor_rotation.a *= accel_scale.x;
+        sensor_rotation.b *= accel_scale.y;
+        sensor_rotation.c *= accel_scale.z;
+        offset.x *= accel_scale.x;
+        offset.y *= accel_scale.y;
+        offset.z *= accel_scale.z;
+    }
+
+    t.m = board_rotation * sensor_rotation;
+    t.offset = board_rotation * offset;
+}
+
+/*
+  combine the steps of _rotate_and_correct_gyro() into one transform
+ */
+void AP_InertialSensor_Backend::get_gyro_transform(uint8_t instance, SampleTransform &t) const
+{
+    Matrix3f sensor_rotation;
+    Matrix3f board_rotation;
+    sensor_rotation.from_rotation(_imu._gyro_orientation[instance]);
+    board_rotation.from_rotation(_imu._board_orientation);
+
+    Vector3f offset;
+    if (!_imu._calibrating_gyro) {
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+        _imu.tcal(instance).correct_gyro(_imu.get_temperature(instance), _imu.caltemp_gyro(instance), offset);
+#endif
+        offset -= _imu._gyro_offset(instance);
+    }
+
+    t.m = board_rotation * sensor_rotation;
+    t.offset = board_rotation * offset;
+}
+
+void AP_InertialSensor_Backend::_rotate_and_correct_accel(uint8_t instance, Vector3f *accel, uint8_t n)
+{
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+    if (_imu.tcal_learning) {
+        // learning needs each sample in the sensor frame
+        for (uint8_t i = 0; i < n; i++) {
+            _rotate_and_correct_accel(instance, accel[i]);
+        }
+        return;
+    }
+#endif
+    SampleTransform t;
+    get_accel_transform(instance, t);
+    t.apply(accel, n);
+}
+
+void AP_InertialSensor_Backend::_rotate_and_correct_gyro(uint8_t instance, Vector3f *gyro, uint8_t n)
+{
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+    if (_imu.tcal_learning) {
+        // learning needs each sample in the sensor frame
+        for (uint8_t i = 0; i < n; i++) {
+            _rotate_and_correct_gyro(instance, gyro[i]);
+        }
+        return;
+    }
+#endif
+    SampleTransform t;
+    get_gyro_transform(instance, t);
+    t.apply(gyro, n);
+}
+
 /*
   rotate gyro vector and add the gyro offset
  */
@@ -304,9 +405,29 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
     if (hal.opticalflow) {
         hal.opticalflow->push_gyro(gyro.x, gyro.y, dt);
     }
-    
+
+    {
+        WITH_SEMAPHORE(_sem);
+        uint64_t now = AP_HAL::micros64();
+
+        if (now - last_sample_us > 100000U) {
+            // zero accumulator if sensor was unhealthy for 0.1s
+            _imu._delta_angle_acc[instance].zero();
+            _imu._delta_angle_acc_dt[instance] = 0;
+            dt = 0;
+        }
+
+        accumulate_gyro_sample(instance, gyro, dt);
+    }
+
+    // 5us
+    log_gyro_raw(instance, sample_us, gyro, _imu._gyro_filtered[instance]);
+}
+
+void AP_InertialSensor_Backend::accumulate_gyro_sample(uint8_t instance, const Vector3f &gyro, float dt)
+{
     // compute delta angle
-    Vector3f delta_angle = (gyro + _imu._last_raw_gyro[instance]) * 0.5f * dt;
+    const Vector3f delta_angle = (gyro + _imu._last_raw_gyro[instance]) * 0.5f * dt;
 
     // compute coning correction
     // see page 26 of:
@@ -318,37 +439,83 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
     delta_coning = delta_coning % delta_angle;
     delta_coning *= 0.5f;
 
+    // integrate delta angle accumulator
+    // the angles and coning corrections are accumulated separately in the
+    // referenced paper, but in simulation little difference was found between
+    // integrating together and integrating separately (see examples/coning.py)
+    _imu._delta_angle_acc[instance] += delta_angle + delta_coning;
+    _imu._delta_angle_acc_dt[instance] += dt;
+
+    // save previous delta angle for coning correction
+    _imu._last_delta_angle[instance] = delta_angle;
+    _imu._last_raw_gyro[instance] = gyro;
+
+    // apply gyro filters and sample for FFT
+    apply_gyro_filters(instance, gyro);
+
+    _imu._new_gyro_data[instance] = true;
+}
+
+void AP_InertialSensor_Backend::_notify_new_gyro_raw_samples(uint8_t instance, const Vector3f *gyro, uint8_t n)
+{
+    if (has_been_killed(instance) || n == 0) {
+        return;
+    }
+    if (n > max_sample_block) {
+        _notify_new_gyro_raw_samples(instance, gyro, max_sample_block);
+        _notify_new_gyro_raw_samples(instance, &gyro[max_sample_block], n - max_sample_block);
+        return;
+    }
+
+    for (uint8_t i = 0; i < n; i++) {
+        _update_sensor_rate(_imu._sample_gyro_count[instance], _imu._sample_gyro_start_us[instance],
+                            _imu._gyro_raw_sample_rates[instance]);
+    }
+
+    // don't accept below 40Hz
+    if (_imu._gyro_raw_sample_rates[instance] < 40) {
+        return;
+    }
+
+    const float dt = 1.0f / _imu._gyro_raw_sample_rates[instance];
+    const uint64_t last_sample_us = _imu._gyro_last_sample_us[instance];
+    const uint64_t now_us = AP_HAL::micros64();
+    _imu._gyro_last_sample_us[instance] = now_us;
+
+#if AP_MODULE_SUPPORTED
+    for (uint8_t i = 0; i < n; i++) {
+        AP_Module::call_hook_gyro_sample(instance, dt, gyro[i]);
+    }
+#endif
+
+    if (hal.opticalflow) {
+        for (uint8_t i = 0; i < n; i++) {
+            hal.opticalflow->push_gyro(gyro[i].x, gyro[i].y, dt);
+        }
+    }
+
+    Vector3f filtered[max_sample_block];
     {
         WITH_SEMAPHORE(_sem);
-        uint64_t now = AP_HAL::micros64();
 
-        if (now - last_sample_us > 100000U) {
-            // zero accumulator if sensor was unhealthy for 0.1s
+        // zero accumulator if sensor was unhealthy for 0.1s
+        const bool stale = now_us - last_sample_us > 100000U;
+        if (stale) {
             _imu._delta_angle_acc[instance].zero();
             _imu._delta_angle_acc_dt[instance] = 0;
-            dt = 0;
-            delta_angle.zero();
         }
 
-        // integrate delta angle accumulator
-        // the angles and coning corrections are accumulated separately in the
-        // referenced paper, but in simulation little difference was found between
-        // integrating together and integrating separately (see examples/coning.py)
-        _imu._delta_angle_acc[instance] += delta_angle + delta_coning;
-        _imu._delta_angle_acc_dt[instance] += dt;
-
-        // save previous delta angle for coning correction
-        _imu._last_delta_angle[instance] = delta_angle;
-        _imu._last_raw_gyro[instance] = gyro;
-
-        // apply gyro filters and sample for FFT
-        apply_gyro_filters(instance, gyro);
-
-        _imu._new_gyro_data[instance] = true;
+        for (uint8_t i = 0; i < n; i++) {
+            accumulate_gyro_sample(instance, gyro[i], (stale && i == 0) ? 0 : dt);
+            filtered[i] = _imu._gyro_filtered[instance];
+        }
     }
 
-    // 5us
-    log_gyro_raw(instance, sample_us, gyro, _imu._gyro_filtered[instance]);
+    // the samples were taken dt apart, the last one now
+    const uint32_t dt_us = dt * 1.0e6f;
+    for (uint8_t i = 0; i < n; i++) {
+        log_gyro_raw(instance, now_us - (n - 1 - i) * dt_us, gyro[i], filtered[i]);
+    }
 }
 
 /*
@@ -567,27 +734,37 @@ void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
             _imu._delta_velocity_acc_dt[instance] = 0;
             dt = 0;
         }
-        
-        // delta velocity
-        _imu._delta_velocity_acc[instance] += accel * dt;
-        _imu._delta_velocity_acc_dt[instance] += dt;
 
-        _imu._accel_filtered[instance] = _imu._accel_filter[instance].apply(accel);
-        if (_imu._accel_filtered[instance].is_nan() || _imu._accel_filtered[instance].is_inf()) {
-            _imu._accel_filter[instance].reset();
-        }
+        accumulate_accel_sample(instance, accel, dt);
+    }
 
-        _imu.set_accel_peak_hold(instance, _imu._accel_filtered[instance]);
+    // 5us
+    log_accel_sample(instance, sample_us, accel, _imu._accel_filtered[instance]);
+}
 
-        _imu._new_accel_data[instance] = true;
+void AP_InertialSensor_Backend::accumulate_accel_sample(uint8_t instance, const Vector3f &accel, float dt)
+{
+    // delta velocity
+    _imu._delta_velocity_acc[instance] += accel * dt;
+    _imu._delta_velocity_acc_dt[instance] += dt;
+
+    _imu._accel_filtered[instance] = _imu._accel_filter[instance].apply(accel);
+    if (_imu._accel_filtered[instance].is_nan() || _imu._accel_filtered[instance].is_inf()) {
+        _imu._accel_filter[instance].reset();
     }
 
-    // 5us
+    _imu.set_accel_peak_hold(instance, _imu._accel_filtered[instance]);
+
+    _imu._new_accel_data[instance] = true;
+}
+
+void AP_InertialSensor_Backend::log_accel_sample(uint8_t instance, const uint64_t sample_us, const Vector3f &accel, const Vector3f &filtered_accel)
+{
 #if AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED
     if (!_imu.batchsampler.doing_post_filter_logging()) {
         log_accel_raw(instance, sample_us, accel);
     } else {
-        log_accel_raw(instance, sample_us, _imu._accel_filtered[instance]);
+        log_accel_raw(instance, sample_us, filtered_accel);
     }
 #else
     // assume we're doing pre-filter logging:
@@ -595,6 +772,63 @@ void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
 #endif
 }
 
+void AP_InertialSensor_Backend::_notify_new_accel_raw_samples(uint8_t instance, const Vector3f *accel, uint8_t n)
+{
+    if (has_been_killed(instance) || n == 0) {
+        return;
+    }
+    if (n > max_sample_block) {
+        _notify_new_accel_raw_samples(instance, accel, max_sample_block);
+        _notify_new_accel_raw_samples(instance, &accel[max_sample_block], n - max_sample_block);
+        return;
+    }
+
+    for (uint8_t i = 0; i < n; i++) {
+        _update_sensor_rate(_imu._sample_accel_count[instance], _imu._sample_accel_start_us[instance],
+                            _imu._accel_raw_sample_rates[instance]);
+    }
+
+    // don't accept below 40Hz
+    if (_imu._accel_raw_sample_rates[instance] < 40) {
+        return;
+    }
+
+    const float dt = 1.0f / _imu._accel_raw_sample_rates[instance];
+    const uint64_t last_sample_us = _imu._accel_last_sample_us[instance];
+    const uint64_t now_us = AP_HAL::micros64();
+    _imu._accel_last_sample_us[instance] = now_us;
+
+    for (uint8_t i = 0; i < n; i++) {
+#if AP_MODULE_SUPPORTED
+        AP_Module::call_hook_accel_sample(instance, dt, accel[i], false);
+#endif
+        _imu.calc_vibration_and_clipping(instance, accel[i], dt);
+    }
+
+    Vector3f filtered[max_sample_block];
+    {
+        WITH_SEMAPHORE(_sem);
+
+        // zero accumulator if sensor was unhealthy for 0.1s
+        const bool stale = now_us - last_sample_us > 100000U;
+        if (stale) {
+            _imu._delta_velocity_acc[instance].zero();
+            _imu._delta_velocity_acc_dt[instance] = 0;
+        }
+
+        for (uint8_t i = 0; i < n; i++) {
+            accumulate_accel_sample(instance, accel[i], (stale && i == 0) ? 0 : dt);
+            filtered[i] = _imu._accel_filtered[instance];
+        }
+    }
+
+    // the samples were taken dt apart, the last one now
+    const uint32_t dt_us = dt * 1.0e6f;
+    for (uint8_t i = 0; i < n; i++) {
+        log_accel_sample(instance, now_us - (n - 1 - i) * dt_us, accel[i], filtered[i]);
+    }
+}
+
 /*
   handle a delta-velocity sample from the backend. This assumes FIFO style sampling and
   the sample should not be rotated or corrected for offsets
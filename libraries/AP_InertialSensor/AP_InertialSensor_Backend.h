@@ -138,6 +138,20 @@ public:
         DEVTYPE_INS_SCHA63T  = 0x3C,
     };
 
+    /*
+      the sensor and board rotations, calibration and temperature
+      correction of a sensor combined as v = m * v + offset, so a
+      block of FIFO samples can be corrected in a single loop
+     */
+    struct SampleTransform {
+        Matrix3f m;
+        Vector3f offset;
+        void apply(Vector3f *v, uint8_t n) const __RAMFUNC__;
+    };
+
+    // the most samples handled at once by the block interfaces
+    static const uint8_t max_sample_block = 16;
+
 protected:
     // access to frontend
     AP_InertialSensor &_imu;
@@ -155,6 +169,11 @@ protected:
     void _rotate_and_correct_accel(uint8_t instance, Vector3f &accel) __RAMFUNC__;
     void _rotate_and_correct_gyro(uint8_t instance, Vector3f &gyro) __RAMFUNC__;
 
+    // rotate and correct a block of n samples from a FIFO, giving the
+    // same result as calling the single sample versions for each
+    void _rotate_and_correct_accel(uint8_t instance, Vector3f *accel, uint8_t n) __RAMFUNC__;
+    void _rotate_and_correct_gyro(uint8_t instance, Vector3f *gyro, uint8_t n) __RAMFUNC__;
+
     // rotate gyro vector, offset and publish
     void _publish_gyro(uint8_t instance, const Vector3f &gyro) __RAMFUNC__; /* front end */
 
@@ -170,6 +189,10 @@ protected:
     // sensors, and should be set to zero for FIFO based sensors
     void _notify_new_gyro_raw_sample(uint8_t instance, const Vector3f &accel, uint64_t sample_us=0) __RAMFUNC__;
 
+    // block version of _notify_new_gyro_raw_sample() for FIFO based
+    // sensors, taking n rotated and corrected samples, oldest first
+    void _notify_new_gyro_raw_samples(uint8_t instance, const Vector3f *gyro, uint8_t n) __RAMFUNC__;
+
     // alternative interface using delta-angles. Rotation and correction is handled inside this function
     void _notify_new_delta_angle(uint8_t instance, const Vector3f &dangle);
     
@@ -184,6 +207,10 @@ protected:
     // sensors, and should be set to zero for FIFO based sensors
     void _notify_new_accel_raw_sample(uint8_t instance, const Vector3f &accel, uint64_t sample_us=0, bool fsync_set=false) __RAMFUNC__;
 
+    // block version of _notify_new_accel_raw_sample() for FIFO based
+    // sensors, taking n rotated and corrected samples, oldest first
+    void _notify_new_accel_raw_samples(uint8_t instance, const Vector3f *accel, uint8_t n) __RAMFUNC__;
+
     // alternative interface using delta-velocities. Rotation and correction is handled inside this function
     void _notify_new_delta_velocity(uint8_t instance, const Vector3f &dvelocity);
     
@@ -343,8 +370,19 @@ protected:
 
 private:
 
+    // integrate a rotated and corrected sample and apply the
+    // filters, called with _sem held
+    void accumulate_gyro_sample(uint8_t instance, const Vector3f &gyro, float dt) __RAMFUNC__;
+    void accumulate_accel_sample(uint8_t instance, const Vector3f &accel, float dt) __RAMFUNC__;
+
+    // get the combined correction for a block of samples
+    void get_accel_transform(uint8_t instance, SampleTransform &t) const __RAMFUNC__;
+    void get_gyro_transform(uint8_t instance, SampleTransform &t) const __RAMFUNC__;
+
     bool should_log_imu_raw() const ;
     void log_accel_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &accel) __RAMFUNC__;
+    // log pre or post filter accel as set by the batch sampler
+    void log_accel_sample(uint8_t instance, const uint64_t sample_us, const Vector3f &accel, const Vector3f &filtered_accel) __RAMFUNC__;
     void log_gyro_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &raw_gyro, const Vector3f &filtered_gyro) __RAMFUNC__;
 
     // logging
@@ -73,6 +73,7 @@ private:
 
     bool accumulate_samples(const struct FIFOData *data, uint8_t n_samples);
     bool accumulate_highres_samples(const struct FIFODataHighRes *data, uint8_t n_samples);
+    void process_samples(Vector3f *accel, Vector3f *gyro, uint8_t n);
 
     // reset FIFO configure1 register
     uint8_t fifo_config1;
@@ -177,7 +177,7 @@ void AP_InertialSensor::write_notch_log_messages() const
         const float* notches = notch.calculated_notch_freq_hz;
         if (notch.num_calculated_notch_frequencies > 1) {
             // log per motor center frequencies
-            AP::logger().WriteStreaming(
+            LOGGER_WRITE_STREAMING_FAST(
                 "FTN", "TimeUS,I,NDn,NF1,NF2,NF3,NF4,NF5,NF6,NF7,NF8,NF9,NF10,NF11,NF12", "s#-zzzzzzzzzzzz", "F--------------", "QBBffffffffffff",
                 now_us,
                 i,
@@ -187,7 +187,7 @@ void AP_InertialSensor::write_notch_log_messages() const
                 notches[8], notches[9], notches[10], notches[11]);
         } else {
             // log single center frequency
-            AP::logger().WriteStreaming(
+            LOGGER_WRITE_STREAMING_FAST(
                 "FTNS", "TimeUS,I,NF", "s#z", "F--", "QBf",
                 now_us,
                 i,
@@ -0,0 +1,233 @@
+/*
+  compare correcting IMU FIFO samples one at a time with correcting
+  them as a block through AP_InertialSensor_Backend::SampleTransform,
+  and the steps after correction of _notify_new_gyro_raw_sample()
+  with those of _notify_new_gyro_raw_samples()
+
+  The workload is one 1kHz loop of three IMUs with 8kHz FIFOs, so
+  three blocks of eight samples
+ */
+#include <AP_gbenchmark.h>
+
+#include <AP_InertialSensor/AP_InertialSensor_Backend.h>
+#include <Filter/LowPassFilter2p.h>
+#include <Filter/NotchFilter.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static const uint8_t num_imus = 3;
+static const uint8_t block_len = 8;
+
+static const enum Rotation sensor_rotation[num_imus] {
+    ROTATION_NONE,
+    ROTATION_YAW_270,
+    ROTATION_ROLL_180_YAW_90,
+};
+static const enum Rotation board_rotation = ROTATION_YAW_45;
+static const Vector3f offset{0.1f, -0.2f, 0.05f};
+static const Vector3f scale{1.01f, 0.99f, 1.02f};
+
+// temperature calibration as in AP_InertialSensor_TCal::correct_sensor()
+static const Vector3f tcal_coeff[3] {
+    {2.1e-3f, -1.3e-3f, 4.0e-4f},
+    {-3.2e-5f, 1.1e-5f, 2.0e-6f},
+    {4.0e-7f, -2.5e-7f, 1.0e-7f},
+};
+static float temperature[num_imus] {45, 47, 52};
+static const float cal_temperature = 35;
+
+static Vector3f tcal_polynomial(float tdiff)
+{
+    return (tcal_coeff[0] + (tcal_coeff[1] + tcal_coeff[2]*tdiff)*tdiff)*tdiff;
+}
+
+static void tcal_correct(float temp, Vector3f &v)
+{
+    temp = constrain_float(temp, -20, 80);
+    v -= tcal_polynomial(temp - 35);
+    v += tcal_polynomial(constrain_float(cal_temperature, -20, 80) - 35);
+}
+
+static void fill_samples(Vector3f samples[num_imus][block_len])
+{
+    for (uint8_t i = 0; i < num_imus; i++) {
+        for (uint8_t j = 0; j < block_len; j++) {
+            samples[i][j] = Vector3f{0.1f * j, -0.2f * i, 9.8f};
+        }
+    }
+}
+
+// the per sample steps of _rotate_and_correct_accel()
+static void BM_CorrectEachSample(benchmark::State& state)
+{
+    Vector3f fifo[num_imus][block_len];
+    Vector3f samples[num_imus][block_len];
+    fill_samples(fifo);
+
+    while (state.KeepRunning()) {
+        memcpy(samples, fifo, sizeof(samples));
+        for (uint8_t i = 0; i < num_imus; i++) {
+            for (uint8_t j = 0; j < block_len; j++) {
+                Vector3f &v = samples[i][j];
+                v.rotate(sensor_rotation[i]);
+                tcal_correct(temperature[i], v);
+                v -= offset;
+                v.x *= scale.x;
+                v.y *= scale.y;
+                v.z *= scale.z;
+                v.rotate(board_rotation);
+            }
+        }
+        gbenchmark_escape(samples);
+    }
+}
+
+// building the transform for each block as the backend does, then
+// applying it to the block
+static void BM_CorrectSampleBlock(benchmark::State& state)
+{
+    Vector3f fifo[num_imus][block_len];
+    Vector3f samples[num_imus][block_len];
+    fill_samples(fifo);
+
+    while (state.KeepRunning()) {
+        memcpy(samples, fifo, sizeof(samples));
+        for (uint8_t i = 0; i < num_imus; i++) {
+            Matrix3f sensor;
+            Matrix3f board;
+            sensor.from_rotation(sensor_rotation[i]);
+            board.from_rotation(board_rotation);
+            sensor.a *= scale.x;
+            sensor.b *= scale.y;
+            sensor.c *= scale.z;
+            Vector3f block_offset;
+            tcal_correct(temperature[i], block_offset);
+            block_offset -= offset;
+            const Vector3f scaled_offset{block_offset.x * scale.x, block_offset.y * scale.y, block_offset.z * scale.z};
+
+            AP_InertialSensor_Backend::SampleTransform t;
+            t.m = board * sensor;
+            t.offset = board * scaled_offset;
+            t.apply(samples[i], block_len);
+        }
+        gbenchmark_escape(samples);
+    }
+}
+
+/*
+  the state the notify path updates for one IMU: the sample rate,
+  stale check, coning corrected integration and the notch and low
+  pass filters
+ */
+struct notify_state {
+    HAL_Semaphore sem;
+    NotchFilterVector3f notch;
+    LowPassFilter2pVector3f lpf;
+    uint32_t sample_count;
+    uint64_t last_sample_us;
+    Vector3f delta_angle_acc;
+    Vector3f last_delta_angle;
+    Vector3f last_raw_gyro;
+    Vector3f filtered;
+    float delta_angle_acc_dt;
+};
+
+static const float sample_rate_hz = 8000;
+static notify_state notify[num_imus];
+static uint64_t now_us;
+
+static void init_notify()
+{
+    for (auto &n : notify) {
+        n.notch.init(sample_rate_hz, 180, 90, 40);
+        n.lpf.set_cutoff_frequency(sample_rate_hz, 80);
+    }
+}
+
+// accumulate_gyro_sample() without the sample windows for the FFT
+static void accumulate(notify_state &n, const Vector3f &gyro, float dt)
+{
+    const Vector3f delta_angle = (gyro + n.last_raw_gyro) * 0.5f * dt;
+    Vector3f delta_coning = (n.delta_angle_acc + n.last_delta_angle * (1.0f / 6.0f));
+    delta_coning = delta_coning % delta_angle;
+    delta_coning *= 0.5f;
+    n.delta_angle_acc += delta_angle + delta_coning;
+    n.delta_angle_acc_dt += dt;
+    n.last_delta_angle = delta_angle;
+    n.last_raw_gyro = gyro;
+
+    const Vector3f filtered = n.lpf.apply(n.notch.apply(gyro));
+    if (filtered.is_nan() || filtered.is_inf()) {
+        n.lpf.reset();
+        n.notch.reset();
+    } else {
+        n.filtered = filtered;
+    }
+}
+
+// a call to _notify_new_gyro_raw_sample() for each sample
+static void BM_NotifyEachSample(benchmark::State& state)
+{
+    Vector3f samples[num_imus][block_len];
+    fill_samples(samples);
+    init_notify();
+
+    while (state.KeepRunning()) {
+        for (uint8_t i = 0; i < num_imus; i++) {
+            notify_state &n = notify[i];
+            for (uint8_t j = 0; j < block_len; j++) {
+                n.sample_count++;
+                const float dt = 1.0f / sample_rate_hz;
+                const uint64_t last_sample_us = n.last_sample_us;
+                n.last_sample_us = ++now_us;
+
+                WITH_SEMAPHORE(n.sem);
+                if (n.last_sample_us - last_sample_us > 100000U) {
+                    n.delta_angle_acc.zero();
+                    n.delta_angle_acc_dt = 0;
+                }
+                accumulate(n, samples[i][j], dt);
+            }
+        }
+        gbenchmark_escape(notify);
+    }
+}
+
+// a call to _notify_new_gyro_raw_samples() for each block
+static void BM_NotifySampleBlock(benchmark::State& state)
+{
+    Vector3f samples[num_imus][block_len];
+    fill_samples(samples);
+    init_notify();
+
+    while (state.KeepRunning()) {
+        for (uint8_t i = 0; i < num_imus; i++) {
+            notify_state &n = notify[i];
+            n.sample_count += block_len;
+            const float dt = 1.0f / sample_rate_hz;
+            const uint64_t last_sample_us = n.last_sample_us;
+            n.last_sample_us = ++now_us;
+
+            Vector3f filtered[AP_InertialSensor_Backend::max_sample_block];
+            WITH_SEMAPHORE(n.sem);
+            const bool stale = n.last_sample_us - last_sample_us > 100000U;
+            if (stale) {
+                n.delta_angle_acc.zero();
+                n.delta_angle_acc_dt = 0;
+            }
+            for (uint8_t j = 0; j < block_len; j++) {
+                accumulate(n, samples[i][j], (stale && j == 0) ? 0 : dt);
+                filtered[j] = n.filtered;
+            }
+            gbenchmark_escape(filtered);
+        }
+        gbenchmark_escape(notify);
+    }
+}
+
+BENCHMARK(BM_CorrectEachSample);
+BENCHMARK(BM_CorrectSampleBlock);
+BENCHMARK(BM_NotifyEachSample);
+BENCHMARK(BM_NotifySampleBlock);
+
+BENCHMARK_MAIN();
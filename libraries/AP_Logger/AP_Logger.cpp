@@ -770,8 +770,8 @@ void AP_Logger::WriteCriticalBlock(const void *pBuffer, uint16_t size) {
     FOR_EACH_BACKEND(WriteCriticalBlock(pBuffer, size));
 }
 
-void AP_Logger::WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical) {
-    FOR_EACH_BACKEND(WritePrioritisedBlock(pBuffer, size, is_critical));
+void AP_Logger::WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical, bool writev_streaming) {
+    FOR_EACH_BACKEND(WritePrioritisedBlock(pBuffer, size, is_critical, writev_streaming));
 }
 
 // change me to "DoTimeConsumingPreparations"?
@@ -1033,6 +1033,27 @@ void AP_Logger::WriteV(const char *name, const char *labels, const char *units,
     }
 }
 
+const AP_Logger::log_write_fmt *AP_Logger::resolve_write_handle(WriteHandle &h, const char *name, const char *labels, const char *units, const char *mults, const char *fmt)
+{
+    // as in WriteV, IDs can be re-used in replay so the handle is
+    // not cached there
+    const bool direct_comp = APM_BUILD_TYPE(APM_BUILD_Replay);
+    const log_write_fmt *f = msg_fmt_for_name(name, labels, units, mults, fmt, direct_comp);
+    if (f == nullptr) {
+#if !APM_BUILD_TYPE(APM_BUILD_Replay)
+        INTERNAL_ERROR(AP_InternalError::error_t::logger_mapfailure);
+#endif
+        return nullptr;
+    }
+    if (!direct_comp) {
+        // formats are never freed, so once set the handle can be
+        // read without taking log_write_fmts_sem. Two threads racing
+        // here both store the same pointer
+        h.f = f;
+    }
+    return f;
+}
+
 /*
   when we are doing replay logging we want to delay start of the EKF
   until after the headers are out so that on replay all parameter
@@ -17,6 +17,7 @@
 #include <stdint.h>
 
 #include "LoggerMessageWriter.h"
+#include "LogPacker.h"
 
 class AP_Logger_Backend;
 
@@ -190,6 +191,7 @@ class AP_Logger
 {
     friend class AP_Logger_Backend; // for _num_types
     friend class AP_Logger_RateLimiter;
+    friend class AP_Logger_Test; // for tests/logger_test.h
 
 public:
     FUNCTOR_TYPEDEF(vehicle_startup_message_Writer, void);
@@ -396,6 +398,38 @@ public:
         const char *mults;
     } *log_write_fmts;
 
+    // message type of a LOGGER_WRITE_FAST() call site, looked up on
+    // the first write from it
+    struct WriteHandle {
+        const struct log_write_fmt *f;
+    };
+
+    /*
+      write a message as Write() or WriteStreaming() does, but with
+      the message type cached in h and the arguments packed by a
+      layout fixed at compile time. F is a type with a static
+      constexpr str() returning the format; use LOGGER_WRITE_FAST()
+      rather than calling this directly
+     */
+    template <typename F, typename... Args>
+    void WriteFast(WriteHandle &h, bool is_streaming, const char *name, const char *labels, const char *units, const char *mults, Args... args) {
+        static_assert(LogPacker::valid(F::str()), "unknown format character");
+        static_assert(LogPacker::num_fields(F::str()) == sizeof...(Args), "argument count does not match format");
+        const log_write_fmt *f = h.f;
+        if (f == nullptr) {
+            f = resolve_write_handle(h, name, labels, units, mults, F::str());
+            if (f == nullptr) {
+                return;
+            }
+        }
+        uint8_t buf[LOG_PACKET_HEADER_LEN + LogPacker::payload_len(F::str())];
+        buf[0] = HEAD_BYTE1;
+        buf[1] = HEAD_BYTE2;
+        buf[2] = f->msg_type;
+        LogPacker::pack<F, 0>(&buf[LOG_PACKET_HEADER_LEN], args...);
+        WritePrioritisedBlock(buf, sizeof(buf), false, is_streaming);
+    }
+
     // return (possibly allocating) a log_write_fmt for a name
     struct log_write_fmt *msg_fmt_for_name(const char *name, const char *labels, const char *units, const char *mults, const char *fmt, const bool direct_comp = false, const bool copy_strings = false);
 
@@ -423,9 +457,12 @@ protected:
     /* might be useful if you have a boolean indicating a message is
      * important... */
     void WritePrioritisedBlock(const void *pBuffer, uint16_t size,
-                               bool is_critical);
+                               bool is_critical, bool writev_streaming=false);
 
 private:
+    // find the message type for a WriteFast() call site
+    const log_write_fmt *resolve_write_handle(WriteHandle &h, const char *name, const char *labels, const char *units, const char *mults, const char *fmt);
+
     #define LOGGER_MAX_BACKENDS 2
     uint8_t _next_backend;
     AP_Logger_Backend *backends[LOGGER_MAX_BACKENDS];
@@ -615,9 +652,30 @@ namespace AP {
 #define LOGGER_WRITE_ERROR(subsys, err) AP::logger().Write_Error(subsys, err)
 #define LOGGER_WRITE_EVENT(evt) AP::logger().Write_Event(evt)
 
+/*
+  equivalent to AP::logger().Write(name, labels, units, mults, fmt,
+  ...) for a fixed message. The message type is looked up once per
+  call site, and fmt must be a string literal whose field count
+  matches the arguments. units and mults may be nullptr, as for
+  Write(name, labels, fmt, ...)
+ */
+#define LOGGER_WRITE_FAST_IMPL(is_streaming, name, labels, units, mults, fmt, ...) \
+    do {                                                                \
+        struct log_fmt_ { static constexpr const char *str() { return fmt; } }; \
+        static AP_Logger::WriteHandle log_handle_;                      \
+        AP::logger().WriteFast<log_fmt_>(log_handle_, is_streaming, name, labels, units, mults, __VA_ARGS__); \
+    } while (0)
+#define LOGGER_WRITE_FAST(name, labels, units, mults, fmt, ...) \
+    LOGGER_WRITE_FAST_IMPL(false, name, labels, units, mults, fmt, __VA_ARGS__)
+// as above for WriteStreaming()
+#define LOGGER_WRITE_STREAMING_FAST(name, labels, units, mults, fmt, ...) \
+    LOGGER_WRITE_FAST_IMPL(true, name, labels, units, mults, fmt, __VA_ARGS__)
+
 #else
 
 #define LOGGER_WRITE_ERROR(subsys, err)
 #define LOGGER_WRITE_EVENT(evt)
+#define LOGGER_WRITE_FAST(name, labels, units, mults, fmt, ...)
+#define LOGGER_WRITE_STREAMING_FAST(name, labels, units, mults, fmt, ...)
 
 #endif  // HAL_LOGGING_ENABLED
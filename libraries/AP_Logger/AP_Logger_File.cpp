@@ -91,6 +91,15 @@ void AP_Logger_File::Init()
 
     DEV_PRINTF("AP_Logger_File: buffer size=%u\n", (unsigned)bufsize);
 
+#if HAL_LOGGER_STAGING_ENABLED
+    // rings are claimed in order, so stop at the first we can't have
+    for (auto &ring : staging) {
+        if (!ring.buf.set_size(HAL_LOGGER_STAGING_BUFSIZE)) {
+            break;
+        }
+    }
+#endif
+
     _initialised = true;
 
     const char* custom_dir = hal.util->get_custom_log_directory();
@@ -137,6 +146,9 @@ bool AP_Logger_File::log_exists(const uint16_t lognum) const
 void AP_Logger_File::periodic_1Hz()
 {
     AP_Logger_Backend::periodic_1Hz();
+#if HAL_LOGGER_STAGING_ENABLED
+    Write_AP_Logger_Stats_Staging();
+#endif
 
     if (_initialised &&
         _write_fd == -1 && _read_fd == -1 &&
@@ -439,8 +451,63 @@ bool AP_Logger_File::StartNewLogOK() const
 /* Write a block of data at current offset */
 bool AP_Logger_File::_WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical)
 {
+#if HAL_LOGGER_STAGING_ENABLED
+    staging_ring *ring = staging_ring_for_thread(false);
+    // FMT messages are never staged so that a format is in the log
+    // before any thread's messages which use it
+    const bool can_stage = !is_critical &&
+        !_writing_startup_messages &&
+        size <= UINT8_MAX &&
+        ((const uint8_t *)pBuffer)[2] != LOG_FORMAT_MSG;
+
+    if (semaphore.take_nonblocking()) {
+        // uncontended, anything this thread has staged goes first
+        if (ring != nullptr) {
+            drain_staging_ring(*ring);
+            if (ring->buf.available() == 0) {
+                // let another thread have it
+                ring->owner.store(nullptr);
+            } else if (can_stage) {
+                // _writebuf is full, queue behind what is staged
+                semaphore.give();
+                return stage_message(*ring, pBuffer, size);
+            }
+        }
+        const bool ret = write_to_writebuf(pBuffer, size, is_critical);
+        semaphore.give();
+        return ret;
+    }
+
+    if (can_stage) {
+        if (ring == nullptr) {
+            ring = staging_ring_for_thread(true);
+        }
+        if (ring != nullptr && stage_message(*ring, pBuffer, size)) {
+            return true;
+        }
+        // no ring or it is full, wait for _writebuf
+    }
+
+    const uint32_t wait_start_us = AP_HAL::micros();
+    semaphore.take_blocking();
+    const uint32_t wait_us = AP_HAL::micros() - wait_start_us;
+    contention.count++;
+    contention.wait_us_sum += wait_us;
+    contention.wait_us_max = MAX(contention.wait_us_max, wait_us);
+    if (ring != nullptr) {
+        drain_staging_ring(*ring);
+    }
+    const bool ret = write_to_writebuf(pBuffer, size, is_critical);
+    semaphore.give();
+    return ret;
+#else
     WITH_SEMAPHORE(semaphore);
+    return write_to_writebuf(pBuffer, size, is_critical);
+#endif
+}
 
+bool AP_Logger_File::write_to_writebuf(const void *pBuffer, uint16_t size, bool is_critical)
+{
 #if APM_BUILD_TYPE(APM_BUILD_Replay)
     if (AP::FS().write(_write_fd, pBuffer, size) != size) {
         AP_HAL::panic("Short write");
@@ -484,6 +551,117 @@ bool AP_Logger_File::_WritePrioritisedBlock(const void *pBuffer, uint16_t size,
     return true;
 }
 
+#if HAL_LOGGER_STAGING_ENABLED
+AP_Logger_File::staging_ring *AP_Logger_File::staging_ring_for_thread(bool claim)
+{
+    const void *self = hal.scheduler->current_thread();
+    if (self == nullptr) {
+        return nullptr;
+    }
+    for (auto &ring : staging) {
+        if (ring.owner.load() == self) {
+            return &ring;
+        }
+    }
+    if (!claim) {
+        return nullptr;
+    }
+    for (auto &ring : staging) {
+        if (ring.buf.get_size() == 0) {
+            // rings are allocated in order, so no later ring has a buffer
+            break;
+        }
+        const void *owner = nullptr;
+        if (ring.owner.compare_exchange_strong(owner, self)) {
+            return &ring;
+        }
+        // taken, try the next
+    }
+    return nullptr;
+}
+
+bool AP_Logger_File::stage_message(staging_ring &ring, const void *pBuffer, uint16_t size)
+{
+    if (ring.buf.space() < size + 1U) {
+        ring.dropped++;
+        return false;
+    }
+    // a single write so the IO thread never sees a partial message
+    uint8_t msg[UINT8_MAX + 1];
+    msg[0] = size;
+    memcpy(&msg[1], pBuffer, size);
+    ring.buf.write(msg, size + 1U);
+    ring.staged++;
+    return true;
+}
+
+void AP_Logger_File::drain_staging_ring(staging_ring &ring)
+{
+    const uint32_t reserved = critical_message_reserved_space(_writebuf.get_size());
+    while (true) {
+        const int16_t size = ring.buf.peek(0);
+        if (size <= 0) {
+            break;
+        }
+        // staged messages are not critical, so leave them staged
+        // rather than use the space reserved for critical messages
+        const uint32_t space = _writebuf.space();
+        if (space < reserved + size) {
+            break;
+        }
+        uint8_t msg[UINT8_MAX];
+        ring.buf.advance(1);
+        ring.buf.read(msg, size);
+        _writebuf.write(msg, size);
+        df_stats_gather(size, _writebuf.space());
+    }
+}
+
+void AP_Logger_File::drain_staging()
+{
+    WITH_SEMAPHORE(semaphore);
+    for (auto &ring : staging) {
+        // a ring is only released once it is empty
+        if (ring.owner.load() == nullptr) {
+            continue;
+        }
+        drain_staging_ring(ring);
+    }
+}
+
+// staged messages belong to the log being closed
+void AP_Logger_File::discard_staging()
+{
+    WITH_SEMAPHORE(semaphore);
+    for (auto &ring : staging) {
+        ring.buf.advance(ring.buf.available());
+    }
+}
+
+void AP_Logger_File::Write_AP_Logger_Stats_Staging()
+{
+    struct log_DSTG pkt {
+        LOG_PACKET_HEADER_INIT(LOG_DF_STAGING_STATS),
+        time_us         : AP_HAL::micros64(),
+    };
+    for (const auto &ring : staging) {
+        if (ring.owner.load() != nullptr) {
+            pkt.rings++;
+        }
+        pkt.staged += ring.staged;
+        pkt.dropped += ring.dropped;
+    }
+    {
+        WITH_SEMAPHORE(semaphore);
+        pkt.contended = contention.count;
+        pkt.wait_max = contention.wait_us_max;
+        pkt.wait_avg = contention.count ? contention.wait_us_sum / contention.count : 0;
+        memset(&contention, 0, sizeof(contention));
+    }
+    WriteBlock(&pkt, sizeof(pkt));
+}
+#endif  // HAL_LOGGER_STAGING_ENABLED
+
 /*
   find the highest log number
  */
@@ -843,6 +1021,9 @@ void AP_Logger_File::start_new_log(void)
     _open_error_ms = 0;
     _write_offset = 0;
     _writebuf.clear();
+#if HAL_LOGGER_STAGING_ENABLED
+    discard_staging();
+#endif
     write_fd_semaphore.give();
 
     // now update lastlog.txt with the new log number
@@ -931,6 +1112,10 @@ void AP_Logger_File::io_timer(void)
         write_lastlog_file(log_num);
     }
 
+#if HAL_LOGGER_STAGING_ENABLED
+    drain_staging();
+#endif
+
     uint32_t nbytes = _writebuf.available();
     if (nbytes == 0) {
         return;
@@ -9,14 +9,30 @@
 #include <AP_Filesystem/AP_Filesystem.h>
 
 #include <AP_HAL/utility/RingBuffer.h>
+#include <AP_Vehicle/AP_Vehicle_Type.h>
 #include "AP_Logger_Backend.h"
 
 #if HAL_LOGGING_FILESYSTEM_ENABLED
 
+#include <atomic>
+
 #ifndef HAL_LOGGER_WRITE_CHUNK_SIZE
 #define HAL_LOGGER_WRITE_CHUNK_SIZE 4096
 #endif
 
+// per-thread staging rings for threads contending on the write buffer
+#ifndef HAL_LOGGER_STAGING_ENABLED
+#define HAL_LOGGER_STAGING_ENABLED ((HAL_MEM_CLASS >= HAL_MEM_CLASS_1000 || CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX) && !APM_BUILD_TYPE(APM_BUILD_Replay))
+#endif
+
+#ifndef HAL_LOGGER_STAGING_RINGS
+#define HAL_LOGGER_STAGING_RINGS 4
+#endif
+
+#ifndef HAL_LOGGER_STAGING_BUFSIZE
+#define HAL_LOGGER_STAGING_BUFSIZE 4096
+#endif
+
 class AP_Logger_File : public AP_Logger_Backend
 {
 public:
@@ -129,6 +145,46 @@ private:
 
     // semaphore mediates access to the ringbuffer
     HAL_Semaphore semaphore;
+
+    // copy a message into _writebuf, semaphore must be held
+    bool write_to_writebuf(const void *pBuffer, uint16_t size, bool is_critical);
+
+#if HAL_LOGGER_STAGING_ENABLED
+    /*
+      A thread which finds semaphore taken stages its non-critical
+      messages in a ring rather than wait, claiming a free ring if it
+      has none. Each ring has a single producer, its owner. The rings
+      are emptied into _writebuf with semaphore held, by the IO thread
+      or by the owner before it writes a message directly, so each
+      thread's messages stay in order. The owner releases its ring
+      when it next gets semaphore without waiting and the ring is
+      empty, so a ring is only held by a thread while it is contending.
+      Messages are stored with a leading length byte
+     */
+    struct staging_ring {
+        std::atomic<const void *> owner{nullptr};
+        ByteBuffer buf{0};
+        uint32_t staged;        // messages written to the ring
+        uint32_t dropped;       // messages dropped as the ring was full
+    } staging[HAL_LOGGER_STAGING_RINGS];
+
+    // semaphore waits, protected by semaphore and cleared when logged
+    struct {
+        uint32_t count;
+        uint32_t wait_us_sum;
+        uint32_t wait_us_max;
+    } contention;
+
+    // return the ring owned by the calling thread, claiming a free
+    // one if claim is true. nullptr if there is none
+    staging_ring *staging_ring_for_thread(bool claim);
+    bool stage_message(staging_ring &ring, const void *pBuffer, uint16_t size);
+    // move whole messages from ring to _writebuf, semaphore must be held
+    void drain_staging_ring(staging_ring &ring);
+    void drain_staging();
+    void discard_staging();
+    void Write_AP_Logger_Stats_Staging();
+#endif
     // write_fd_semaphore mediates access to write_fd so the frontend
     // can open/close files without causing the backend to write to a
     // bad fd
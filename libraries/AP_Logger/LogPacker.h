@@ -0,0 +1,120 @@
+/*
+  compile time packing of log messages.
+
+  A message format is given as a type F with a static constexpr
+  function F::str() returning the format string. The layout of the
+  message is then known at compile time, so packing the arguments is
+  a sequence of fixed offset copies with no parsing of the format and
+  no va_list. See AP_Logger::WriteFast() and LOGGER_WRITE_FAST()
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <AP_Common/float16.h>
+
+namespace LogPacker {
+
+// size of a field in bytes; zero if c is not a format character
+constexpr uint8_t field_size(char c)
+{
+    return (c == 'b' || c == 'B' || c == 'M') ? 1 :
+        (c == 'h' || c == 'H' || c == 'c' || c == 'C' || c == 'g') ? 2 :
+        (c == 'i' || c == 'I' || c == 'e' || c == 'E' || c == 'L' || c == 'f' || c == 'n') ? 4 :
+        (c == 'd' || c == 'q' || c == 'Q') ? 8 :
+        (c == 'N') ? 16 :
+        (c == 'Z' || c == 'a') ? 64 :
+        0;
+}
+
+// number of fields in fmt
+constexpr uint8_t num_fields(const char *fmt)
+{
+    return *fmt == 0 ? 0 : 1 + num_fields(fmt+1);
+}
+
+// true if every character of fmt is a format character
+constexpr bool valid(const char *fmt)
+{
+    return *fmt == 0 || (field_size(*fmt) != 0 && valid(fmt+1));
+}
+
+// length of the fields of fmt, not including the message header
+constexpr uint16_t payload_len(const char *fmt)
+{
+    return *fmt == 0 ? 0 : field_size(*fmt) + payload_len(fmt+1);
+}
+
+/*
+  packing of one field, by format character. The argument is
+  converted to the field type as va_arg does in
+  AP_Logger_Backend::Write()
+ */
+template <char C> struct field;
+
+#define LOG_PACKER_FIELD(c, type)                                        \
+    template <> struct field<c> {                                       \
+        static_assert(sizeof(type) == field_size(c), "field size mismatch"); \
+        static void pack(uint8_t *dst, type v) { memcpy(dst, &v, sizeof(v)); } \
+    }
+
+LOG_PACKER_FIELD('b', int8_t);
+LOG_PACKER_FIELD('B', uint8_t);
+LOG_PACKER_FIELD('M', uint8_t);
+LOG_PACKER_FIELD('h', int16_t);
+LOG_PACKER_FIELD('c', int16_t);
+LOG_PACKER_FIELD('H', uint16_t);
+LOG_PACKER_FIELD('C', uint16_t);
+LOG_PACKER_FIELD('i', int32_t);
+LOG_PACKER_FIELD('e', int32_t);
+LOG_PACKER_FIELD('L', int32_t);
+LOG_PACKER_FIELD('I', uint32_t);
+LOG_PACKER_FIELD('E', uint32_t);
+LOG_PACKER_FIELD('f', float);
+LOG_PACKER_FIELD('d', double);
+LOG_PACKER_FIELD('q', int64_t);
+LOG_PACKER_FIELD('Q', uint64_t);
+
+#undef LOG_PACKER_FIELD
+
+template <> struct field<'g'> {
+    static void pack(uint8_t *dst, float v) {
+        Float16_t tmp;
+        tmp.set(v);
+        memcpy(dst, &tmp, sizeof(tmp));
+    }
+};
+
+template <> struct field<'a'> {
+    static void pack(uint8_t *dst, const int16_t *v) {
+        memcpy(dst, v, field_size('a'));
+    }
+};
+
+// fixed length strings, zero padded
+template <uint8_t len> struct string_field {
+    static void pack(uint8_t *dst, const char *v) {
+        const uint8_t n = strnlen(v, len);
+        memcpy(dst, v, n);
+        memset(&dst[n], 0, len-n);
+    }
+};
+template <> struct field<'n'> : string_field<4> {};
+template <> struct field<'N'> : string_field<16> {};
+template <> struct field<'Z'> : string_field<64> {};
+
+// pack the fields of F::str() from index I onwards
+template <typename F, uint8_t I>
+inline void pack(uint8_t *)
+{
+}
+
+template <typename F, uint8_t I, typename T, typename... Rest>
+inline void pack(uint8_t *dst, T v, Rest... rest)
+{
+    field<F::str()[I]>::pack(dst, v);
+    pack<F, I+1>(dst + field_size(F::str()[I]), rest...);
+}
+
+}  // namespace LogPacker
@@ -226,6 +226,17 @@ struct PACKED log_DSF {
     uint32_t buf_space_avg;
 };
 
+struct PACKED log_DSTG {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t rings;
+    uint32_t staged;
+    uint32_t dropped;
+    uint32_t contended;
+    uint32_t wait_max;
+    uint32_t wait_avg;
+};
+
 struct PACKED log_Event {
     LOG_PACKET_HEADER;
     uint64_t time_us;
@@ -636,6 +647,13 @@ struct PACKED log_Scripting {
     uint32_t run_time;
     int32_t total_mem;
     int32_t run_mem;
+    uint32_t allocs;
+    int32_t peak_mem;
+    uint32_t instructions;
+    uint32_t alloc_bytes;
+    uint32_t gc_time;
+    uint8_t priority;
+    uint8_t suspended;
 };
 
 struct PACKED log_MotBatt {
@@ -769,6 +787,16 @@ struct PACKED log_VER {
 // @Field: FMx: Maximum free space in write buffer in last time period
 // @Field: FAv: Average free space in write buffer in last time period
 
+// @LoggerMessage: DSTG
+// @Description: Onboard logging per-thread staging statistics
+// @Field: TimeUS: Time since system startup
+// @Field: Rng: Number of staging rings held by threads contending for the write buffer
+// @Field: Stg: Number of messages written to staging rings
+// @Field: SDp: Number of messages dropped as a staging ring was full
+// @Field: Cnt: Number of writes which had to wait for the write buffer in last time period
+// @Field: WMx: Longest wait for the write buffer in last time period
+// @Field: WAv: Average wait for the write buffer in last time period
+
 // @LoggerMessage: ERR
 // @Description: Specifically coded error messages
 // @Field: TimeUS: Time since system startup
@@ -1159,6 +1187,13 @@ struct PACKED log_VER {
 // @Field: Runtime: run time
 // @Field: Total_mem: total memory usage of all scripts
 // @Field: Run_mem: run memory usage
+// @Field: Allocs: number of allocations made by the run
+// @Field: Peak_mem: highest total memory usage of all scripts during the run
+// @Field: Insn: virtual machine instructions used by the run so far
+// @Field: Alloc_b: bytes allocated by the run
+// @Field: GC_time: time spent collecting garbage after the run
+// @Field: Prio: script priority
+// @Field: Susp: 1 if the script's time slice ran out and it was suspended part way through the run
 
 // @LoggerMessage: VER
 // @Description: Ardupilot version
@@ -1277,6 +1312,8 @@ LOG_STRUCTURE_FROM_RPM \
 LOG_STRUCTURE_FROM_FENCE \
     { LOG_DF_FILE_STATS, sizeof(log_DSF), \
       "DSF", "QIHIIII", "TimeUS,Dp,Blk,Bytes,FMn,FMx,FAv", "s--b---", "F--0---" }, \
+    { LOG_DF_STAGING_STATS, sizeof(log_DSTG), \
+      "DSTG", "QBIIIII", "TimeUS,Rng,Stg,SDp,Cnt,WMx,WAv", "s----ss", "F----FF" }, \
     { LOG_RALLY_MSG, sizeof(log_Rally), \
       "RALY", "QBBLLhB", "TimeUS,Tot,Seq,Lat,Lng,Alt,Flags", "s--DUm-", "F--GGB-" },  \
     { LOG_MAV_MSG, sizeof(log_MAV),   \
@@ -1303,7 +1340,7 @@ LOG_STRUCTURE_FROM_VISUALODOM \
       "FILE",   "NIBZ",       "FileName,Offset,Length,Data", "----", "----" }, \
 LOG_STRUCTURE_FROM_AIS \
     { LOG_SCRIPTING_MSG, sizeof(log_Scripting), \
-      "SCR",   "QNIii", "TimeUS,Name,Runtime,Total_mem,Run_mem", "s#sbb", "F-F--", true }, \
+      "SCR",   "QNIiiIiIIIBB", "TimeUS,Name,Runtime,Total_mem,Run_mem,Allocs,Peak_mem,Insn,Alloc_b,GC_time,Prio,Susp", "s#sbb-b-bs--", "F-F------F--", true }, \
     { LOG_VER_MSG, sizeof(log_VER), \
       "VER",   "QBHBBBBIZHBB", "TimeUS,BT,BST,Maj,Min,Pat,FWT,GH,FWS,APJ,BU,FV", "s-----------", "F-----------", false }, \
     { LOG_MOTBATT_MSG, sizeof(log_MotBatt), \
@@ -1394,6 +1431,7 @@ enum LogMessages : uint8_t {
     LOG_RCOUT3_MSG,
     LOG_IDS_FROM_FENCE,
     LOG_IDS_FROM_HAL,
+    LOG_DF_STAGING_STATS,
 
     _LOG_LAST_MSG_
 };
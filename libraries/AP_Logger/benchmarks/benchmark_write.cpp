@@ -0,0 +1,79 @@
+/*
+  compare the per call cost of AP_Logger::Write() with
+  LOGGER_WRITE_FAST(), through the real front end and backend down to
+  a stub backend which keeps the last message.
+
+  Write() looks the name up in the log_write_fmts list under
+  log_write_fmts_sem, then the backend finds the format again by
+  message type and packs the va_list by parsing the format. The fast
+  path uses a cached handle and the compile time packer
+ */
+#include <AP_gbenchmark.h>
+
+#include <AP_Logger/tests/logger_test.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if HAL_LOGGING_ENABLED
+
+static AP_Logger_Test logger_test;
+
+// a typical PID style message
+static const char msg_name[] = "BPID";
+static const char msg_labels[] = "TimeUS,Tar,Act,Err,P,I,D,Flags";
+static const char msg_units[] = "s-------";
+static const char msg_mults[] = "F-------";
+
+/*
+  vehicles have a few dozen Write() message types once flying. Place
+  ours in the middle of the list
+ */
+static void setup_fmts()
+{
+    static bool done;
+    if (done) {
+        return;
+    }
+    done = true;
+
+    static char names[40][5];
+    for (uint8_t i = 0; i < ARRAY_SIZE(names); i++) {
+        if (i == ARRAY_SIZE(names)/2) {
+            AP::logger().Write(msg_name, msg_labels, msg_units, msg_mults, "QffffffB",
+                               AP_HAL::micros64(), 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, uint8_t(0));
+        }
+        hal.util->snprintf(names[i], sizeof(names[i]), "X%03u", unsigned(i));
+        AP::logger().Write(names[i], "TimeUS,V", "s-", "F-", "Qf", AP_HAL::micros64(), 0.0f);
+    }
+}
+
+static void BM_Write(benchmark::State& state)
+{
+    setup_fmts();
+    uint64_t t = 0;
+    float v = 0.1f;
+
+    while (state.KeepRunning()) {
+        AP::logger().Write(msg_name, msg_labels, msg_units, msg_mults, "QffffffB",
+                           t++, v, v, v, v, v, v, uint8_t(1));
+    }
+}
+
+static void BM_WriteFast(benchmark::State& state)
+{
+    setup_fmts();
+    uint64_t t = 0;
+    float v = 0.1f;
+
+    while (state.KeepRunning()) {
+        LOGGER_WRITE_FAST(msg_name, msg_labels, msg_units, msg_mults, "QffffffB",
+                          t++, v, v, v, v, v, v, uint8_t(1));
+    }
+}
+
+BENCHMARK(BM_Write);
+BENCHMARK(BM_WriteFast);
+
+#endif  // HAL_LOGGING_ENABLED
+
+BENCHMARK_MAIN();
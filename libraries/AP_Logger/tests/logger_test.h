@@ -0,0 +1,95 @@
+/*
+  a logger front end with one backend that keeps the last message
+  written to it. Messages take the same path through AP_Logger and
+  AP_Logger_Backend as on the vehicle, up to the point a real backend
+  would queue them for storage
+ */
+#pragma once
+
+#include <AP_Logger/AP_Logger.h>
+
+#if HAL_LOGGING_ENABLED
+
+#include <AP_Logger/AP_Logger_Backend.h>
+#include <AP_Logger/LoggerMessageWriter.h>
+
+// a startup message writer which has nothing left to write
+class LoggerMessageWriter_Done : public LoggerMessageWriter_DFLogStart
+{
+public:
+    LoggerMessageWriter_Done() {
+        _finished = true;
+    }
+};
+
+class AP_Logger_Stub : public AP_Logger_Backend
+{
+public:
+    AP_Logger_Stub(AP_Logger &front, LoggerMessageWriter_DFLogStart *writer) :
+        AP_Logger_Backend(front, writer) {
+        _initialised = true;
+    }
+
+    bool CardInserted(void) const override { return true; }
+    void EraseAll() override {}
+    uint16_t find_last_log() override { return 0; }
+    void get_log_boundaries(uint16_t list_entry, uint32_t & start_page, uint32_t & end_page) override {}
+    void get_log_info(uint16_t list_entry, uint32_t &size, uint32_t &time_utc) override {}
+    int16_t get_log_data(uint16_t list_entry, uint16_t page, uint32_t offset, uint16_t len, uint8_t *data) override { return 0; }
+    void end_log_transfer() override {}
+    uint16_t get_num_logs() override { return 0; }
+    bool logging_started(void) const override { return true; }
+    void Init() override {}
+    uint32_t bufferspace_available() override { return UINT32_MAX; }
+    void stop_logging(void) override {}
+    bool logging_failed() const override { return false; }
+
+    // the last message written
+    uint8_t last[256];
+    uint16_t last_len;
+
+protected:
+    bool WritesOK() const override { return true; }
+    bool StartNewLogOK() const override { return false; }
+
+    bool _WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical) override {
+        memcpy(last, pBuffer, size);
+        last_len = size;
+        return true;
+    }
+};
+
+class AP_Logger_Test
+{
+public:
+    AP_Logger_Test() :
+        backend(logger, &writer)
+    {
+        static const struct LogStructure log_structure[] = {
+            { LOG_FORMAT_MSG, sizeof(log_Format),
+              "FMT", "BBnNZ",      "Type,Length,Name,Format,Columns", "-b---", "-----" },
+            { LOG_UNIT_MSG, sizeof(log_Unit),
+              "UNIT", "QbZ",      "TimeUS,Id,Label", "s--","F--" },
+            { LOG_FORMAT_UNITS_MSG, sizeof(log_Format_Units),
+              "FMTU", "QBNN",      "TimeUS,FmtType,UnitIds,MultIds","s---", "F---" },
+            { LOG_MULT_MSG, sizeof(log_Format_Multiplier),
+              "MULT", "Qbd",      "TimeUS,Id,Mult", "s--","F--" },
+        };
+        logger._structures = log_structure;
+        logger._num_types = ARRAY_SIZE(log_structure);
+        logger.backends[0] = &backend;
+        logger._next_backend = 1;
+        logger.set_force_log_disarmed(true);
+        logger.EnableWrites(true);
+    }
+
+    const uint8_t *last_message() const { return backend.last; }
+    uint16_t last_message_len() const { return backend.last_len; }
+
+private:
+    AP_Logger logger;
+    LoggerMessageWriter_Done writer;
+    AP_Logger_Stub backend;
+};
+
+#endif  // HAL_LOGGING_ENABLED
@@ -0,0 +1,135 @@
+/*
+  check that LOGGER_WRITE_FAST() writes the same bytes as
+  AP_Logger::Write(), whose arguments are packed from a va_list by
+  AP_Logger_Backend::Write()
+ */
+#include <AP_gtest.h>
+
+#include "logger_test.h"
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if HAL_LOGGING_ENABLED
+
+static AP_Logger_Test logger_test;
+
+// the message written by Write()
+static uint8_t expected[256];
+static uint16_t expected_len;
+
+static void save_expected()
+{
+    expected_len = logger_test.last_message_len();
+    memcpy(expected, logger_test.last_message(), expected_len);
+}
+
+#define EXPECT_SAME_MESSAGE()                                           \
+    do {                                                                \
+        ASSERT_EQ(expected_len, logger_test.last_message_len());        \
+        EXPECT_EQ(0, memcmp(expected, logger_test.last_message(), expected_len)); \
+    } while (0)
+
+TEST(LogPacker, Integers)
+{
+    static const char name[] = "TPK1";
+    static const char labels[] = "TimeUS,b,B,h,H,i,I,c,C,e,E,L,M,q";
+    static const char units[] = "s-------------";
+    static const char mults[] = "F-------------";
+    const uint64_t t = 0x0123456789abcdefULL;
+    const int8_t b = -100;
+    const uint8_t B = 200;
+    const int16_t h = -30000;
+    const uint16_t H = 60000;
+    const int32_t i = -2000000000;
+    const uint32_t I = 4000000000U;
+    const int64_t q = -0x0123456789abcdefLL;
+
+    AP::logger().Write(name, labels, units, mults, "QbBhHiIcCeELMq", t, b, B, h, H, i, I, h, H, i, I, i, B, q);
+    save_expected();
+    EXPECT_EQ(LOG_PACKET_HEADER_LEN + LogPacker::payload_len("QbBhHiIcCeELMq"), expected_len);
+
+    LOGGER_WRITE_FAST(name, labels, units, mults, "QbBhHiIcCeELMq", t, b, B, h, H, i, I, h, H, i, I, i, B, q);
+    EXPECT_SAME_MESSAGE();
+}
+
+TEST(LogPacker, Floats)
+{
+    static const char name[] = "TPK2";
+    static const char labels[] = "TimeUS,f,d,g,F";
+    static const char units[] = "s----";
+    static const char mults[] = "F----";
+    const uint64_t t = 1234;
+    const float f = -1.0e-3f;
+    const double d = 3.14159265358979;
+    const float g = 0.3333f;
+
+    AP::logger().Write(name, labels, units, mults, "Qfdgf", t, f, d, g, 1.0e30f);
+    save_expected();
+
+    LOGGER_WRITE_FAST(name, labels, units, mults, "Qfdgf", t, f, d, g, 1.0e30f);
+    EXPECT_SAME_MESSAGE();
+}
+
+TEST(LogPacker, Arguments)
+{
+    // arguments of other types are converted as va_arg converts them
+    static const char name[] = "TPK3";
+    static const char labels[] = "TimeUS,B,H,f,i";
+    static const char units[] = "s----";
+    static const char mults[] = "F----";
+    const uint64_t t = 1234;
+    const int B = 300;
+    const uint8_t H = 7;
+    const double f = 1.0/3.0;
+    const int16_t i = -5;
+
+    AP::logger().Write(name, labels, units, mults, "QBHfi", t, B, H, f, int32_t(i));
+    save_expected();
+
+    LOGGER_WRITE_FAST(name, labels, units, mults, "QBHfi", t, B, H, f, i);
+    EXPECT_SAME_MESSAGE();
+}
+
+TEST(LogPacker, Strings)
+{
+    static const char name[] = "TPK4";
+    static const char labels[] = "TimeUS,a,n,N,Z,n2";
+    static const char units[] = "s-----";
+    static const char mults[] = "F-----";
+    const uint64_t t = 1234;
+    int16_t a[32];
+    for (uint8_t i = 0; i < ARRAY_SIZE(a); i++) {
+        a[i] = i * 1000 - 16000;
+    }
+    // strings shorter than, and as long as or longer than their field
+    const char *n = "ab";
+    const char *N = "0123456789abcdefXYZ";
+    const char *Z = "a string of some length";
+    const char *n2 = "abcd";
+
+    AP::logger().Write(name, labels, units, mults, "QanNZn", t, a, n, N, Z, n2);
+    save_expected();
+
+    LOGGER_WRITE_FAST(name, labels, units, mults, "QanNZn", t, a, n, N, Z, n2);
+    EXPECT_SAME_MESSAGE();
+}
+
+TEST(LogPacker, Streaming)
+{
+    static const char name[] = "TPK5";
+    static const char labels[] = "TimeUS,I,V";
+    static const char units[] = "s#-";
+    static const char mults[] = "F--";
+
+    for (uint8_t instance = 0; instance < 3; instance++) {
+        AP::logger().WriteStreaming(name, labels, units, mults, "QBf", uint64_t(instance), instance, instance * 0.5f);
+        save_expected();
+
+        LOGGER_WRITE_STREAMING_FAST(name, labels, units, mults, "QBf", uint64_t(instance), instance, instance * 0.5f);
+        EXPECT_SAME_MESSAGE();
+    }
+}
+
+#endif  // HAL_LOGGING_ENABLED
+
+AP_GTEST_MAIN()
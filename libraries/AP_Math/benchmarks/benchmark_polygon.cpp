@@ -0,0 +1,73 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/tests/random_test.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  a jagged fence of roughly 10km radius. The argument is the number of
+  points, up to 255 as that is the most a stored fence polygon can have
+ */
+static void make_fence(Vector2l *fence, uint16_t n)
+{
+    TestRandom rng{0x12345678};
+    make_test_polygon(rng, Vector2l{-353632620, 1491652300}, 1050000, 0.95f, n, false, fence);
+    fence[n] = fence[0];
+}
+
+static const Vector2l test_points[] = {
+    Vector2l(-353632620, 1491652300),
+    Vector2l(-353632620 + 990000, 1491652300),
+    Vector2l(-353632620, 1491652300 - 1020000),
+    Vector2l(-353632620 + 700000, 1491652300 + 700000),
+};
+
+static void BM_PolygonOutside(benchmark::State& state)
+{
+    const uint16_t fence_points = state.range(0);
+    Vector2l fence[UINT8_MAX+1];
+    make_fence(fence, fence_points);
+    uint8_t i = 0;
+
+    while (state.KeepRunning()) {
+        bool outside = Polygon_outside(test_points[i++ % ARRAY_SIZE(test_points)], fence, fence_points+1);
+        gbenchmark_escape(&outside);
+    }
+}
+
+static void BM_PolygonIndexOutside(benchmark::State& state)
+{
+    const uint16_t fence_points = state.range(0);
+    Vector2l fence[UINT8_MAX+1];
+    make_fence(fence, fence_points);
+    PolygonIndex<int32_t> index;
+    if (!index.init(fence, fence_points+1)) {
+        state.SkipWithError("index allocation failed");
+    }
+    uint8_t i = 0;
+
+    while (state.KeepRunning()) {
+        bool outside = index.outside(test_points[i++ % ARRAY_SIZE(test_points)]);
+        gbenchmark_escape(&outside);
+    }
+}
+
+static void BM_PolygonIndexBuild(benchmark::State& state)
+{
+    const uint16_t fence_points = state.range(0);
+    Vector2l fence[UINT8_MAX+1];
+    make_fence(fence, fence_points);
+
+    while (state.KeepRunning()) {
+        PolygonIndex<int32_t> index;
+        bool ok = index.init(fence, fence_points+1);
+        gbenchmark_escape(&ok);
+    }
+}
+
+BENCHMARK(BM_PolygonOutside)->Arg(16)->Arg(64)->Arg(UINT8_MAX);
+BENCHMARK(BM_PolygonIndexOutside)->Arg(16)->Arg(64)->Arg(UINT8_MAX);
+BENCHMARK(BM_PolygonIndexBuild)->Arg(16)->Arg(64)->Arg(UINT8_MAX);
+
+BENCHMARK_MAIN();
@@ -26,6 +26,50 @@
  */
 
 
+/*
+ *  Polygon_edge_crossed(): returns true if a ray cast from P crosses
+ *  the edge from Vi to Vj.  Each crossing toggles the inside/outside
+ *  state of P
+ */
+template <typename T>
+static inline bool Polygon_edge_crossed(const Vector2<T> &P, const Vector2<T> &Vi, const Vector2<T> &Vj)
+{
+    if ((Vi.y > P.y) == (Vj.y > P.y)) {
+        return false;
+    }
+    const T dx1 = P.x - Vi.x;
+    const T dx2 = Vj.x - Vi.x;
+    const T dy1 = P.y - Vi.y;
+    const T dy2 = Vj.y - Vi.y;
+    const int8_t dx1s = (dx1 < 0) ? -1 : 1;
+    const int8_t dx2s = (dx2 < 0) ? -1 : 1;
+    const int8_t dy1s = (dy1 < 0) ? -1 : 1;
+    const int8_t dy2s = (dy2 < 0) ? -1 : 1;
+    const int8_t m1 = dx1s * dy2s;
+    const int8_t m2 = dx2s * dy1s;
+    // we avoid the 64 bit multiplies if we can based on sign checks.
+    if (dy2 < 0) {
+        if (m1 > m2) {
+            return true;
+        } else if (m1 < m2) {
+            return false;
+        }
+        if (std::is_floating_point<T>::value) {
+            return dx1 * dy2 > dx2 * dy1;
+        }
+        return dx1 * (int64_t)dy2 > dx2 * (int64_t)dy1;
+    }
+    if (m1 < m2) {
+        return true;
+    } else if (m1 > m2) {
+        return false;
+    }
+    if (std::is_floating_point<T>::value) {
+        return dx1 * dy2 < dx2 * dy1;
+    }
+    return dx1 * (int64_t)dy2 < dx2 * (int64_t)dy1;
+}
+
 /*
  *  Polygon_outside(): test for a point in a polygon
  *     Input:   P = a point,
@@ -54,52 +98,8 @@ bool Polygon_outside(const Vector2<T> &P, const Vector2<T> *V, unsigned n)
         if (j >= n) {
             j = 0;
         }
-        if ((V[i].y > P.y) == (V[j].y > P.y)) {
-            continue;
-        }
-        const T dx1 = P.x - V[i].x;
-        const T dx2 = V[j].x - V[i].x;
-        const T dy1 = P.y - V[i].y;
-        const T dy2 = V[j].y - V[i].y;
-        const int8_t dx1s = (dx1 < 0) ? -1 : 1;
-        const int8_t dx2s = (dx2 < 0) ? -1 : 1;
-        const int8_t dy1s = (dy1 < 0) ? -1 : 1;
-        const int8_t dy2s = (dy2 < 0) ? -1 : 1;
-        const int8_t m1 = dx1s * dy2s;
-        const int8_t m2 = dx2s * dy1s;
-        // we avoid the 64 bit multiplies if we can based on sign checks.
-        if (dy2 < 0) {
-            if (m1 > m2) {
-                outside = !outside;
-            } else if (m1 < m2) {
-                continue;
-            } else {
-                if (std::is_floating_point<T>::value) {
-                    if ( dx1 * dy2 > dx2 * dy1 ) {
-                        outside = !outside;
-                    }
-                } else {
-                    if ( dx1 * (int64_t)dy2 > dx2 * (int64_t)dy1 ) {
-                        outside = !outside;
-                    }
-                }
-            }
-        } else {
-            if (m1 < m2) {
-                outside = !outside;
-            } else if (m1 > m2) {
-                continue;
-            } else {
-                if (std::is_floating_point<T>::value) {
-                    if ( dx1 * dy2 < dx2 * dy1 ) {
-                        outside = !outside;
-                    }
-                } else {
-                    if ( dx1 * (int64_t)dy2 < dx2 * (int64_t)dy1 ) {
-                        outside = !outside;
-                    }
-                }
-            }
+        if (Polygon_edge_crossed(P, V[i], V[j])) {
+            outside = !outside;
         }
     }
     return outside;
@@ -124,6 +124,166 @@ template bool Polygon_complete<int32_t>(const Vector2l *V, unsigned n);
 template bool Polygon_outside<float>(const Vector2f &P, const Vector2f *V, unsigned n);
 template bool Polygon_complete<float>(const Vector2f *V, unsigned n);
 
+/*
+  build the band index over the edges of polygon V
+ */
+template <typename T>
+bool PolygonIndex<T>::init(const Vector2<T> *V, unsigned n)
+{
+    clear();
+
+    if (Polygon_complete(V, n)) {
+        n--;
+    }
+    if (n > UINT16_MAX) {
+        return false;
+    }
+    _V = V;
+    _n = n;
+    if (n < 3) {
+        return false;
+    }
+
+    _min = V[0];
+    _max = V[0];
+    for (uint16_t i=1; i<_n; i++) {
+        _min.x = MIN(_min.x, V[i].x);
+        _min.y = MIN(_min.y, V[i].y);
+        _max.x = MAX(_max.x, V[i].x);
+        _max.y = MAX(_max.y, V[i].y);
+    }
+
+    // aim for about one band per edge, reducing the number of bands
+    // if long edges would make the index much larger than the polygon
+    const float range = float(_max.y) - float(_min.y);
+    uint32_t total;
+    _num_bands = _n;
+    while (true) {
+        _band_scale = is_positive(range) ? _num_bands / range : 0;
+        total = populate_bands(nullptr, nullptr);
+        if (total <= 4U * _n || _num_bands == 1) {
+            break;
+        }
+        _num_bands = MAX(_num_bands / 2, 1);
+    }
+
+    _band_start = NEW_NOTHROW uint32_t[_num_bands+1];
+    _band_edges = NEW_NOTHROW uint16_t[total];
+    if (_band_start == nullptr || _band_edges == nullptr) {
+        // leave _V and _n set so queries fall back to Polygon_outside()
+        delete[] _band_start;
+        _band_start = nullptr;
+        delete[] _band_edges;
+        _band_edges = nullptr;
+        return false;
+    }
+    populate_bands(_band_start, _band_edges);
+
+    return true;
+}
+
+template <typename T>
+void PolygonIndex<T>::clear()
+{
+    delete[] _band_start;
+    _band_start = nullptr;
+    delete[] _band_edges;
+    _band_edges = nullptr;
+    _V = nullptr;
+    _n = 0;
+}
+
+/*
+  return the band containing y.  This is monotonic in y, so an edge
+  spanning y1..y2 is always found in the bands band_for(y1)..band_for(y2)
+ */
+template <typename T>
+uint16_t PolygonIndex<T>::band_for(T y) const
+{
+    const float b = (float(y) - float(_min.y)) * _band_scale;
+    if (b <= 0) {
+        return 0;
+    }
+    if (b >= _num_bands - 1) {
+        return _num_bands - 1;
+    }
+    return uint16_t(b);
+}
+
+template <typename T>
+uint32_t PolygonIndex<T>::populate_bands(uint32_t *band_start, uint16_t *band_edges) const
+{
+    uint32_t total = 0;
+    if (band_start != nullptr) {
+        memset(band_start, 0, (_num_bands+1)*sizeof(band_start[0]));
+    }
+    for (uint16_t i=0; i<_n; i++) {
+        const uint16_t j = (i+1 >= _n) ? 0 : i+1;
+        const uint16_t lo = band_for(MIN(_V[i].y, _V[j].y));
+        const uint16_t hi = band_for(MAX(_V[i].y, _V[j].y));
+        total += hi - lo + 1;
+        if (band_start != nullptr) {
+            for (uint16_t b=lo; b<=hi; b++) {
+                band_start[b+1]++;
+            }
+        }
+    }
+    if (band_start == nullptr) {
+        return total;
+    }
+
+    // convert counts to offsets, then fill in each band using
+    // band_start[] as the insertion point
+    for (uint16_t b=0; b<_num_bands; b++) {
+        band_start[b+1] += band_start[b];
+    }
+    for (uint16_t i=0; i<_n; i++) {
+        const uint16_t j = (i+1 >= _n) ? 0 : i+1;
+        const uint16_t lo = band_for(MIN(_V[i].y, _V[j].y));
+        const uint16_t hi = band_for(MAX(_V[i].y, _V[j].y));
+        for (uint16_t b=lo; b<=hi; b++) {
+            band_edges[band_start[b]++] = i;
+        }
+    }
+    // each insertion point now holds the start of the following
+    // band; shift them back into place
+    for (uint16_t b=_num_bands; b>0; b--) {
+        band_start[b] = band_start[b-1];
+    }
+    band_start[0] = 0;
+
+    return total;
+}
+
+/*
+  returns true if P is outside the indexed polygon.  Only edges in
+  the band containing P need to be checked for crossings
+ */
+template <typename T>
+bool PolygonIndex<T>::outside(const Vector2<T> &P) const
+{
+    if (!valid()) {
+        return Polygon_outside(P, _V, _n);
+    }
+    if (P.x < _min.x || P.x > _max.x ||
+        P.y < _min.y || P.y > _max.y) {
+        return true;
+    }
+    const uint16_t b = band_for(P.y);
+    bool outside = true;
+    for (uint32_t k=_band_start[b]; k<_band_start[b+1]; k++) {
+        const uint16_t i = _band_edges[k];
+        const uint16_t j = (i+1 >= _n) ? 0 : i+1;
+        if (Polygon_edge_crossed(P, _V[i], _V[j])) {
+            outside = !outside;
+        }
+    }
+    return outside;
+}
+
+template class PolygonIndex<int32_t>;
+template class PolygonIndex<float>;
+
 
 /*
   determine if the polygon of N verticies defined by points V is
@@ -24,6 +24,59 @@ bool        Polygon_outside(const Vector2<T> &P, const Vector2<T> *V, unsigned n
 template <typename T>
 bool        Polygon_complete(const Vector2<T> *V, unsigned n) WARN_IF_UNUSED;
 
+/*
+  PolygonIndex - a spatial index over the edges of a polygon allowing
+  Polygon_outside() queries in near-constant time for polygons with
+  many vertices.
+
+  The polygon's extent in y is split into bands, and each band holds
+  the list of edges which span it.  A query only examines the edges
+  in the band containing the point, after a bounding-box check.  The
+  result is identical to Polygon_outside() on the same vertices.
+
+  The index references (but does not copy) the vertex array, which
+  must outlive the index.  If the index could not be allocated then
+  queries fall back to Polygon_outside().
+ */
+template <typename T>
+class PolygonIndex {
+public:
+    PolygonIndex() {}
+    ~PolygonIndex() { clear(); }
+
+    CLASS_NO_COPY(PolygonIndex);
+
+    // build the index over n vertices in V.  Returns false if
+    // memory for the index could not be allocated
+    bool init(const Vector2<T> *V, unsigned n) WARN_IF_UNUSED;
+
+    // release memory used by the index
+    void clear();
+
+    // returns true if P is outside the indexed polygon
+    bool outside(const Vector2<T> &P) const WARN_IF_UNUSED;
+
+    // true if init() succeeded
+    bool valid() const { return _band_edges != nullptr; }
+
+private:
+    // return the band which contains the y coordinate y
+    uint16_t band_for(T y) const;
+
+    // returns the total number of band memberships of all edges.
+    // If band_start and band_edges are supplied they are filled in
+    uint32_t populate_bands(uint32_t *band_start, uint16_t *band_edges) const;
+
+    const Vector2<T> *_V = nullptr;
+    uint16_t _n = 0;        // number of edges (vertices less any closing point)
+    Vector2<T> _min;        // bounding box of the polygon
+    Vector2<T> _max;
+    uint16_t _num_bands;
+    float _band_scale;      // bands per unit of y
+    uint32_t *_band_start = nullptr;  // _num_bands+1 offsets into _band_edges
+    uint16_t *_band_edges = nullptr;  // index of first vertex of each edge in each band
+};
+
 /*
   determine if the polygon of N verticies defined by points V is
   intersected by a line from point p1 to point p2
@@ -0,0 +1,49 @@
+/*
+  deterministic pseudo-random values for tests and benchmarks, so a
+  failure can be reproduced from the seed
+ */
+#pragma once
+
+#include <AP_Math/AP_Math.h>
+
+class TestRandom
+{
+public:
+    // seed must not be zero
+    explicit TestRandom(uint32_t seed) :
+        state(seed)
+    {}
+
+    // xorshift32
+    uint32_t next()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // random float in the range [lo, hi)
+    float next_float(float lo, float hi)
+    {
+        return lo + (hi - lo) * ((next() >> 8) * (1.0f / 16777216.0f));
+    }
+
+private:
+    uint32_t state;
+};
+
+/*
+  fill V with a jagged polygon of n points around centre, each between
+  min_ratio * radius and radius from it. If shuffle is true the points
+  are at random angles, so the polygon crosses itself
+ */
+template <typename T>
+void make_test_polygon(TestRandom &rng, const Vector2<T> &centre, float radius, float min_ratio, uint16_t n, bool shuffle, Vector2<T> *V)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        const float angle = shuffle ? rng.next_float(0, M_2PI) : i * M_2PI / n;
+        const float r = radius * rng.next_float(min_ratio, 1.0f);
+        V[i] = Vector2<T>{centre.x + T(cosf(angle) * r), centre.y + T(sinf(angle) * r)};
+    }
+}
@@ -3,6 +3,8 @@
 
 #include <AP_Math/AP_Math.h>
 
+#include "random_test.h"
+
 struct PB {
     Vector2f point;
     Vector2f boundary[3];
@@ -248,6 +250,12 @@ TEST(Polygon, outside_long_closed_equal_to_unclosed)
                       Polygon_outside(TEST_POINTS[i].point,             \
                                       POLYGON, ARRAY_SIZE(POLYGON)));   \
         }                                                               \
+        PolygonIndex<std::remove_cv<std::remove_reference<decltype(POLYGON[0].x)>::type>::type> index; \
+        EXPECT_TRUE(index.init(POLYGON, ARRAY_SIZE(POLYGON)));          \
+        for (uint32_t i = 0; i < ARRAY_SIZE(TEST_POINTS); i++) {        \
+            EXPECT_EQ(TEST_POINTS[i].outside,                           \
+                      index.outside(TEST_POINTS[i].point));             \
+        }                                                               \
     } while(0)
 
 // this OBC polygon test stolen from the polygon Math example
@@ -356,6 +364,63 @@ TEST(Polygon, simple)
     TEST_POLYGON_POINTS(SIMPLE_boundary, SIMPLE_test_points);
 }
 
+TEST(Polygon, index_matches_outside_long)
+{
+    // a jagged star-shaped fence around Canberra with the most points
+    // a stored fence polygon can have
+    const uint16_t n = UINT8_MAX;
+    const Vector2l centre {-353632620, 1491652300};
+    Vector2l poly[n+1];
+    TestRandom rng{0x12345678};
+    make_test_polygon(rng, centre, 1500000, 0.67f, n, false, poly);
+    poly[n] = poly[0];
+
+    PolygonIndex<int32_t> index;
+    EXPECT_TRUE(index.init(poly, n+1));
+    for (uint32_t i=0; i<20000; i++) {
+        Vector2l point {
+            int32_t(centre.x - 2000000 + rng.next() % 4000000),
+            int32_t(centre.y - 2000000 + rng.next() % 4000000)
+        };
+        if (i % 10 == 0) {
+            // vertices are the most likely place for differences
+            point = poly[rng.next() % n];
+        }
+        EXPECT_EQ(Polygon_outside(point, poly, n+1), index.outside(point));
+    }
+}
+
+TEST(Polygon, index_matches_outside_float)
+{
+    // self-intersecting polygons with random vertices
+    TestRandom rng{0x87654321};
+    for (uint8_t trial=0; trial<50; trial++) {
+        const uint16_t n = 3 + rng.next() % (UINT8_MAX - 2);
+        Vector2f poly[UINT8_MAX];
+        for (uint16_t i=0; i<n; i++) {
+            poly[i].x = int32_t(rng.next() % 1000) - 500;
+            poly[i].y = int32_t(rng.next() % 1000) - 500;
+        }
+        PolygonIndex<float> index;
+        EXPECT_TRUE(index.init(poly, n));
+        for (uint16_t i=0; i<1000; i++) {
+            const Vector2f point {
+                int32_t(rng.next() % 1200) - 600 + 0.5f,
+                float(int32_t(rng.next() % 1200) - 600)
+            };
+            EXPECT_EQ(Polygon_outside(point, poly, n), index.outside(point));
+        }
+    }
+}
+
+TEST(Polygon, index_uninitialised)
+{
+    // an index which has not been built treats everything as outside
+    PolygonIndex<float> index;
+    EXPECT_FALSE(index.valid());
+    EXPECT_TRUE(index.outside(Vector2f{0.0f, 0.0f}));
+}
+
 AP_GTEST_MAIN()
 
 
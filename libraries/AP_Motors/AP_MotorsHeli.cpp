@@ -18,6 +18,7 @@
 #include "AP_MotorsHeli.h"
 #include <GCS_MAVLink/GCS.h>
 #include <AP_Logger/AP_Logger.h>
+#include <AP_Trace/AP_Trace.h>
 
 extern const AP_HAL::HAL& hal;
 
@@ -221,6 +222,7 @@ void AP_MotorsHeli::output()
 
     output_to_motors();
 
+    AP_TRACE(MOTORS_OUTPUT);
 };
 
 // sends commands to the motors
@@ -106,6 +106,7 @@ bool AP_MotorsMatrix::set_throttle_factor(int8_t motor_num, float throttle_facto
     }
 
     _throttle_factor[motor_num] = throttle_factor;
+    mix_changed();
     return true;
 }
 
@@ -222,7 +223,7 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     const float pitch_thrust = (_pitch_in + _pitch_in_ff) * compensation_gain;
 
     // yaw thrust input value, +/- 1.0
-    float yaw_thrust = (_yaw_in + _yaw_in_ff) * compensation_gain;
+    const float yaw_thrust = (_yaw_in + _yaw_in_ff) * compensation_gain;
 
     // throttle thrust input value, 0.0 - 1.0
     float throttle_thrust = get_throttle() * compensation_gain;
@@ -247,9 +248,7 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     throttle_avg_max = constrain_float(throttle_avg_max, throttle_thrust, throttle_thrust_max);
 
     // throttle providing maximum roll, pitch and yaw range
-    // calculate the highest allowed average thrust that will provide maximum control range
-    float throttle_thrust_best_rpy = MIN(0.5f, throttle_avg_max);
-
+    // the mixer starts from the highest allowed average thrust that will provide maximum control range
     // calculate throttle that gives most possible room for yaw which is the lower of:
     //      1. 0.5f - (rpy_low+rpy_high)/2.0 - this would give the maximum possible margin above the highest motor and below the lowest
     //      2. the higher of:
@@ -271,32 +270,6 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     // Octo-Quad (x8) + : MOT_YAW_HEADROOM = 300, ATC_RAT_RLL_IMAX = 0.5,   ATC_RAT_PIT_IMAX = 0.5,   ATC_RAT_YAW_IMAX = 0.25
     // Quads cannot make use of motor loss handling because it doesn't have enough degrees of freedom.
 
-    // calculate amount of yaw we can fit into the throttle range
-    // this is always equal to or less than the requested yaw from the pilot or rate controller
-    float yaw_allowed = 1.0f; // amount of yaw we can fit in
-    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            // calculate the thrust outputs for roll and pitch
-            _thrust_rpyt_out[i] = roll_thrust * _roll_factor[i] + pitch_thrust * _pitch_factor[i];
-
-            // Check the maximum yaw control that can be used on this channel
-            // Exclude any lost motors if thrust boost is enabled
-            if (!is_zero(_yaw_factor[i]) && (!_thrust_boost || i != _motor_lost_index)) {
-                const float thrust_rp_best_throttle = throttle_thrust_best_rpy + _thrust_rpyt_out[i];
-                float motor_room;
-                if (is_positive(yaw_thrust * _yaw_factor[i])) {
-                    // room to upper limit
-                    motor_room = 1.0 - thrust_rp_best_throttle;
-                } else {
-                    // room to lower limit
-                    motor_room = thrust_rp_best_throttle;
-                }
-                const float motor_yaw_allowed = MAX(motor_room, 0.0)/fabsf(_yaw_factor[i]);
-                yaw_allowed = MIN(yaw_allowed, motor_yaw_allowed);
-            }
-        }
-    }
-
     // calculate the maximum yaw control that can be used
     // todo: make _yaw_headroom 0 to 1
     float yaw_allowed_min = (float)_yaw_headroom * 0.001f;
@@ -304,97 +277,37 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     // increase yaw headroom to 50% if thrust boost enabled
     yaw_allowed_min = boost_ratio(0.5, yaw_allowed_min);
 
-    // Let yaw access minimum amount of head room
-    yaw_allowed = MAX(yaw_allowed, yaw_allowed_min);
-
-    // Include the lost motor scaled by _thrust_boost_ratio to smoothly transition this motor in and out of the calculation
-    if (_thrust_boost && motor_enabled[_motor_lost_index]) {
-        // Check the maximum yaw control that can be used on this channel
-        // Exclude any lost motors if thrust boost is enabled
-        if (!is_zero(_yaw_factor[_motor_lost_index])){
-            const float thrust_rp_best_throttle = throttle_thrust_best_rpy + _thrust_rpyt_out[_motor_lost_index];
-            float motor_room;
-            if (is_positive(yaw_thrust * _yaw_factor[_motor_lost_index])) {
-                motor_room = 1.0 - thrust_rp_best_throttle;
-            } else {
-                motor_room = thrust_rp_best_throttle;
-            }
-            const float motor_yaw_allowed = MAX(motor_room, 0.0)/fabsf(_yaw_factor[_motor_lost_index]);
-            yaw_allowed = boost_ratio(yaw_allowed, MIN(yaw_allowed, motor_yaw_allowed));
-        }
-    }
-
-    if (fabsf(yaw_thrust) > yaw_allowed) {
-        // not all commanded yaw can be used
-        yaw_thrust = constrain_float(yaw_thrust, -yaw_allowed, yaw_allowed);
-        limit.yaw = true;
-    }
-
-    // add yaw control to thrust outputs
-    float rpy_low = 1.0f;   // lowest thrust value
-    float rpy_high = -1.0f; // highest thrust value
-    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            _thrust_rpyt_out[i] = _thrust_rpyt_out[i] + yaw_thrust * _yaw_factor[i];
-
-            // record lowest roll + pitch + yaw command
-            if (_thrust_rpyt_out[i] < rpy_low) {
-                rpy_low = _thrust_rpyt_out[i];
-            }
-            // record highest roll + pitch + yaw command
-            // Exclude any lost motors if thrust boost is enabled
-            if (_thrust_rpyt_out[i] > rpy_high && (!_thrust_boost || i != _motor_lost_index)) {
-                rpy_high = _thrust_rpyt_out[i];
-            }
-        }
-    }
-    // Include the lost motor scaled by _thrust_boost_ratio to smoothly transition this motor in and out of the calculation
-    if (_thrust_boost) {
-        // record highest roll + pitch + yaw command
-        if (_thrust_rpyt_out[_motor_lost_index] > rpy_high && motor_enabled[_motor_lost_index]) {
-            rpy_high = boost_ratio(rpy_high, _thrust_rpyt_out[_motor_lost_index]);
-        }
-    }
-
-    // calculate any scaling needed to make the combined thrust outputs fit within the output range
-    float rpy_scale = 1.0f;
-    if (rpy_high - rpy_low > 1.0f) {
-        rpy_scale = 1.0f / (rpy_high - rpy_low);
-    }
-    if (throttle_avg_max + rpy_low < 0) {
-        rpy_scale = MIN(rpy_scale, -throttle_avg_max / rpy_low);
-    }
-
-    // calculate how close the motors can come to the desired throttle
-    rpy_high *= rpy_scale;
-    rpy_low *= rpy_scale;
-    throttle_thrust_best_rpy = -rpy_low;
-    float thr_adj = throttle_thrust - throttle_thrust_best_rpy;
-    if (rpy_scale < 1.0f) {
+    // repack the factors of the enabled motors if the frame has changed
+    if (_mix_changed) {
+        _mix_changed = false;
+        _mix.pack(motor_enabled, _roll_factor, _pitch_factor, _yaw_factor, _throttle_factor);
+    }
+
+    // fit roll, pitch and yaw into the throttle range and add scaled
+    // roll, pitch, constrained yaw and throttle for each motor
+    const AP_MotorsMatrix_Mix::Input mix_in {
+        roll_thrust,
+        pitch_thrust,
+        yaw_thrust,
+        throttle_thrust,
+        throttle_avg_max,
+        yaw_allowed_min,
+        _thrust_boost,
+        _thrust_boost_ratio,
+        _motor_lost_index,
+    };
+    AP_MotorsMatrix_Mix::Limits mix_limits {};
+    const float throttle_thrust_best_plus_adj = _mix.mix(mix_in, _thrust_rpyt_out, mix_limits);
+    if (mix_limits.rpy) {
         // Full range is being used by roll, pitch, and yaw.
         limit.roll = true;
         limit.pitch = true;
+    }
+    if (mix_limits.yaw) {
         limit.yaw = true;
-        if (thr_adj > 0.0f) {
-            limit.throttle_upper = true;
-        }
-        thr_adj = 0.0f;
-    } else if (thr_adj < 0.0f) {
-        // Throttle can't be reduced to desired value
-        // todo: add lower limit flag and ensure it is handled correctly in altitude controller
-        thr_adj = 0.0f;
-    } else if (thr_adj > 1.0f - (throttle_thrust_best_rpy + rpy_high)) {
-        // Throttle can't be increased to desired value
-        thr_adj = 1.0f - (throttle_thrust_best_rpy + rpy_high);
-        limit.throttle_upper = true;
     }
-
-    // add scaled roll, pitch, constrained yaw and throttle for each motor
-    const float throttle_thrust_best_plus_adj = throttle_thrust_best_rpy + thr_adj;
-    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            _thrust_rpyt_out[i] = (throttle_thrust_best_plus_adj * _throttle_factor[i]) + (rpy_scale * _thrust_rpyt_out[i]);
-        }
+    if (mix_limits.throttle_upper) {
+        limit.throttle_upper = true;
     }
 
     // determine throttle thrust for harmonic notch
@@ -521,6 +434,8 @@ void AP_MotorsMatrix::add_motor_raw(int8_t motor_num, float roll_fac, float pitc
         // set order that motor appears in test
         _test_order[motor_num] = testing_order;
 
+        mix_changed();
+
         // call parent class method
         add_motor_num(motor_num);
     }
@@ -554,6 +469,7 @@ void AP_MotorsMatrix::remove_motor(int8_t motor_num)
         _pitch_factor[motor_num] = 0.0f;
         _yaw_factor[motor_num] = 0.0f;
         _throttle_factor[motor_num] = 0.0f;
+        mix_changed();
     }
 }
 
@@ -1338,6 +1254,7 @@ void AP_MotorsMatrix::normalise_rpy_factors()
             }
         }
     }
+    mix_changed();
 }
 
 
@@ -1362,6 +1279,7 @@ void AP_MotorsMatrix::disable_yaw_torque(void)
     for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
         _yaw_factor[i] = 0;
     }
+    mix_changed();
 }
 
 #if APM_BUILD_TYPE(APM_BUILD_UNKNOWN)
@@ -6,6 +6,7 @@
 #include <AP_Math/AP_Math.h>        // ArduPilot Mega Vector/Matrix math Library
 #include <RC_Channel/RC_Channel.h>     // RC Channel Library
 #include "AP_MotorsMulticopter.h"
+#include "AP_MotorsMatrix_Mix.h"
 
 #define AP_MOTORS_MATRIX_YAW_FACTOR_CW   -1
 #define AP_MOTORS_MATRIX_YAW_FACTOR_CCW   1
@@ -127,6 +128,9 @@ protected:
     // normalizes the roll, pitch and yaw factors so maximum magnitude is 0.5
     void                normalise_rpy_factors();
 
+    // repack the mixer factors on the next output, call after changing motor_enabled or the factors
+    void                mix_changed() { _mix_changed = true; }
+
     // call vehicle supplied thrust compensation if set
     void                thrust_compensation(void) override;
 
@@ -157,6 +161,9 @@ protected:
 
 private:
 
+    AP_MotorsMatrix_Mix _mix;                   // factors of the enabled motors packed for the mixer
+    bool                _mix_changed = true;    // true if _mix needs repacking
+
     // helper to return value scaled between boost and normal based on the value of _thrust_boost_ratio
     float boost_ratio(float boost_value, float normal_value) const;
 
@@ -0,0 +1,155 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AP_MotorsMatrix_Mix.h"
+
+#include <AP_Math/AP_Math.h>
+
+// pack the factors of the enabled motors
+void AP_MotorsMatrix_Mix::pack(const bool enabled[AP_MOTORS_MAX_NUM_MOTORS],
+                               const float roll[AP_MOTORS_MAX_NUM_MOTORS],
+                               const float pitch[AP_MOTORS_MAX_NUM_MOTORS],
+                               const float yaw[AP_MOTORS_MAX_NUM_MOTORS],
+                               const float throttle[AP_MOTORS_MAX_NUM_MOTORS])
+{
+    _num = 0;
+    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+        if (!enabled[i]) {
+            _pos[i] = -1;
+            continue;
+        }
+        _pos[i] = _num;
+        _index[_num] = i;
+        _roll[_num] = roll[i];
+        _pitch[_num] = pitch[i];
+        _yaw[_num] = yaw[i];
+        _throttle[_num] = throttle[i];
+        _num++;
+    }
+}
+
+// yaw that can be applied to one motor before it saturates, zero
+// factors must be excluded by the caller
+float AP_MotorsMatrix_Mix::motor_yaw_allowed(float throttle_thrust_best_rpy, float thrust_rp, float yaw_thrust, float yaw_factor)
+{
+    const float thrust_rp_best_throttle = throttle_thrust_best_rpy + thrust_rp;
+    float motor_room;
+    if (is_positive(yaw_thrust * yaw_factor)) {
+        // room to upper limit
+        motor_room = 1.0 - thrust_rp_best_throttle;
+    } else {
+        // room to lower limit
+        motor_room = thrust_rp_best_throttle;
+    }
+    return MAX(motor_room, 0.0)/fabsf(yaw_factor);
+}
+
+// mix the inputs, see AP_MotorsMatrix::output_armed_stabilizing() for
+// the reasoning behind each step
+float AP_MotorsMatrix_Mix::mix(const Input &in, float out[AP_MOTORS_MAX_NUM_MOTORS], Limits &limits) const
+{
+    // roll, pitch and yaw thrust of each packed motor
+    float thrust[AP_MOTORS_MAX_NUM_MOTORS];
+
+    // packed position of the lost motor, -1 if thrust boost is off
+    // or the lost motor is not enabled
+    const int8_t lost = in.thrust_boost ? _pos[in.lost_index] : -1;
+
+    // throttle providing maximum roll, pitch and yaw range
+    float throttle_thrust_best_rpy = MIN(0.5f, in.throttle_avg_max);
+
+    // calculate the thrust outputs for roll and pitch and the amount
+    // of yaw we can fit into the throttle range, excluding the lost motor
+    float yaw_allowed = 1.0f;
+    for (uint8_t i = 0; i < _num; i++) {
+        thrust[i] = in.roll_thrust * _roll[i] + in.pitch_thrust * _pitch[i];
+        if (!is_zero(_yaw[i]) && i != lost) {
+            yaw_allowed = MIN(yaw_allowed, motor_yaw_allowed(throttle_thrust_best_rpy, thrust[i], in.yaw_thrust, _yaw[i]));
+        }
+    }
+
+    // Let yaw access minimum amount of head room
+    yaw_allowed = MAX(yaw_allowed, in.yaw_allowed_min);
+
+    // Include the lost motor scaled by thrust_boost_ratio
+    if (lost >= 0 && !is_zero(_yaw[lost])) {
+        const float lost_yaw_allowed = motor_yaw_allowed(throttle_thrust_best_rpy, thrust[lost], in.yaw_thrust, _yaw[lost]);
+        yaw_allowed = boost_ratio(in.thrust_boost_ratio, yaw_allowed, MIN(yaw_allowed, lost_yaw_allowed));
+    }
+
+    float yaw_thrust = in.yaw_thrust;
+    if (fabsf(yaw_thrust) > yaw_allowed) {
+        // not all commanded yaw can be used
+        yaw_thrust = constrain_float(yaw_thrust, -yaw_allowed, yaw_allowed);
+        limits.yaw = true;
+    }
+
+    // add yaw control to thrust outputs, recording the lowest and
+    // highest roll + pitch + yaw command excluding the lost motor
+    float rpy_low = 1.0f;
+    float rpy_high = -1.0f;
+    for (uint8_t i = 0; i < _num; i++) {
+        thrust[i] = thrust[i] + yaw_thrust * _yaw[i];
+        if (thrust[i] < rpy_low) {
+            rpy_low = thrust[i];
+        }
+        if (thrust[i] > rpy_high && i != lost) {
+            rpy_high = thrust[i];
+        }
+    }
+    // Include the lost motor scaled by thrust_boost_ratio
+    if (lost >= 0 && thrust[lost] > rpy_high) {
+        rpy_high = boost_ratio(in.thrust_boost_ratio, rpy_high, thrust[lost]);
+    }
+
+    // calculate any scaling needed to make the combined thrust outputs fit within the output range
+    float rpy_scale = 1.0f;
+    if (rpy_high - rpy_low > 1.0f) {
+        rpy_scale = 1.0f / (rpy_high - rpy_low);
+    }
+    if (in.throttle_avg_max + rpy_low < 0) {
+        rpy_scale = MIN(rpy_scale, -in.throttle_avg_max / rpy_low);
+    }
+
+    // calculate how close the motors can come to the desired throttle
+    rpy_high *= rpy_scale;
+    rpy_low *= rpy_scale;
+    throttle_thrust_best_rpy = -rpy_low;
+    float thr_adj = in.throttle_thrust - throttle_thrust_best_rpy;
+    if (rpy_scale < 1.0f) {
+        // Full range is being used by roll, pitch, and yaw.
+        limits.rpy = true;
+        limits.yaw = true;
+        if (thr_adj > 0.0f) {
+            limits.throttle_upper = true;
+        }
+        thr_adj = 0.0f;
+    } else if (thr_adj < 0.0f) {
+        // Throttle can't be reduced to desired value
+        thr_adj = 0.0f;
+    } else if (thr_adj > 1.0f - (throttle_thrust_best_rpy + rpy_high)) {
+        // Throttle can't be increased to desired value
+        thr_adj = 1.0f - (throttle_thrust_best_rpy + rpy_high);
+        limits.throttle_upper = true;
+    }
+
+    // add scaled roll, pitch, constrained yaw and throttle for each motor
+    const float throttle_thrust_best_plus_adj = throttle_thrust_best_rpy + thr_adj;
+    for (uint8_t i = 0; i < _num; i++) {
+        out[_index[i]] = (throttle_thrust_best_plus_adj * _throttle[i]) + (rpy_scale * thrust[i]);
+    }
+
+    return throttle_thrust_best_plus_adj;
+}
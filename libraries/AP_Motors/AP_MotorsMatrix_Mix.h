@@ -0,0 +1,71 @@
+/// @file	AP_MotorsMatrix_Mix.h
+/// @brief	Roll, pitch and yaw mixing for matrix frames
+#pragma once
+
+#include <stdint.h>
+
+#include "AP_Motors_Class.h"
+
+/*
+  The mixing part of AP_MotorsMatrix::output_armed_stabilizing(). The
+  factors of the enabled motors are packed into contiguous arrays
+  when the frame changes, so the mixer loops only over the motors in
+  use, with no motor_enabled checks, and is independent of the motors
+  object so it can be tested and benchmarked on its own.
+
+  The arithmetic is the same, in the same order, as the scalar mixer
+  it replaces so the outputs are bit for bit identical.
+ */
+class AP_MotorsMatrix_Mix {
+public:
+    // inputs of one mixer run, scaled by the compensation gain
+    struct Input {
+        float roll_thrust;          // -1 ~ +1
+        float pitch_thrust;         // -1 ~ +1
+        float yaw_thrust;           // -1 ~ +1
+        float throttle_thrust;      // constrained to 0 ~ throttle_thrust_max
+        float throttle_avg_max;     // constrained to throttle_thrust ~ throttle_thrust_max
+        float yaw_allowed_min;      // minimum yaw headroom, thrust boost applied
+        bool thrust_boost;          // true if the lost motor is excluded
+        float thrust_boost_ratio;   // 0 ~ 1
+        uint8_t lost_index;         // motor number of the lost motor
+    };
+
+    // limits reached by the mixer. Flags are only ever set
+    struct Limits {
+        bool rpy;                   // roll, pitch and yaw scaled back
+        bool yaw;
+        bool throttle_upper;
+    };
+
+    // pack the factors of the enabled motors
+    void pack(const bool enabled[AP_MOTORS_MAX_NUM_MOTORS],
+              const float roll[AP_MOTORS_MAX_NUM_MOTORS],
+              const float pitch[AP_MOTORS_MAX_NUM_MOTORS],
+              const float yaw[AP_MOTORS_MAX_NUM_MOTORS],
+              const float throttle[AP_MOTORS_MAX_NUM_MOTORS]);
+
+    // mix the inputs, writing the thrust of each enabled motor to
+    // out[] by motor number. Returns the throttle that was applied,
+    // throttle_thrust_best_rpy + thr_adj
+    float mix(const Input &in, float out[AP_MOTORS_MAX_NUM_MOTORS], Limits &limits) const;
+
+    uint8_t get_num_motors() const { return _num; }
+
+private:
+    // value scaled between boost and normal by thrust_boost_ratio
+    static float boost_ratio(float ratio, float boost_value, float normal_value) {
+        return ratio * boost_value + (1.0 - ratio) * normal_value;
+    }
+
+    // yaw that can be applied to one motor before it saturates
+    static float motor_yaw_allowed(float throttle_thrust_best_rpy, float thrust_rp, float yaw_thrust, float yaw_factor);
+
+    uint8_t _num;                               // number of enabled motors
+    uint8_t _index[AP_MOTORS_MAX_NUM_MOTORS];   // motor number of each packed motor
+    int8_t _pos[AP_MOTORS_MAX_NUM_MOTORS];      // packed position of each motor number, -1 if disabled
+    float _roll[AP_MOTORS_MAX_NUM_MOTORS];
+    float _pitch[AP_MOTORS_MAX_NUM_MOTORS];
+    float _yaw[AP_MOTORS_MAX_NUM_MOTORS];
+    float _throttle[AP_MOTORS_MAX_NUM_MOTORS];
+};
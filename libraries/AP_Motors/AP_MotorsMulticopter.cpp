@@ -18,6 +18,7 @@
 #include <AP_BattMonitor/AP_BattMonitor.h>
 #include <SRV_Channel/SRV_Channel.h>
 #include <AP_Logger/AP_Logger.h>
+#include <AP_Trace/AP_Trace.h>
 
 #include <AP_Vehicle/AP_Vehicle_Type.h>
 #if APM_BUILD_TYPE(APM_BUILD_ArduPlane)
@@ -274,6 +275,8 @@ void AP_MotorsMulticopter::output()
 
     // clear mask of overridden motors
     _motor_mask_override = 0;
+
+    AP_TRACE(MOTORS_OUTPUT);
 };
 
 void AP_MotorsMulticopter::update_external_limits()
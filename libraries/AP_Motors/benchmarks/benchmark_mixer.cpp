@@ -0,0 +1,99 @@
+/*
+  time one run of the packed matrix mixer for frames of 4, 8 and 12
+  motors, and repacking the factors after a frame change
+ */
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Motors/AP_MotorsMatrix_Mix.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static const uint8_t N = AP_MOTORS_MAX_NUM_MOTORS;
+
+struct Frame {
+    bool enabled[N];
+    float roll[N];
+    float pitch[N];
+    float yaw[N];
+    float throttle[N];
+};
+
+// motors evenly spaced around the frame with alternating yaw, the
+// factors as add_motor() sets them
+static Frame make_frame(uint8_t num)
+{
+    Frame f {};
+    for (uint8_t i = 0; i < num; i++) {
+        const float angle = 360.0f * i / num + 180.0f / num;
+        f.enabled[i] = true;
+        f.roll[i] = cosf(radians(angle + 90));
+        f.pitch[i] = cosf(radians(angle));
+        f.yaw[i] = (i & 1) ? -1.0f : 1.0f;
+        f.throttle[i] = 1.0f;
+    }
+    return f;
+}
+
+// a demanding input that saturates roll, pitch and yaw
+static const AP_MotorsMatrix_Mix::Input input {
+    0.4f,   // roll_thrust
+    -0.3f,  // pitch_thrust
+    0.5f,   // yaw_thrust
+    0.6f,   // throttle_thrust
+    0.7f,   // throttle_avg_max
+    0.2f,   // yaw_allowed_min
+    false,  // thrust_boost
+    0.0f,   // thrust_boost_ratio
+    0,      // lost_index
+};
+
+static void mix_frame(benchmark::State& state, uint8_t num)
+{
+    const Frame f = make_frame(num);
+    AP_MotorsMatrix_Mix mix;
+    mix.pack(f.enabled, f.roll, f.pitch, f.yaw, f.throttle);
+    float out[N];
+
+    while (state.KeepRunning()) {
+        AP_MotorsMatrix_Mix::Limits limits {};
+        gbenchmark_escape(&mix);
+        const float throttle = mix.mix(input, out, limits);
+        gbenchmark_escape(out);
+        gbenchmark_escape(&throttle);
+    }
+}
+
+static void BM_MixQuad(benchmark::State& state)
+{
+    mix_frame(state, 4);
+}
+
+static void BM_MixOcta(benchmark::State& state)
+{
+    mix_frame(state, 8);
+}
+
+static void BM_MixDodeca(benchmark::State& state)
+{
+    mix_frame(state, 12);
+}
+
+// repacking, done once per frame change
+static void BM_PackOcta(benchmark::State& state)
+{
+    const Frame f = make_frame(8);
+    AP_MotorsMatrix_Mix mix;
+
+    while (state.KeepRunning()) {
+        mix.pack(f.enabled, f.roll, f.pitch, f.yaw, f.throttle);
+        gbenchmark_escape(&mix);
+    }
+}
+
+BENCHMARK(BM_MixQuad);
+BENCHMARK(BM_MixOcta);
+BENCHMARK(BM_MixDodeca);
+BENCHMARK(BM_PackOcta);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,310 @@
+/*
+  check that the packed matrix mixer gives bit for bit the same
+  outputs, limits and throttle as the scalar mixer it replaced in
+  AP_MotorsMatrix::output_armed_stabilizing()
+ */
+#include <AP_gtest.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/tests/random_test.h>
+#include <AP_Motors/AP_MotorsMatrix_Mix.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static const uint8_t N = AP_MOTORS_MAX_NUM_MOTORS;
+
+struct Frame {
+    bool enabled[N];
+    float roll[N];
+    float pitch[N];
+    float yaw[N];
+    float throttle[N];
+};
+
+// the scalar mixer as it was in output_armed_stabilizing(), from the
+// choice of throttle_thrust_best_rpy to the motor outputs
+static float reference_mix(const Frame &f, const AP_MotorsMatrix_Mix::Input &in,
+                           float thrust_rpyt_out[N], AP_MotorsMatrix_Mix::Limits &limits)
+{
+    auto boost_ratio = [&in](float boost_value, float normal_value) -> float {
+        return in.thrust_boost_ratio * boost_value + (1.0 - in.thrust_boost_ratio) * normal_value;
+    };
+    const float roll_thrust = in.roll_thrust;
+    const float pitch_thrust = in.pitch_thrust;
+    float yaw_thrust = in.yaw_thrust;
+    const float throttle_thrust = in.throttle_thrust;
+    const float throttle_avg_max = in.throttle_avg_max;
+    const bool thrust_boost = in.thrust_boost;
+    const uint8_t motor_lost_index = in.lost_index;
+
+    float throttle_thrust_best_rpy = MIN(0.5f, throttle_avg_max);
+
+    float yaw_allowed = 1.0f;
+    for (uint8_t i = 0; i < N; i++) {
+        if (f.enabled[i]) {
+            thrust_rpyt_out[i] = roll_thrust * f.roll[i] + pitch_thrust * f.pitch[i];
+            if (!is_zero(f.yaw[i]) && (!thrust_boost || i != motor_lost_index)) {
+                const float thrust_rp_best_throttle = throttle_thrust_best_rpy + thrust_rpyt_out[i];
+                float motor_room;
+                if (is_positive(yaw_thrust * f.yaw[i])) {
+                    motor_room = 1.0 - thrust_rp_best_throttle;
+                } else {
+                    motor_room = thrust_rp_best_throttle;
+                }
+                const float motor_yaw_allowed = MAX(motor_room, 0.0)/fabsf(f.yaw[i]);
+                yaw_allowed = MIN(yaw_allowed, motor_yaw_allowed);
+            }
+        }
+    }
+
+    yaw_allowed = MAX(yaw_allowed, in.yaw_allowed_min);
+
+    if (thrust_boost && f.enabled[motor_lost_index]) {
+        if (!is_zero(f.yaw[motor_lost_index])){
+            const float thrust_rp_best_throttle = throttle_thrust_best_rpy + thrust_rpyt_out[motor_lost_index];
+            float motor_room;
+            if (is_positive(yaw_thrust * f.yaw[motor_lost_index])) {
+                motor_room = 1.0 - thrust_rp_best_throttle;
+            } else {
+                motor_room = thrust_rp_best_throttle;
+            }
+            const float motor_yaw_allowed = MAX(motor_room, 0.0)/fabsf(f.yaw[motor_lost_index]);
+            yaw_allowed = boost_ratio(yaw_allowed, MIN(yaw_allowed, motor_yaw_allowed));
+        }
+    }
+
+    if (fabsf(yaw_thrust) > yaw_allowed) {
+        yaw_thrust = constrain_float(yaw_thrust, -yaw_allowed, yaw_allowed);
+        limits.yaw = true;
+    }
+
+    float rpy_low = 1.0f;
+    float rpy_high = -1.0f;
+    for (uint8_t i = 0; i < N; i++) {
+        if (f.enabled[i]) {
+            thrust_rpyt_out[i] = thrust_rpyt_out[i] + yaw_thrust * f.yaw[i];
+            if (thrust_rpyt_out[i] < rpy_low) {
+                rpy_low = thrust_rpyt_out[i];
+            }
+            if (thrust_rpyt_out[i] > rpy_high && (!thrust_boost || i != motor_lost_index)) {
+                rpy_high = thrust_rpyt_out[i];
+            }
+        }
+    }
+    if (thrust_boost) {
+        if (thrust_rpyt_out[motor_lost_index] > rpy_high && f.enabled[motor_lost_index]) {
+            rpy_high = boost_ratio(rpy_high, thrust_rpyt_out[motor_lost_index]);
+        }
+    }
+
+    float rpy_scale = 1.0f;
+    if (rpy_high - rpy_low > 1.0f) {
+        rpy_scale = 1.0f / (rpy_high - rpy_low);
+    }
+    if (throttle_avg_max + rpy_low < 0) {
+        rpy_scale = MIN(rpy_scale, -throttle_avg_max / rpy_low);
+    }
+
+    rpy_high *= rpy_scale;
+    rpy_low *= rpy_scale;
+    throttle_thrust_best_rpy = -rpy_low;
+    float thr_adj = throttle_thrust - throttle_thrust_best_rpy;
+    if (rpy_scale < 1.0f) {
+        limits.rpy = true;
+        limits.yaw = true;
+        if (thr_adj > 0.0f) {
+            limits.throttle_upper = true;
+        }
+        thr_adj = 0.0f;
+    } else if (thr_adj < 0.0f) {
+        thr_adj = 0.0f;
+    } else if (thr_adj > 1.0f - (throttle_thrust_best_rpy + rpy_high)) {
+        thr_adj = 1.0f - (throttle_thrust_best_rpy + rpy_high);
+        limits.throttle_upper = true;
+    }
+
+    const float throttle_thrust_best_plus_adj = throttle_thrust_best_rpy + thr_adj;
+    for (uint8_t i = 0; i < N; i++) {
+        if (f.enabled[i]) {
+            thrust_rpyt_out[i] = (throttle_thrust_best_plus_adj * f.throttle[i]) + (rpy_scale * thrust_rpyt_out[i]);
+        }
+    }
+    return throttle_thrust_best_plus_adj;
+}
+
+// deterministic random numbers so failures can be reproduced
+static TestRandom rng{0x12345678};
+
+// frame of motors at the given angles, added as add_motor() does
+static Frame make_frame(const float angles[], const float yaw[], uint8_t num, float throttle = 1.0f)
+{
+    Frame f {};
+    for (uint8_t i = 0; i < num; i++) {
+        f.enabled[i] = true;
+        f.roll[i] = cosf(radians(angles[i] + 90));
+        f.pitch[i] = cosf(radians(angles[i]));
+        f.yaw[i] = yaw[i];
+        f.throttle[i] = throttle;
+    }
+    return f;
+}
+
+static const float CW = -1;
+static const float CCW = 1;
+
+static Frame quad_x()
+{
+    const float angles[] { 45, -135, -45, 135 };
+    const float yaw[] { CCW, CCW, CW, CW };
+    return make_frame(angles, yaw, 4);
+}
+
+static Frame hexa_x()
+{
+    const float angles[] { 90, -90, -30, 150, 30, -150 };
+    const float yaw[] { CW, CCW, CW, CCW, CCW, CW };
+    return make_frame(angles, yaw, 6);
+}
+
+static Frame octaquad_x()
+{
+    const float angles[] { 45, -45, -135, 135, -45, 45, 135, -135 };
+    const float yaw[] { CCW, CW, CCW, CW, CCW, CW, CCW, CW };
+    return make_frame(angles, yaw, 8);
+}
+
+static Frame dodecahexa_x()
+{
+    const float angles[] { 30, 30, 90, 90, 150, 150, -150, -150, -90, -90, -30, -30 };
+    const float yaw[] { CCW, CW, CW, CCW, CCW, CW, CW, CCW, CCW, CW, CW, CCW };
+    return make_frame(angles, yaw, 12);
+}
+
+// Y6 with the lower motors on sparse motor numbers and reduced
+// throttle factors, as a scripted frame might set up
+static Frame y6_sparse()
+{
+    Frame f {};
+    const uint8_t motor[] { 0, 2, 4, 7, 9, 11 };
+    const float roll[] { -1, 1, 0, -1, 1, 0 };
+    const float pitch[] { 0.666f, 0.666f, -1.333f, 0.666f, 0.666f, -1.333f };
+    const float yaw[] { CW, CCW, CW, CCW, CW, CCW };
+    const float throttle[] { 1, 1, 1, 0.9f, 0.9f, 0.9f };
+    for (uint8_t i = 0; i < ARRAY_SIZE(motor); i++) {
+        const uint8_t m = motor[i];
+        f.enabled[m] = true;
+        f.roll[m] = roll[i];
+        f.pitch[m] = pitch[i];
+        f.yaw[m] = yaw[i];
+        f.throttle[m] = throttle[i];
+    }
+    return f;
+}
+
+// random factors, with some zero yaw factors as from disable_yaw_torque()
+static Frame random_frame()
+{
+    Frame f {};
+    for (uint8_t i = 0; i < N; i++) {
+        f.enabled[i] = rng.next_float(0, 1) < 0.7f;
+        f.roll[i] = rng.next_float(-0.5f, 0.5f);
+        f.pitch[i] = rng.next_float(-0.5f, 0.5f);
+        f.yaw[i] = rng.next_float(0, 1) < 0.2f ? 0.0f : rng.next_float(-0.5f, 0.5f);
+        f.throttle[i] = rng.next_float(0, 1);
+    }
+    return f;
+}
+
+static AP_MotorsMatrix_Mix::Input random_input(bool thrust_boost)
+{
+    AP_MotorsMatrix_Mix::Input in;
+    const float ratio_choice = rng.next_float(0, 3);
+    in.thrust_boost = thrust_boost;
+    in.thrust_boost_ratio = ratio_choice < 1 ? 0.0f : (ratio_choice < 2 ? 1.0f : rng.next_float(0, 1));
+    in.lost_index = uint8_t(rng.next_float(0, N - 0.01f));
+    in.roll_thrust = rng.next_float(-1.5f, 1.5f);
+    in.pitch_thrust = rng.next_float(-1.5f, 1.5f);
+    in.yaw_thrust = rng.next_float(-1.5f, 1.5f);
+
+    // the clamping done by output_armed_stabilizing()
+    const float throttle_thrust_max = rng.next_float(0.3f, 1.0f);
+    in.throttle_thrust = rng.next_float(0, throttle_thrust_max);
+    in.throttle_avg_max = rng.next_float(in.throttle_thrust, throttle_thrust_max);
+    const float yaw_headroom = rng.next_float(0, 500) * 0.001f;
+    in.yaw_allowed_min = in.thrust_boost_ratio * 0.5 + (1.0 - in.thrust_boost_ratio) * yaw_headroom;
+    return in;
+}
+
+static void check_frame(const Frame &f, uint32_t runs)
+{
+    AP_MotorsMatrix_Mix mix;
+    mix.pack(f.enabled, f.roll, f.pitch, f.yaw, f.throttle);
+
+    for (uint32_t r = 0; r < runs; r++) {
+        const AP_MotorsMatrix_Mix::Input in = random_input(r & 1);
+
+        // outputs of disabled motors must be left alone
+        float expected[N];
+        float out[N];
+        for (uint8_t i = 0; i < N; i++) {
+            expected[i] = out[i] = -7.0f - i;
+        }
+        AP_MotorsMatrix_Mix::Limits expected_limits {};
+        AP_MotorsMatrix_Mix::Limits limits {};
+
+        const float expected_throttle = reference_mix(f, in, expected, expected_limits);
+        const float throttle = mix.mix(in, out, limits);
+
+        ASSERT_EQ(0, memcmp(expected, out, sizeof(out))) << "run " << r;
+        ASSERT_EQ(0, memcmp(&expected_throttle, &throttle, sizeof(throttle))) << "run " << r;
+        ASSERT_EQ(expected_limits.rpy, limits.rpy) << "run " << r;
+        ASSERT_EQ(expected_limits.yaw, limits.yaw) << "run " << r;
+        ASSERT_EQ(expected_limits.throttle_upper, limits.throttle_upper) << "run " << r;
+    }
+}
+
+TEST(MotorsMatrixMix, Pack)
+{
+    const Frame f = y6_sparse();
+    AP_MotorsMatrix_Mix mix;
+    mix.pack(f.enabled, f.roll, f.pitch, f.yaw, f.throttle);
+    EXPECT_EQ(6, mix.get_num_motors());
+
+    const Frame none {};
+    mix.pack(none.enabled, none.roll, none.pitch, none.yaw, none.throttle);
+    EXPECT_EQ(0, mix.get_num_motors());
+}
+
+TEST(MotorsMatrixMix, Quad)
+{
+    check_frame(quad_x(), 20000);
+}
+
+TEST(MotorsMatrixMix, Hexa)
+{
+    check_frame(hexa_x(), 20000);
+}
+
+TEST(MotorsMatrixMix, OctaQuad)
+{
+    check_frame(octaquad_x(), 20000);
+}
+
+TEST(MotorsMatrixMix, DodecaHexa)
+{
+    check_frame(dodecahexa_x(), 20000);
+}
+
+TEST(MotorsMatrixMix, Y6Sparse)
+{
+    check_frame(y6_sparse(), 20000);
+}
+
+TEST(MotorsMatrixMix, RandomFrames)
+{
+    for (uint8_t i = 0; i < 100; i++) {
+        check_frame(random_frame(), 1000);
+    }
+}
+
+AP_GTEST_MAIN()
@@ -1685,14 +1685,14 @@ void AP_OSD_Screen::draw_speed(uint8_t x, uint8_t y, float angle_rad, float magn
 
 void AP_OSD_Screen::draw_gspeed(uint8_t x, uint8_t y)
 {
-    AP_AHRS &ahrs = AP::ahrs();
-    WITH_SEMAPHORE(ahrs.get_semaphore());
-    Vector2f v = ahrs.groundspeed_vector();
+    AP_AHRS::Snapshot snap;
+    AP::ahrs().get_snapshot(snap);
+    const Vector2f &v = snap.ground_speed_vec;
     backend->write(x, y, false, "%c", SYMBOL(SYM_GSPD));
     float angle = 0;
     const float length = v.length();
     if (length > 1.0f) {
-        angle = atan2f(v.y, v.x) - ahrs.get_yaw();
+        angle = atan2f(v.y, v.x) - snap.yaw;
     }
     draw_speed(x + 1, y, angle, length);
 }
@@ -1781,13 +1781,13 @@ void AP_OSD_Screen::draw_distance(uint8_t x, uint8_t y, float distance)
 
 void AP_OSD_Screen::draw_home(uint8_t x, uint8_t y)
 {
-    AP_AHRS &ahrs = AP::ahrs();
-    WITH_SEMAPHORE(ahrs.get_semaphore());
-    Location loc;
-    if (ahrs.get_location(loc) && ahrs.home_is_set()) {
-        const Location &home_loc = ahrs.get_home();
+    AP_AHRS::Snapshot snap;
+    AP::ahrs().get_snapshot(snap);
+    if (snap.location_ok && snap.home_is_set) {
+        const Location &loc = snap.location;
+        const Location &home_loc = snap.home;
         float distance = home_loc.get_distance(loc);
-        int32_t angle_cd = loc.get_bearing_to(home_loc) - ahrs.yaw_sensor;
+        int32_t angle_cd = loc.get_bearing_to(home_loc) - int32_t(degrees(snap.yaw) * 100);
         if (distance < 2.0f) {
             //avoid fast rotating arrow at small distances
             angle_cd = 0;
@@ -1938,16 +1938,16 @@ void AP_OSD_Screen::draw_compass(uint8_t x, uint8_t y)
 void AP_OSD_Screen::draw_wind(uint8_t x, uint8_t y)
 {
 #if !APM_BUILD_TYPE(APM_BUILD_Rover)
-    AP_AHRS &ahrs = AP::ahrs();
-    WITH_SEMAPHORE(ahrs.get_semaphore());
-    Vector3f v = ahrs.wind_estimate();
+    AP_AHRS::Snapshot snap;
+    AP::ahrs().get_snapshot(snap);
+    const Vector3f &v = snap.wind_estimate;
     float angle = 0;
     const float length = v.length();
     if (length > 1.0f) {
         if (check_option(AP_OSD::OPTION_INVERTED_WIND)) {
             angle = M_PI;
         }
-        angle = angle + atan2f(v.y, v.x) - ahrs.get_yaw();
+        angle = angle + atan2f(v.y, v.x) - snap.yaw;
     } 
     draw_speed(x + 1, y, angle, length);
 
@@ -1976,13 +1976,12 @@ void AP_OSD_Screen::draw_aspeed(uint8_t x, uint8_t y)
 
 void AP_OSD_Screen::draw_vspeed(uint8_t x, uint8_t y)
 {
-    Vector3f v;
     float vspd;
     float vs_scaled;
-    AP_AHRS &ahrs = AP::ahrs();
-    WITH_SEMAPHORE(ahrs.get_semaphore());
-    if (ahrs.get_velocity_NED(v)) {
-        vspd = -v.z;
+    AP_AHRS::Snapshot snap;
+    AP::ahrs().get_snapshot(snap);
+    if (snap.velocity_NED_ok) {
+        vspd = -snap.velocity_NED.z;
     } else {
         auto &baro = AP::baro();
         WITH_SEMAPHORE(baro.get_semaphore());
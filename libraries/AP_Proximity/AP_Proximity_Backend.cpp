@@ -117,6 +117,26 @@ void AP_Proximity_Backend::database_push(float angle, float pitch, float distanc
     }
 }
 
+// calculate position of an object as an offset in meters (NEU) from the EKF origin
+// returns false if pitch is invalid
+static bool database_object_position(float angle, float pitch, float distance, const Vector3f &current_pos, const Matrix3f &body_to_ned, Vector3f &pos)
+{
+    if ((pitch > 90.0f) || (pitch < -90.0f)) {
+        // sanity check on pitch
+        return false;
+    }
+    //Assume object is angle and pitch bearing and distance meters away from the vehicle 
+    Vector3f object_3D;
+    object_3D.offset_bearing(wrap_180(angle), (pitch * -1.0f), distance);
+    const Vector3f rotated_object_3D = body_to_ned * object_3D;
+
+    //Calculate the position vector from origin
+    pos = current_pos + rotated_object_3D;
+    //Convert the vector to a NEU frame from NED
+    pos.z = pos.z * -1.0f;
+    return true;
+}
+
 // update Object Avoidance database with Earth-frame point
 // pitch can be optionally provided if needed
 void AP_Proximity_Backend::database_push(float angle, float pitch, float distance, uint32_t timestamp_ms, const Vector3f &current_pos, const Matrix3f &body_to_ned)
@@ -127,22 +147,63 @@ void AP_Proximity_Backend::database_push(float angle, float pitch, float distanc
     if (oaDb == nullptr || !oaDb->healthy()) {
         return;
     }
-    if ((pitch > 90.0f) || (pitch < -90.0f)) {
-        // sanity check on pitch
+    Vector3f temp_pos;
+    if (!database_object_position(angle, pitch, distance, current_pos, body_to_ned, temp_pos)) {
         return;
     }
-    //Assume object is angle and pitch bearing and distance meters away from the vehicle 
-    Vector3f object_3D;
-    object_3D.offset_bearing(wrap_180(angle), (pitch * -1.0f), distance);
-    const Vector3f rotated_object_3D = body_to_ned * object_3D;
-
-    //Calculate the position vector from origin
-    Vector3f temp_pos = current_pos + rotated_object_3D;
-    //Convert the vector to a NEU frame from NED
-    temp_pos.z = temp_pos.z * -1.0f;
 
     oaDb->queue_push(temp_pos, timestamp_ms, distance);
 #endif  // AP_OADATABASE_ENABLED
 }
 
+// add Earth-frame point to batch, pushing the batch to the Object Avoidance database if it is full
+void AP_Proximity_Backend::database_batch_add(DatabaseBatch &batch, float angle, float pitch, float distance, uint32_t timestamp_ms, const Vector3f &current_pos, const Matrix3f &body_to_ned)
+{
+    if (!database_object_position(angle, pitch, distance, current_pos, body_to_ned, batch.pos[batch.count])) {
+        return;
+    }
+    batch.distance[batch.count++] = distance;
+
+    if (batch.count >= ARRAY_SIZE(batch.pos)) {
+        database_batch_push(batch, timestamp_ms);
+    }
+}
+
+// push all points in batch to the Object Avoidance database
+void AP_Proximity_Backend::database_batch_push(DatabaseBatch &batch, uint32_t timestamp_ms)
+{
+#if AP_OADATABASE_ENABLED
+    AP_OADatabase *oaDb = AP::oadatabase();
+    if ((oaDb != nullptr) && (batch.count > 0)) {
+        oaDb->queue_push(batch.pos, batch.distance, batch.count, timestamp_ms);
+    }
+#endif  // AP_OADATABASE_ENABLED
+    batch.count = 0;
+}
+
+// start collecting points read from a sensor for the Object Avoidance database
+void AP_Proximity_Backend::database_scan_start(DatabaseScan &scan)
+{
+    scan.batch.count = 0;
+    scan.timestamp_ms = AP_HAL::millis();
+    scan.ready = database_prepare_for_push(scan.current_pos, scan.body_to_ned);
+}
+
+// add Earth-frame point read from a sensor to the scan.  points added before database_scan_start are ignored
+void AP_Proximity_Backend::database_scan_add(DatabaseScan &scan, float angle, float distance)
+{
+    if (scan.ready) {
+        database_batch_add(scan.batch, angle, 0.0f, distance, scan.timestamp_ms, scan.current_pos, scan.body_to_ned);
+    }
+}
+
+// push points read from a sensor to the Object Avoidance database
+void AP_Proximity_Backend::database_scan_push(DatabaseScan &scan)
+{
+    if (scan.ready) {
+        database_batch_push(scan.batch, scan.timestamp_ms);
+    }
+    scan.ready = false;
+}
+
 #endif // HAL_PROXIMITY_ENABLED
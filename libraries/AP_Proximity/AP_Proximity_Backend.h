@@ -20,6 +20,8 @@
 #include <AP_Common/AP_Common.h>
 #include <AP_HAL/Semaphores.h>
 
+#define AP_PROXIMITY_DATABASE_BATCH_SIZE    16  // maximum number of points pushed to the Object Avoidance database at once
+
 class AP_Proximity_Backend
 {
 public:
@@ -84,6 +86,30 @@ protected:
     };
     static void database_push(float angle, float pitch, float distance, uint32_t timestamp_ms, const Vector3f &current_pos, const Matrix3f &body_to_ned);
 
+    // Earth-frame points from a single scan which are pushed to the database together
+    struct DatabaseBatch {
+        Vector3f pos[AP_PROXIMITY_DATABASE_BATCH_SIZE];
+        float distance[AP_PROXIMITY_DATABASE_BATCH_SIZE];
+        uint8_t count;
+    };
+    // add point to batch, pushing the batch to the database if it is full
+    static void database_batch_add(DatabaseBatch &batch, float angle, float pitch, float distance, uint32_t timestamp_ms, const Vector3f &current_pos, const Matrix3f &body_to_ned);
+    // push all points in batch to the database
+    static void database_batch_push(DatabaseBatch &batch, uint32_t timestamp_ms);
+
+    // points read from a sensor during one update, relative to the vehicle position and attitude when the update started
+    // call database_scan_start before reading the sensor, database_scan_add for each point and database_scan_push when done
+    struct DatabaseScan {
+        DatabaseBatch batch;
+        Vector3f current_pos;
+        Matrix3f body_to_ned;
+        uint32_t timestamp_ms;
+        bool ready;         // true if points can be added to the database
+    };
+    static void database_scan_start(DatabaseScan &scan);
+    static void database_scan_add(DatabaseScan &scan, float angle, float distance);
+    static void database_scan_push(DatabaseScan &scan);
+
     // semaphore for access to shared frontend data
     HAL_Semaphore _sem;
 
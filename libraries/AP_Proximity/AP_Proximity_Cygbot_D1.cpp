@@ -20,8 +20,10 @@ void AP_Proximity_Cygbot_D1::update()
         return;
     }
 
-    // read data
+    // read data, pushing the points read to the database together
+    database_scan_start(_database_scan);
     read_sensor_data();
+    database_scan_push(_database_scan);
 
     if (AP_HAL::millis() - _last_distance_received_ms < CYGBOT_TIMEOUT_MS) {
         set_status(AP_Proximity::Status::Good);
@@ -156,7 +158,7 @@ void AP_Proximity_Cygbot_D1::parse_payload()
             // push face to temp boundary
             _temp_boundary.add_distance(face, corrected_angle, distance_m);
             // push to OA_DB
-            database_push(corrected_angle, distance_m);
+            database_scan_add(_database_scan, corrected_angle, distance_m);
         }
         // increment sampled angle
         sampled_angle += CYGBOT_2D_ANGLE_STEP;
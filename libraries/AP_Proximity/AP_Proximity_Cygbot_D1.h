@@ -76,6 +76,7 @@ private:
     bool _initialized;
     uint32_t _last_init_ms;                 // system time of last sensor init
     uint32_t _last_distance_received_ms;    // system time of last distance measurement received from sensor
+    DatabaseScan _database_scan;            // points read during each update, pushed to the database together
 
     AP_Proximity_Temp_Boundary _temp_boundary; // temporary boundary to store incoming payload
 
@@ -68,8 +68,10 @@ void AP_Proximity_LD06::update(void)
     }
 
     // Begin getting sensor readings
-    // Calls method that repeatedly reads through UART channel
+    // Calls method that repeatedly reads through UART channel, pushing the points read to the database together
+    database_scan_start(_database_scan);
     get_readings();
+    database_scan_push(_database_scan);
 
     // Check if the data is being received correctly and sets Proximity Status
     if (_last_distance_received_ms == 0 || (AP_HAL::millis() - _last_distance_received_ms > PROXIMITY_LD06_TIMEOUT_MS)) {
@@ -192,7 +194,7 @@ void AP_Proximity_LD06::parse_response_data()
         // Pushes the average distance and angle to the obstacle avoidance database
         const AP_Proximity_Boundary_3D::Face face = frontend.boundary.get_face(push_angle);
         _temp_boundary.add_distance(face, push_angle, distance_avg);
-        database_push(push_angle, distance_avg);
+        database_scan_add(_database_scan, push_angle, distance_avg);
     }
 }
 #endif // AP_PROXIMITY_LD06_ENABLED
@@ -63,6 +63,9 @@ private:
     // Store for error-tracking purposes
     uint32_t  _last_distance_received_ms;
 
+    // Points read during each update, pushed to the database together
+    DatabaseScan _database_scan;
+
     // Boundary to store the measurements
     AP_Proximity_Temp_Boundary _temp_boundary;
 };
@@ -46,8 +46,10 @@ void AP_Proximity_LightWareSF45B::update(void)
     // initialise sensor if necessary
     initialise();
 
-    // process incoming messages
+    // process incoming messages, pushing the points read to the database together
+    database_scan_start(_database_scan);
     process_replies();
+    database_scan_push(_database_scan);
 
     // check for timeout and set health status
     if ((_last_distance_received_ms == 0) || ((AP_HAL::millis() - _last_distance_received_ms) > PROXIMITY_SF45B_TIMEOUT_MS)) {
@@ -163,7 +165,7 @@ void AP_Proximity_LightWareSF45B::process_message()
         const uint8_t minisector = convert_angle_to_minisector(angle_deg);
         if (minisector != _minisector) {
             if ((_minisector != UINT8_MAX) && _minisector_distance_valid) {
-                database_push(_minisector_angle, _minisector_distance);
+                database_scan_add(_database_scan, _minisector_angle, _minisector_distance);
             }
             // init mini sector
             _minisector = minisector;
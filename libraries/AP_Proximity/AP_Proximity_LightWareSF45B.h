@@ -83,6 +83,7 @@ private:
     // internal variables
     uint32_t _last_init_ms;                 // system time of last re-initialisation
     uint32_t _last_distance_received_ms;    // system time of last distance measurement received from sensor
+    DatabaseScan _database_scan;            // points read during each update, pushed to the database together
     bool _init_complete;                    // true once sensor initialisation is complete
     ModeFilterInt16_Size3 _distance_filt{1};// mode filter to reduce glitches
 
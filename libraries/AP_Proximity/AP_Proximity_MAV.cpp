@@ -152,6 +152,8 @@ void AP_Proximity_MAV::handle_obstacle_distance_msg(const mavlink_message_t &msg
     Vector3f current_pos;
     Matrix3f body_to_ned;
     const bool database_ready = database_prepare_for_push(current_pos, body_to_ned);
+    DatabaseBatch database_batch;
+    database_batch.count = 0;
 
     // variables to calculate closest angle and distance for each face
     AP_Proximity_Boundary_3D::Face face;
@@ -198,10 +200,15 @@ void AP_Proximity_MAV::handle_obstacle_distance_msg(const mavlink_message_t &msg
 
         // update Object Avoidance database with Earth-frame point
         if (database_ready) {
-            database_push(mid_angle, packet_distance_m, _last_update_ms, current_pos, body_to_ned);
+            database_batch_add(database_batch, mid_angle, 0.0f, packet_distance_m, _last_update_ms, current_pos, body_to_ned);
         }
     }
 
+    // push remaining points to Object Avoidance database
+    if (database_ready) {
+        database_batch_push(database_batch, _last_update_ms);
+    }
+
     // process the last face
     if (face_distance_valid) {
         frontend.boundary.set_face_attributes(face, face_yaw_deg, face_distance, state.instance);
@@ -84,7 +84,10 @@ void AP_Proximity_RPLidarA2::update(void)
         _byte_count = 0;
     }
 
+    // read sensor, pushing the points read to the database together
+    database_scan_start(_database_scan);
     get_readings();
+    database_scan_push(_database_scan);
 
     // check for timeout and set health status
     if (AP_HAL::millis() - _last_distance_received_ms > COMM_ACTIVITY_TIMEOUT_MS) {
@@ -405,7 +408,7 @@ void AP_Proximity_RPLidarA2::parse_response_data()
                 _last_angle_deg = angle_deg;
             }
             // update OA database
-            database_push(_last_angle_deg, _last_distance_m);
+            database_scan_add(_database_scan, _last_angle_deg, _last_distance_m);
         }
     }
 }
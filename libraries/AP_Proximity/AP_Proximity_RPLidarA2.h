@@ -93,6 +93,7 @@ private:
 
     // request related variables
     uint32_t  _last_distance_received_ms;     ///< system time of last distance measurement received from sensor
+    DatabaseScan _database_scan;              ///< points read during each update, pushed to the database together
     uint32_t  _last_reset_ms;
 
     // face related variables
@@ -33,8 +33,10 @@ void AP_Proximity_TeraRangerTower::update(void)
         return;
     }
 
-    // process incoming messages
+    // process incoming messages, pushing the points read to the database together
+    database_scan_start(_database_scan);
     read_sensor_data();
+    database_scan_push(_database_scan);
 
     // check for timeout and set health status
     if ((_last_distance_received_ms == 0) || (AP_HAL::millis() - _last_distance_received_ms > PROXIMITY_TRTOWER_TIMEOUT_MS)) {
@@ -105,7 +107,7 @@ void AP_Proximity_TeraRangerTower::update_sector_data(int16_t angle_deg, uint16_
     if ((distance_mm != 0xffff) && !ignore_reading(angle_deg, distance_mm * 0.001f, false)) {
         frontend.boundary.set_face_attributes(face, angle_deg, ((float) distance_mm) / 1000, state.instance);
         // update OA database
-        database_push(angle_deg, ((float) distance_mm) / 1000);
+        database_scan_add(_database_scan, angle_deg, ((float) distance_mm) / 1000);
     } else {
         frontend.boundary.reset_face(face, state.instance);
     }
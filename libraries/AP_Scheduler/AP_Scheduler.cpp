@@ -136,6 +136,12 @@ void AP_Scheduler::init(const AP_Scheduler::Task *tasks, uint8_t num_tasks, uint
         perf_info.allocate_task_info(_num_tasks);
     }
 
+#if AP_SCHEDULER_WALL_PROFILE_ENABLED
+    if (_wall_profile_enabled) {
+        _wall_profile = NEW_NOTHROW wall_profile_t[_num_tasks];
+    }
+#endif
+
     _log_performance_bit = log_performance_bit;
 
     // sanity check the task lists to ensure the priorities are
@@ -165,6 +171,17 @@ void AP_Scheduler::tick(void)
     _tick_counter32++;
 }
 
+#if AP_SCHEDULER_WALL_PROFILE_ENABLED
+#include <time.h>
+
+static uint64_t wall_time_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000ULL + ts.tv_nsec / 1000U;
+}
+#endif
+
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
 /*
   fill stack with NaN so we can catch use of uninitialised stack
@@ -259,8 +276,19 @@ void AP_Scheduler::run(uint32_t time_available)
         hal.util->persistent_data.scheduler_task = i;
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
         fill_nanf_stack();
+#endif
+#if AP_SCHEDULER_WALL_PROFILE_ENABLED
+        const uint64_t wall_start_us = _wall_profile != nullptr ? wall_time_us() : 0;
 #endif
         task.function();
+#if AP_SCHEDULER_WALL_PROFILE_ENABLED
+        if (_wall_profile != nullptr) {
+            wall_profile_t &p = _wall_profile[i];
+            p.name = task.name;
+            p.time_us += wall_time_us() - wall_start_us;
+            p.count++;
+        }
+#endif
         hal.util->persistent_data.scheduler_task = -1;
 
         // record the tick counter when we ran. This drives
@@ -534,6 +562,47 @@ void AP_Scheduler::task_info(ExpandingString &str)
     }
 }
 
+#if AP_SCHEDULER_WALL_PROFILE_ENABLED
+void AP_Scheduler::wall_profile_info(ExpandingString &str) const
+{
+    if (_wall_profile == nullptr) {
+        return;
+    }
+
+    // sort the tasks which have run by time taken
+    uint8_t order[UINT8_MAX];
+    uint8_t n = 0;
+    uint64_t total_us = 0;
+    for (uint8_t i=0; i<_num_tasks; i++) {
+        if (_wall_profile[i].count == 0) {
+            continue;
+        }
+        total_us += _wall_profile[i].time_us;
+        uint8_t j = n++;
+        while (j > 0 && _wall_profile[order[j-1]].time_us < _wall_profile[i].time_us) {
+            order[j] = order[j-1];
+            j--;
+        }
+        order[j] = i;
+    }
+    if (total_us == 0) {
+        return;
+    }
+
+    str.printf("%-32s %10s %6s %10s %8s\n", "TASK", "TIME_MS", "PCT", "COUNT", "AVG_US");
+    for (uint8_t k=0; k<n; k++) {
+        const wall_profile_t &p = _wall_profile[order[k]];
+        str.printf("%-32s %10.1f %5.1f%% %10u %8.1f\n",
+                   p.name,
+                   p.time_us * 0.001,
+                   p.time_us * 100.0 / total_us,
+                   unsigned(p.count),
+                   double(p.time_us) / p.count);
+    }
+    str.printf("%-32s %10.1f\n", "total", total_us * 0.001);
+}
+#endif  // AP_SCHEDULER_WALL_PROFILE_ENABLED
+
 namespace AP {
 
 AP_Scheduler &scheduler()
@@ -190,6 +190,18 @@ public:
 
     void task_info(ExpandingString &str);
 
+#if AP_SCHEDULER_WALL_PROFILE_ENABLED
+    // record the wall clock time taken by each task.  In SITL
+    // AP_HAL::micros() is simulation time, which doesn't advance
+    // while a task runs, so task_info() can't show where the CPU time
+    // goes.  Must be called before init()
+    void enable_wall_profile() { _wall_profile_enabled = true; }
+
+    // fill in str with the wall clock time taken by each task, most
+    // expensive first
+    void wall_profile_info(ExpandingString &str) const;
+#endif
+
     static const struct AP_Param::GroupInfo var_info[];
 
     // loop performance monitoring:
@@ -233,6 +245,15 @@ private:
     // tick counter at the time we last ran each task
     uint16_t *_last_run;
 
+#if AP_SCHEDULER_WALL_PROFILE_ENABLED
+    struct wall_profile_t {
+        const char *name;
+        uint64_t time_us;
+        uint32_t count;
+    } *_wall_profile;
+    bool _wall_profile_enabled;
+#endif
+
     // number of microseconds allowed for the current task
     uint32_t _task_time_allowed;
 
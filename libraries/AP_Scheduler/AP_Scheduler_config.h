@@ -9,3 +9,8 @@
 #ifndef AP_SCHEDULER_EXTENDED_TASKINFO_ENABLED
 #define AP_SCHEDULER_EXTENDED_TASKINFO_ENABLED 1
 #endif
+
+// allow the wall clock time taken by each task to be recorded in SITL
+#ifndef AP_SCHEDULER_WALL_PROFILE_ENABLED
+#define AP_SCHEDULER_WALL_PROFILE_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL)
+#endif
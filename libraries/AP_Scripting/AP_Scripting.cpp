@@ -78,7 +78,7 @@ const AP_Param::GroupInfo AP_Scripting::var_info[] = {
 
     // @Param: HEAP_SIZE
     // @DisplayName: Scripting Heap Size
-    // @Description: Amount of memory available for scripting
+    // @Description: Amount of memory available for scripting. An eighth of it, up to 16384 bytes, is reserved for small allocations
     // @Range: 1024 1048576
     // @Increment: 1024
     // @User: Advanced
@@ -161,6 +161,15 @@ const AP_Param::GroupInfo AP_Scripting::var_info[] = {
     // @User: Advanced
     AP_GROUPINFO("THD_PRIORITY", 14, AP_Scripting, _thd_priority, uint8_t(ThreadPriority::NORMAL)),
 
+    // @Param: SLICE_US
+    // @DisplayName: Scripting time slice
+    // @Description: When non-zero, a script which runs for longer than this is suspended so that other scripts which are due can run, and is then resumed where it left off. Scripts which are due are run in order of the priority they set with set_priority(). Zero runs each script to completion in the order they are due. SCR_VM_I_COUNT still limits the total instructions for each run of a script.
+    // @Units: us
+    // @Range: 0 20000
+    // @Increment: 100
+    // @User: Advanced
+    AP_GROUPINFO("SLICE_US", 19, AP_Scripting, _slice_us, 0),
+
 #if AP_SCRIPTING_SERIALDEVICE_ENABLED
     // @Param: SDEV_EN
     // @DisplayName: Scripting serial device enable
@@ -306,7 +315,7 @@ void AP_Scripting::thread(void) {
         _restart = false;
         _init_failed = false;
 
-        lua_scripts *lua = NEW_NOTHROW lua_scripts(_script_vm_exec_count, _script_heap_size, _debug_options);
+        lua_scripts *lua = NEW_NOTHROW lua_scripts(_script_vm_exec_count, _script_heap_size, _debug_options, _slice_us);
         if (lua == nullptr || !lua->heap_allocated()) {
             GCS_SEND_TEXT(MAV_SEVERITY_CRITICAL, "Scripting: %s", "Unable to allocate memory");
             _init_failed = true;
@@ -536,6 +545,11 @@ void AP_Scripting::save_checksum() {
 
 }
 
+void AP_Scripting::mem_info(ExpandingString &str)
+{
+    lua_scripts::mem_info(str);
+}
+
 AP_Scripting *AP_Scripting::_singleton = nullptr;
 
 namespace AP {
@@ -85,6 +85,9 @@ public:
     
     void restart_all(void);
 
+    // memory and CPU statistics for @SYS/scripts.txt
+    void mem_info(class ExpandingString &str);
+
    // User parameters for inputs into scripts 
    AP_Float _user[6];
 
@@ -180,6 +183,7 @@ private:
     AP_Int32 _script_heap_size;
     AP_Int8 _debug_options;
     AP_Int16 _dir_disable;
+    AP_Int16 _slice_us;
     AP_Int32 _required_loaded_checksum;
     AP_Int32 _required_running_checksum;
 
@@ -90,6 +90,11 @@ function millis() end
 ---@return uint32_t_ud -- microseconds
 function micros() end
 
+-- set the priority of this script, when SCR_SLICE_US is non-zero scripts
+-- which are due are run highest priority first, default 0
+---@param priority integer -- 0 to 255
+function set_priority(priority) end
+
 -- receive mission command from running mission
 ---@return uint32_t_ud|nil -- command start time milliseconds
 ---@return integer|nil -- command param 1
@@ -893,13 +898,15 @@ function Vector3f_ud:x(value) end
 
 -- Return a new Vector3 based on this one with scaled length and the same changing direction
 ---@param scale_factor number
+---@param result? Vector3f_ud -- optional Vector3f to write the result into, instead of creating a new one
 ---@return Vector3f_ud -- scaled copy of this vector
-function Vector3f_ud:scale(scale_factor) end
+function Vector3f_ud:scale(scale_factor, result) end
 
 -- Cross product of two Vector3fs
 ---@param vector Vector3f_ud
+---@param result? Vector3f_ud -- optional Vector3f to write the result into, instead of creating a new one
 ---@return Vector3f_ud -- result
-function Vector3f_ud:cross(vector) end
+function Vector3f_ud:cross(vector, result) end
 
 -- Dot product of two Vector3fs
 ---@param vector Vector3f_ud
@@ -1119,8 +1126,9 @@ function Location_ud:get_distance_NE(loc) end
 
 -- Given a Location this calculates the north, east and down distance between the two locations in meters.
 ---@param loc Location_ud -- location to compare with
+---@param result? Vector3f_ud -- optional Vector3f to write the result into, instead of creating a new one
 ---@return Vector3f_ud -- North east down distance vector in meters
-function Location_ud:get_distance_NED(loc) end
+function Location_ud:get_distance_NED(loc, result) end
 
 -- Given a Location this calculates the relative bearing to the location in radians
 ---@param loc Location_ud -- location to compare with
@@ -3347,13 +3355,15 @@ function ahrs:get_EAS2TAS() end
 
 -- desc
 ---@param vector Vector3f_ud
+---@param result? Vector3f_ud -- optional Vector3f to write the result into, instead of creating a new one
 ---@return Vector3f_ud
-function ahrs:body_to_earth(vector) end
+function ahrs:body_to_earth(vector, result) end
 
 -- desc
 ---@param vector Vector3f_ud
+---@param result? Vector3f_ud -- optional Vector3f to write the result into, instead of creating a new one
 ---@return Vector3f_ud
-function ahrs:earth_to_body(vector) end
+function ahrs:earth_to_body(vector, result) end
 
 -- desc
 ---@return Vector3f_ud
@@ -3376,16 +3386,19 @@ function ahrs:home_is_set() end
 function ahrs:get_relative_position_D_home() end
 
 -- desc
+---@param result? Vector3f_ud -- optional Vector3f to write the result into, instead of creating a new one
 ---@return Vector3f_ud|nil
-function ahrs:get_relative_position_NED_origin() end
+function ahrs:get_relative_position_NED_origin(result) end
 
 -- desc
+---@param result? Vector3f_ud -- optional Vector3f to write the result into, instead of creating a new one
 ---@return Vector3f_ud|nil
-function ahrs:get_relative_position_NED_home() end
+function ahrs:get_relative_position_NED_home(result) end
 
 -- Returns nil, or a Vector3f containing the current NED vehicle velocity in meters/second in north, east, and down components.
+---@param result? Vector3f_ud -- optional Vector3f to write the result into, instead of creating a new one
 ---@return Vector3f_ud|nil -- North, east, down velcoity in meters / second if available
-function ahrs:get_velocity_NED() end
+function ahrs:get_velocity_NED(result) end
 
 -- Get current groundspeed vector in meter / second
 ---@return Vector2f_ud -- ground speed vector, North East, meters / second
@@ -3412,12 +3425,14 @@ function ahrs:head_wind() end
 function ahrs:get_hagl() end
 
 -- desc
+---@param result? Vector3f_ud -- optional Vector3f to write the result into, instead of creating a new one
 ---@return Vector3f_ud
-function ahrs:get_accel() end
+function ahrs:get_accel(result) end
 
 -- Returns a Vector3f containing the current smoothed and filtered gyro rates (in radians/second)
+---@param result? Vector3f_ud -- optional Vector3f to write the result into, instead of creating a new one
 ---@return Vector3f_ud -- roll, pitch, yaw gyro rates in radians / second
-function ahrs:get_gyro() end
+function ahrs:get_gyro(result) end
 
 -- Returns a Location that contains the vehicles current home waypoint.
 ---@return Location_ud -- home location
@@ -3425,12 +3440,14 @@ function ahrs:get_home() end
 
 -- Returns nil or Location userdata that contains the vehicles current position.
 -- Note: This will only return a Location if the system considers the current estimate to be reasonable.
+---@param result? Location_ud -- optional Location to write the result into, instead of creating a new one
 ---@return Location_ud|nil -- current location if available
-function ahrs:get_location() end
+function ahrs:get_location(result) end
 
 -- same as `get_location` will be removed
+---@param result? Location_ud -- optional Location to write the result into, instead of creating a new one
 ---@return Location_ud|nil
-function ahrs:get_position() end
+function ahrs:get_position(result) end
 
 -- Returns the current vehicle euler yaw angle in radians.
 ---@return number -- yaw angle in radians.
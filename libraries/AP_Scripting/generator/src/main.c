@@ -32,6 +32,7 @@ char keyword_global[]              = "global";
 char keyword_creation[]            = "creation";
 char keyword_manual_operator[]     = "manual_operator";
 char keyword_operator_getter[]     = "operator_getter";
+char keyword_in_place[]            = "in_place";
 
 // attributes (should include the leading ' )
 char keyword_attr_enum[]    = "'enum";
@@ -359,6 +360,7 @@ struct method {
   char *sanatized_name;  // sanatized name of the C++ singleton
   char *rename; // (optional) used for scripting access
   char *deprecate; // (optional) issue deprecateion warning string on first call
+  int in_place; // (optional) accept an extra argument to write the userdata result into
   int line; // line declared on
   struct type return_type;
   struct argument * arguments;
@@ -763,6 +765,28 @@ void handle_userdata_field(struct userdata *data) {
   field->access_flags = parse_access_flags(&(field->type));
 }
 
+// returns the type of the userdata a method returns, if it is the only
+// result of the method, otherwise NULL. Only these methods can be in_place
+const struct type *in_place_result(const struct method *method) {
+  const struct type *result = NULL;
+  if (method->return_type.type == TYPE_USERDATA) {
+    result = &method->return_type;
+  } else if (method->return_type.type != TYPE_BOOLEAN) {
+    return NULL;
+  }
+  const struct argument *arg = method->arguments;
+  while (arg != NULL) {
+    if (arg->type.flags & (TYPE_FLAGS_NULLABLE | TYPE_FLAGS_REFERNCE)) {
+      if ((result != NULL) || (arg->type.type != TYPE_USERDATA)) {
+        return NULL;
+      }
+      result = &arg->type;
+    }
+    arg = arg->next;
+  }
+  return result;
+}
+
 void handle_method(struct userdata *node) {
   trace(TRACE_USERDATA, "Adding a method");
   char * parent_name = node->name;
@@ -820,6 +844,16 @@ void handle_method(struct userdata *node) {
       string_copy(&(method->dependency), dependency);
       return;
 
+    } else if (strcmp(token, keyword_in_place) == 0) {
+      if (in_place_result(method) == NULL) {
+        error(ERROR_USERDATA, "%s %s must have a single userdata result to be in_place", parent_name, name);
+      }
+      method->in_place = TRUE;
+      if (next_token()) {
+        error(ERROR_USERDATA, "Unexpected token after in_place for %s %s: %s", parent_name, name, state.token);
+      }
+      return;
+
     }
     error(ERROR_USERDATA, "Method %s already exists for %s (declared on %d)", name, parent_name, method->line);
   }
@@ -1831,7 +1865,7 @@ void emit_singleton_fields() {
 }
 
 // emit refences functions for a call, return the number of arduments added
-int emit_references(const struct argument *arg, const char * tab) {
+int emit_references(const struct argument *arg, const char * tab, int in_place) {
   int arg_index = NULLABLE_ARG_COUNT_BASE + 2;
   int return_count = 0;
   // count arguments to return so we know if we need to check the stack
@@ -1870,7 +1904,16 @@ int emit_references(const struct argument *arg, const char * tab) {
           fprintf(source, "%slua_pushstring(L, data_%d);\n", tab, arg_index);
           break;
         case TYPE_USERDATA:
-          fprintf(source, "%s*new_%s(L) = data_%d;\n", tab, arg->type.data.ud.sanatized_name, arg_index);
+          if (in_place) {
+            fprintf(source, "%sif (result_ud != nullptr) {\n", tab);
+            fprintf(source, "%s    *result_ud = data_%d;\n", tab, arg_index);
+            fprintf(source, "%s    lua_pushvalue(L, result_arg);\n", tab);
+            fprintf(source, "%s} else {\n", tab);
+            fprintf(source, "%s    *new_%s(L) = data_%d;\n", tab, arg->type.data.ud.sanatized_name, arg_index);
+            fprintf(source, "%s}\n", tab);
+          } else {
+            fprintf(source, "%s*new_%s(L) = data_%d;\n", tab, arg->type.data.ud.sanatized_name, arg_index);
+          }
           break;
         case TYPE_NONE:
           error(ERROR_INTERNAL, "Attempted to emit a nullable or reference  argument of type none");
@@ -1917,7 +1960,14 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
     }
     arg = arg->next;
   }
-  fprintf(source, "    binding_argcheck(L, %d);\n", arg_count);
+  if (method->in_place) {
+    // an extra argument can be passed to write the result into,
+    // rather than creating a new userdata for it
+    fprintf(source, "    const int result_arg = (lua_gettop(L) > %d) ? %d : 0;\n", arg_count, arg_count + 1);
+    fprintf(source, "    binding_argcheck(L, (result_arg != 0) ? %d : %d);\n", arg_count + 1, arg_count);
+  } else {
+    fprintf(source, "    binding_argcheck(L, %d);\n", arg_count);
+  }
 
   switch (data->ud_type) {
     case UD_USERDATA:
@@ -1955,6 +2005,13 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
     arg = arg->next;
   }
 
+  if (method->in_place) {
+    // check the result argument before taking any semaphore, as a
+    // type error doesn't return
+    const struct type *result = in_place_result(method);
+    fprintf(source, "    %s * result_ud = (result_arg != 0) ? check_%s(L, result_arg) : nullptr;\n", result->data.ud.name, result->data.ud.sanatized_name);
+  }
+
   const char *ud_name = (data->flags & UD_FLAG_LITERAL)?data->name:"ud";
   const char *ud_access = (data->flags & UD_FLAG_REFERENCE)?".":"->";
 
@@ -2107,7 +2164,7 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
   if (method->flags & TYPE_FLAGS_REFERNCE) {
     arg = method->arguments;
     // number of arguments to return
-    return_count += emit_references(arg,"    ");
+    return_count += emit_references(arg,"    ", method->in_place);
   }
 
   switch (method->return_type.type) {
@@ -2116,7 +2173,7 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
         fprintf(source, "    if (data) {\n");
         // we need to emit out nullable arguments, iterate the args again, creating and copying objects, while keeping a new count
         arg = method->arguments;
-        return_count = emit_references(arg,"        ");
+        return_count = emit_references(arg,"        ", method->in_place);
         fprintf(source, "        return %d;\n", return_count);
         fprintf(source, "    }\n");
         fprintf(source, "    return 0;\n");
@@ -2142,7 +2199,16 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
       fprintf(source, "    lua_pushstring(L, data);\n");
       break;
     case TYPE_USERDATA:
-      fprintf(source, "    *new_%s(L) = data;\n", method->return_type.data.ud.sanatized_name);
+      if (method->in_place) {
+        fprintf(source, "    if (result_ud != nullptr) {\n");
+        fprintf(source, "        *result_ud = data;\n");
+        fprintf(source, "        lua_pushvalue(L, result_arg);\n");
+        fprintf(source, "    } else {\n");
+        fprintf(source, "        *new_%s(L) = data;\n", method->return_type.data.ud.sanatized_name);
+        fprintf(source, "    }\n");
+      } else {
+        fprintf(source, "    *new_%s(L) = data;\n", method->return_type.data.ud.sanatized_name);
+      }
       break;
     case TYPE_AP_OBJECT:
       fprintf(source, "    if (data == NULL) {\n");
@@ -2810,6 +2876,15 @@ void emit_docs_method(const char *name, const char *method_name, struct method *
     arg = arg->next;
   }
 
+  // optional userdata to write the result into
+  if (method->in_place) {
+    char *param_name = (char *)allocate(20);
+    sprintf(param_name, "---@param param%i?", count);
+    emit_docs_param_type(*in_place_result(method), param_name, "\n");
+    free(param_name);
+    count++;
+  }
+
   // return type
   if ((method->flags & TYPE_FLAGS_NULLABLE) == 0) {
     emit_docs_return_type(method->return_type, FALSE);
@@ -12,6 +12,7 @@
 #include <AP_Filesystem/AP_Filesystem.h>
 
 #include "lua_bindings.h"
+#include "lua_scripts.h"
 
 #include "lua_boxed_numerics.h"
 #include <AP_Scripting/lua_generated_bindings.h>
@@ -48,6 +49,15 @@ int lua_micros(lua_State *L) {
     return 1;
 }
 
+// set the priority of the calling script for time sliced scheduling
+int lua_set_priority(lua_State *L) {
+    binding_argcheck(L, 1);
+
+    lua_scripts::set_current_priority(get_uint32(L, 1, 0, UINT8_MAX));
+
+    return 0;
+}
+
 #if HAL_GCS_ENABLED
 int lua_mavlink_init(lua_State *L) {
 
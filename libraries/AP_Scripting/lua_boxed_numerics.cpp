@@ -10,7 +10,9 @@
 extern const AP_HAL::HAL& hal;
 
 uint32_t coerce_to_uint32_t(lua_State *L, int arg) {
-    { // userdata
+    // plain numbers are the common case, so don't look up the
+    // userdata metatable for them
+    if (lua_type(L, arg) == LUA_TUSERDATA) {
         const uint32_t * ud = static_cast<uint32_t *>(luaL_testudata(L, arg, "uint32_t"));
         if (ud != nullptr) {
             return *ud;
@@ -40,10 +42,18 @@ uint32_t coerce_to_uint32_t(lua_State *L, int arg) {
 }
 
 uint64_t coerce_to_uint64_t(lua_State *L, int arg) {
-    { // uint64_t userdata
-        const uint64_t * ud = static_cast<uint64_t *>(luaL_testudata(L, arg, "uint64_t"));
-        if (ud != nullptr) {
-            return *ud;
+    if (lua_type(L, arg) == LUA_TUSERDATA) {
+        { // uint64_t userdata
+            const uint64_t * ud = static_cast<uint64_t *>(luaL_testudata(L, arg, "uint64_t"));
+            if (ud != nullptr) {
+                return *ud;
+            }
+        }
+        { // uint32_t userdata
+            const uint32_t * ud = static_cast<uint32_t *>(luaL_testudata(L, arg, "uint32_t"));
+            if (ud != nullptr) {
+                return static_cast<uint64_t>(*ud);
+            }
         }
     }
     { // integer
@@ -55,12 +65,6 @@ uint64_t coerce_to_uint64_t(lua_State *L, int arg) {
             return static_cast<uint64_t>(v);
         }
     }
-    { // uint32_t userdata
-        const uint32_t * ud = static_cast<uint32_t *>(luaL_testudata(L, arg, "uint32_t"));
-        if (ud != nullptr) {
-            return static_cast<uint64_t>(*ud);
-        }
-    }
     { // float
         int success;
         const lua_Number v = lua_tonumberx(L, arg, &success);
@@ -0,0 +1,158 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "lua_pool.h"
+
+#if AP_SCRIPTING_ENABLED
+
+#include <AP_Math/AP_Math.h>
+#include <string.h>
+
+bool lua_pool::init(MultiHeap &heap, uint32_t arena_size)
+{
+    clear();
+
+    // the heap may be split over several memory regions, so settle
+    // for a smaller block if we have to
+    arena_size &= ~uint32_t(granularity-1);
+    while (arena_size >= 1024) {
+        arena = (uint8_t *)heap.allocate(arena_size);
+        if (arena != nullptr) {
+            arena_next = arena;
+            arena_end = arena + arena_size;
+            return true;
+        }
+        arena_size = (arena_size / 2) & ~uint32_t(granularity-1);
+    }
+    return false;
+}
+
+void lua_pool::clear()
+{
+    memset(classes, 0, sizeof(classes));
+    arena = nullptr;
+    arena_next = nullptr;
+    arena_end = nullptr;
+    overflow_allocs = 0;
+}
+
+void *lua_pool::allocate(MultiHeap &heap, uint32_t size)
+{
+    const int8_t c = size_class(size);
+    if (c < 0 || arena == nullptr) {
+        return heap.allocate(size);
+    }
+    auto &sc = classes[c];
+    void *ret;
+    if (sc.free_list != nullptr) {
+        ret = sc.free_list;
+        sc.free_list = sc.free_list->next;
+    } else if (arena_next + class_size(c) <= arena_end) {
+        ret = arena_next;
+        arena_next += class_size(c);
+    } else {
+        overflow_allocs++;
+        return heap.allocate(size);
+    }
+    sc.allocs++;
+    sc.in_use++;
+    sc.peak = MAX(sc.peak, sc.in_use);
+    return ret;
+}
+
+void lua_pool::deallocate(MultiHeap &heap, void *ptr, uint32_t size)
+{
+    if (!owns(ptr)) {
+        heap.deallocate(ptr);
+        return;
+    }
+    const int8_t c = size_class(size);
+    if (c < 0) {
+        // can't happen as only small blocks come from the pools
+        return;
+    }
+    auto &sc = classes[c];
+    free_block *b = (free_block *)ptr;
+    b->next = sc.free_list;
+    sc.free_list = b;
+    sc.in_use--;
+}
+
+void *lua_pool::change_size(MultiHeap &heap, void *ptr, uint32_t old_size, uint32_t new_size)
+{
+    if (new_size == 0) {
+        if (ptr != nullptr) {
+            deallocate(heap, ptr, old_size);
+        }
+        return nullptr;
+    }
+    if (ptr == nullptr || old_size == 0) {
+        // when ptr is null Lua passes the object type in old_size
+        return allocate(heap, new_size);
+    }
+    if (!owns(ptr)) {
+        if (size_class(new_size) < 0) {
+            return heap.change_size(ptr, old_size, new_size);
+        }
+        // a heap block shrinking to a pool size is moved to the pool
+        // below, unless the pool is full
+    } else if (size_class(new_size) == size_class(old_size)) {
+        // still fits in the same block
+        return ptr;
+    }
+
+    void *newptr = allocate(heap, new_size);
+    if (newptr == nullptr) {
+        if (!owns(ptr)) {
+            return heap.change_size(ptr, old_size, new_size);
+        }
+        if (new_size < old_size) {
+            // Lua assumes shrinking can't fail; keep the larger block,
+            // which is then freed as the smaller size
+            classes[size_class(old_size)].in_use--;
+            classes[size_class(new_size)].in_use++;
+            return ptr;
+        }
+        return nullptr;
+    }
+    memcpy(newptr, ptr, MIN(old_size, new_size));
+    deallocate(heap, ptr, old_size);
+    return newptr;
+}
+
+void lua_pool::info(ExpandingString &str) const
+{
+    if (arena == nullptr) {
+        return;
+    }
+    str.printf("Pool: %u/%u bytes used, %u overflowed to heap\n",
+               unsigned(arena_next - arena),
+               unsigned(arena_end - arena),
+               unsigned(overflow_allocs));
+    str.printf("SIZE INUSE    PEAK     ALLOCS\n");
+    for (uint8_t c=0; c<num_classes; c++) {
+        const auto &sc = classes[c];
+        if (sc.allocs == 0) {
+            continue;
+        }
+        str.printf("%-4u %-8u %-8u %u\n",
+                   unsigned(class_size(c)),
+                   unsigned(sc.in_use),
+                   unsigned(sc.peak),
+                   unsigned(sc.allocs));
+    }
+}
+
+#endif  // AP_SCRIPTING_ENABLED
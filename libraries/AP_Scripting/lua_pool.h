@@ -0,0 +1,111 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "AP_Scripting_config.h"
+
+#if AP_SCRIPTING_ENABLED
+
+#include <AP_Common/AP_Common.h>
+#include <AP_Common/ExpandingString.h>
+#include <AP_Common/MultiHeap.h>
+
+/*
+  size-class pools for the small allocations which make up most of
+  the Lua heap traffic (strings, tables, closures and boxed userdata
+  such as Vector3f and Location).
+
+  The pools are carved from a single block taken from the scripting
+  heap. Each size class keeps a free list, so allocating and freeing
+  a small object is a couple of pointer operations and doesn't
+  fragment the main heap. Larger allocations, and small ones once the
+  pool block is used up, go to the heap as before.
+
+  Memory given to the pools is never returned to the heap, so the
+  block is kept to an eighth of the heap and at most
+  LUA_POOL_SIZE_MAX bytes, leaving the rest for larger allocations
+ */
+#ifndef LUA_POOL_SIZE_MAX
+#define LUA_POOL_SIZE_MAX 16384
+#endif
+
+class lua_pool {
+public:
+    // take arena_size bytes from heap for the pools
+    // returns false if the memory isn't available, in which case
+    // all allocations go to the heap
+    bool init(MultiHeap &heap, uint32_t arena_size);
+
+    // forget the pools. The memory is released with the heap
+    void clear();
+
+    // lua_Alloc style allocation: allocate if ptr is nullptr, free if
+    // new_size is zero, otherwise resize.  old_size must be the size
+    // the block was allocated with
+    void *change_size(MultiHeap &heap, void *ptr, uint32_t old_size, uint32_t new_size);
+
+    // print per size class usage
+    void info(ExpandingString &str) const;
+
+private:
+    // size classes are every 8 bytes from 16 to 64
+    static const uint8_t granularity = 8;
+    static const uint8_t min_size = 16;
+    static const uint8_t max_size = 64;
+    static const uint8_t num_classes = (max_size - min_size) / granularity + 1;
+
+    // returns the size class for size, or -1 if it is too large
+    static int8_t size_class(uint32_t size) {
+        if (size > max_size) {
+            return -1;
+        }
+        if (size <= min_size) {
+            return 0;
+        }
+        return (size - min_size + granularity - 1) / granularity;
+    }
+    static uint32_t class_size(uint8_t c) {
+        return min_size + c * granularity;
+    }
+
+    // true if ptr was allocated from the pools
+    bool owns(const void *ptr) const {
+        return (const uint8_t *)ptr >= arena && (const uint8_t *)ptr < arena_end;
+    }
+
+    void *allocate(MultiHeap &heap, uint32_t size);
+    void deallocate(MultiHeap &heap, void *ptr, uint32_t size);
+
+    struct free_block {
+        free_block *next;
+    };
+
+    struct {
+        free_block *free_list;
+        uint32_t in_use;        // blocks currently allocated
+        uint32_t peak;          // highest value of in_use
+        uint32_t allocs;        // total allocations
+    } classes[num_classes];
+
+    uint8_t *arena;         // start of the pool memory
+    uint8_t *arena_next;    // next block never yet handed out
+    uint8_t *arena_end;
+
+    // small allocations which went to the heap because the pool
+    // block was used up
+    uint32_t overflow_allocs;
+};
+
+#endif  // AP_SCRIPTING_ENABLED
@@ -24,6 +24,10 @@
 
 #include <AP_Scripting/lua_generated_bindings.h>
 
+extern "C" {
+#include "lua/src/lstate.h"
+}
+
 #define DISABLE_INTERRUPTS_FOR_SCRIPT_RUN 0
 
 extern const AP_HAL::HAL& hal;
@@ -40,18 +44,57 @@ uint32_t lua_scripts::loaded_checksum;
 uint32_t lua_scripts::running_checksum;
 HAL_Semaphore lua_scripts::crc_sem;
 
-lua_scripts::lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_options)
+lua_scripts::script_info *lua_scripts::current_script;
+uint32_t lua_scripts::hook_steps;
+uint32_t lua_scripts::max_steps;
+uint32_t lua_scripts::slice_us;
+uint32_t lua_scripts::slice_start_us;
+
+uint32_t lua_scripts::alloc_count;
+uint32_t lua_scripts::alloc_bytes;
+int32_t lua_scripts::mem_in_use;
+int32_t lua_scripts::mem_peak;
+lua_scripts::script_stats lua_scripts::_script_stats[max_script_stats];
+HAL_Semaphore lua_scripts::stats_sem;
+
+lua_scripts::lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_options, const AP_Int16 &slice_us)
     : _vm_steps(vm_steps),
-      _debug_options(debug_options)
+      _debug_options(debug_options),
+      _slice_us(slice_us)
 {
     _heap.create(heap_size, 4);
+    if (_heap.available()) {
+        // an eighth of the heap, up to LUA_POOL_SIZE_MAX, is given to
+        // the small allocation pools
+        _pool.init(_heap, MIN(uint32_t(heap_size) / 8, uint32_t(LUA_POOL_SIZE_MAX)));
+    }
+    WITH_SEMAPHORE(stats_sem);
+    memset(_script_stats, 0, sizeof(_script_stats));
+    mem_in_use = 0;
 }
 
 lua_scripts::~lua_scripts() {
+    WITH_SEMAPHORE(stats_sem);
+    _pool.clear();
     _heap.destroy();
 }
 
 void lua_scripts::hook(lua_State *L, lua_Debug *ar) {
+    if (!overtime && current_script != nullptr) {
+        current_script->run_steps += hook_steps;
+        if (current_script->run_steps < max_steps) {
+            // not out of instructions yet, suspend the script if its
+            // time slice is up.  Scripts can't be suspended while in
+            // a C function such as a table.sort() comparison, or in a
+            // coroutine of their own
+            if (slice_us > 0 && AP_HAL::micros() - slice_start_us >= slice_us &&
+                L == current_script->thread && lua_isyieldable(L)) {
+                lua_yield(L, 0);
+            }
+            return;
+        }
+    }
+
     lua_scripts::overtime = true;
 
     // we need to aggressively bail out as we are over time
@@ -127,36 +170,122 @@ int lua_scripts::atpanic(lua_State *L) {
 }
 
 // helper for print and log of runtime stats
-void lua_scripts::update_stats(const char *name, uint32_t run_time, int total_mem, int run_mem)
+void lua_scripts::update_stats(const char *name, const run_stats &stats)
 {
     if ((_debug_options.get() & uint8_t(DebugLevel::RUNTIME_MSG)) != 0) {
         GCS_SEND_TEXT(MAV_SEVERITY_DEBUG, "Lua: Time: %u Mem: %d + %d",
-                                            (unsigned int)run_time,
-                                            (int)total_mem,
-                                            (int)run_mem);
+                                            (unsigned int)stats.run_time_us,
+                                            (int)stats.total_mem,
+                                            (int)stats.run_mem);
     }
+
+    // script names are long paths, use just the file name if it is too long
+    char name_short[16];
+    const char *name_base = strrchr(name, '/');
+    if ((strlen(name) > sizeof(name_short)) && (name_base != nullptr)) {
+        strncpy_noterm(name_short, name_base+1, sizeof(name_short));
+    } else {
+        strncpy_noterm(name_short, name, sizeof(name_short));
+    }
+
+    {
+        WITH_SEMAPHORE(stats_sem);
+        script_stats *free_entry = nullptr;
+        script_stats *entry = nullptr;
+        for (auto &s : _script_stats) {
+            if (s.runs == 0) {
+                if (free_entry == nullptr) {
+                    free_entry = &s;
+                }
+            } else if (strncmp(s.name, name_short, sizeof(s.name)) == 0) {
+                entry = &s;
+                break;
+            }
+        }
+        if (entry == nullptr && free_entry != nullptr) {
+            entry = free_entry;
+            memcpy(entry->name, name_short, sizeof(entry->name));
+        }
+        if (entry != nullptr) {
+            entry->runs++;
+            entry->time_us += stats.run_time_us;
+            entry->max_time_us = MAX(entry->max_time_us, stats.run_time_us);
+            entry->instructions = stats.instructions;
+            entry->allocs = stats.allocs;
+            entry->alloc_bytes += stats.alloc_bytes;
+            entry->gc_time_us += stats.gc_time_us;
+            entry->peak_mem = MAX(entry->peak_mem, stats.peak_mem);
+            entry->priority = stats.priority;
+            if (stats.load) {
+                entry->load_time_us = stats.run_time_us;
+            }
+        }
+    }
+
 #if HAL_LOGGING_ENABLED
     if ((_debug_options.get() & uint8_t(DebugLevel::LOG_RUNTIME)) != 0) {
         struct log_Scripting pkt {
             LOG_PACKET_HEADER_INIT(LOG_SCRIPTING_MSG),
             time_us      : AP_HAL::micros64(),
             name         : {},
-            run_time     : run_time,
-            total_mem    : total_mem,
-            run_mem      : run_mem
+            run_time     : stats.run_time_us,
+            total_mem    : stats.total_mem,
+            run_mem      : stats.run_mem,
+            allocs       : stats.allocs,
+            peak_mem     : stats.peak_mem,
+            instructions : stats.instructions,
+            alloc_bytes  : stats.alloc_bytes,
+            gc_time      : stats.gc_time_us,
+            priority     : stats.priority,
+            suspended    : stats.suspended
         };
-        const char * name_short = strrchr(name, '/');
-        if ((strlen(name) > sizeof(pkt.name)) && (name_short != nullptr)) {
-            strncpy_noterm(pkt.name, name_short+1, sizeof(pkt.name));
-        } else {
-            strncpy_noterm(pkt.name, name, sizeof(pkt.name));
-        }
+        static_assert(sizeof(pkt.name) == sizeof(name_short), "name size");
+        memcpy(pkt.name, name_short, sizeof(pkt.name));
         AP::logger().WriteBlock(&pkt, sizeof(pkt));
     }
 #endif // HAL_LOGGING_ENABLED
 }
 
+/*
+  memory and CPU statistics for @SYS/scripts.txt
+ */
+void lua_scripts::mem_info(ExpandingString &str)
+{
+    str.printf("LUAMEMV3\n");
+    str.printf("Heap: %d bytes in use\n", int(mem_in_use));
+    _pool.info(str);
+
+    WITH_SEMAPHORE(stats_sem);
+    str.printf("NAME             PRI RUNS     TIME_US    MAX_US   INSN     ALLOCS   ALLOC_B    GC_US      LOAD_US  PEAK\n");
+    for (const auto &s : _script_stats) {
+        if (s.runs == 0) {
+            continue;
+        }
+        str.printf("%-16.16s %-3u %-8u %-10u %-8u %-8u %-8u %-10u %-10u %-8u %d\n",
+                   s.name,
+                   unsigned(s.priority),
+                   unsigned(s.runs),
+                   unsigned(s.time_us),
+                   unsigned(s.max_time_us),
+                   unsigned(s.instructions),
+                   unsigned(s.allocs),
+                   unsigned(s.alloc_bytes),
+                   unsigned(s.gc_time_us),
+                   unsigned(s.load_time_us),
+                   int(s.peak_mem));
+    }
+}
+
+void lua_scripts::set_current_priority(uint8_t priority)
+{
+    if (current_script != nullptr) {
+        current_script->priority = priority;
+    }
+}
+
 lua_scripts::script_info *lua_scripts::load_script(lua_State *L, char *filename) {
+    const uint32_t loadStart = AP_HAL::micros();
+
     if (int error = luaL_loadfile(L, filename)) {
         switch (error) {
             case LUA_ERRSYNTAX:
@@ -179,7 +308,9 @@ lua_scripts::script_info *lua_scripts::load_script(lua_State *L, char *filename)
     }
 
     const int loadMem = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
-    const uint32_t loadStart = AP_HAL::micros();
+    alloc_count = 0;
+    alloc_bytes = 0;
+    mem_peak = mem_in_use;
 
     script_info *new_script = (script_info *)_heap.allocate(sizeof(script_info));
     if (new_script == nullptr) {
@@ -197,12 +328,31 @@ lua_scripts::script_info *lua_scripts::load_script(lua_State *L, char *filename)
     const uint32_t loadEnd = AP_HAL::micros();
     const int endMem = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
 
-    update_stats(filename, loadEnd-loadStart, endMem, loadMem);
+    const run_stats stats {
+        run_time_us : loadEnd-loadStart,
+        total_mem : endMem,
+        run_mem : loadMem,
+        allocs : alloc_count,
+        alloc_bytes : alloc_bytes,
+        peak_mem : mem_peak,
+        load : true,
+    };
+    update_stats(filename, stats);
+
+    if ((_debug_options.get() & uint8_t(DebugLevel::RUNTIME_MSG)) != 0) {
+        GCS_SEND_TEXT(MAV_SEVERITY_DEBUG, "Lua: Loaded %s in %u us", filename,
+                      unsigned(stats.run_time_us));
+    }
 
     new_script->name = filename;
     new_script->env_ref = luaL_ref(L, LUA_REGISTRYINDEX); // store reference to script's environment
     new_script->run_ref = luaL_ref(L, LUA_REGISTRYINDEX); // store reference to function to run
     new_script->next_run_ms = AP_HAL::millis64() - 1; // force the script to be stale
+    new_script->thread = lua_newthread(L);
+    new_script->thread_ref = luaL_ref(L, LUA_REGISTRYINDEX); // keep the thread from being collected
+    new_script->run_steps = 0;
+    new_script->priority = 0;
+    new_script->suspended = false;
 
     // Get checksum of file
     uint32_t crc = 0;
@@ -305,47 +455,95 @@ void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
 
 void lua_scripts::reset_loop_overtime(lua_State *L) {
     overtime = false;
+    max_steps = MAX(_vm_steps, 1000);
+    slice_us = MAX(_slice_us, 0);
+    // when time slicing the hook is called more often so the time
+    // can be checked, the script is still only allowed max_steps
+    hook_steps = slice_us > 0 ? MIN(max_steps, 1000U) : max_steps;
     // reset the hook to clear the counter
-    const int32_t vm_steps = MAX(_vm_steps, 1000);
-    lua_sethook(L, hook, LUA_MASKCOUNT, vm_steps);
+    lua_sethook(L, hook, LUA_MASKCOUNT, hook_steps);
 }
 
-void lua_scripts::run_next_script(lua_State *L) {
-    if (scripts == nullptr) {
+lua_scripts::script_info *lua_scripts::next_script(uint64_t now_ms) const {
+    script_info *script = scripts;
+    if (script == nullptr || _slice_us <= 0) {
+        return script;
+    }
+    // the list is sorted by next run time, so amongst scripts of
+    // equal priority the one that has been waiting longest is chosen
+    for (script_info *s = script->next; s != nullptr && s->next_run_ms <= now_ms; s = s->next) {
+        if (s->priority > script->priority) {
+            script = s;
+        }
+    }
+    return script;
+}
+
+void lua_scripts::run_next_script(lua_State *L, script_info *script, run_stats &stats) {
+    if (script == nullptr) {
 #if defined(AP_SCRIPTING_CHECKS) && AP_SCRIPTING_CHECKS >= 1
         AP_HAL::panic("Lua: Attempted to run a script without any scripts queued");
 #endif // defined(AP_SCRIPTING_CHECKS) && AP_SCRIPTING_CHECKS >= 1
         return;
     }
 
-    uint64_t start_time_ms = AP_HAL::millis64();
     // strip the selected script out of the list
-    script_info *script = scripts;
-    scripts = script->next;
+    unlink_script(script);
 
-    // reset the hook to clear the counter
-    reset_loop_overtime(L);
+    // each script runs in its own thread, so it can be suspended when
+    // its time slice is up and resumed later
+    lua_State *T = script->thread;
+
+    if (!script->suspended) {
+        script->run_start_ms = AP_HAL::millis64();
+        script->run_steps = 0;
 
-    // store top of stack so we can calculate the number of return values
-    int stack_top = lua_gettop(L);
+        // reset the hook to clear the counter
+        reset_loop_overtime(T);
+
+        // push the function onto the thread's stack
+        lua_rawgeti(T, LUA_REGISTRYINDEX, script->run_ref);
+    }
 
-    // pop the function to the top of the stack
-    lua_rawgeti(L, LUA_REGISTRYINDEX, script->run_ref);
     // set current environment for other users
     AP::scripting()->set_current_env_ref(script->env_ref);
 
-    if(lua_pcall(L, 0, LUA_MULTRET, 0)) {
+    current_script = script;
+    slice_start_us = AP_HAL::micros();
+    const int status = lua_resume(T, L, 0);
+    current_script = nullptr;
+
+    // add the instructions run since hook() last counted them. When
+    // hook() suspended the script Lua leaves hookcount at 1 to
+    // trigger a reset on resume, and hook() has already counted them
+    uint32_t uncounted_steps = T->basehookcount - T->hookcount;
+    if (status == LUA_YIELD && (T->ci->callstatus & CIST_HOOKYIELD)) {
+        uncounted_steps = 0;
+    }
+    stats.instructions = script->run_steps + uncounted_steps;
+    stats.priority = script->priority;
+    stats.suspended = (status == LUA_YIELD);
+    script->suspended = stats.suspended;
+
+    if (status == LUA_YIELD) {
+        // out of time, let anything else that is due run first
+        lua_pop(T, lua_gettop(T));
+        script->next_run_ms = AP_HAL::millis64();
+        reschedule_script(script);
+        return;
+    }
+
+    if (status != LUA_OK) {
         if (overtime) {
             // script has consumed an excessive amount of CPU time
             set_and_print_new_error_message(MAV_SEVERITY_CRITICAL, "%s exceeded time limit", script->name);
         } else {
-            set_and_print_new_error_message(MAV_SEVERITY_CRITICAL, "%s", lua_tostring(L, -1));
+            set_and_print_new_error_message(MAV_SEVERITY_CRITICAL, "%s", lua_tostring(T, -1));
         }
         remove_script(L, script);
-        lua_pop(L, 1);
         return;
     } else {
-        int returned = lua_gettop(L) - stack_top;
+        int returned = lua_gettop(T);
         switch (returned) {
             case 0:
                 // no time to reschedule so bail out
@@ -354,25 +552,25 @@ void lua_scripts::run_next_script(lua_State *L) {
             case 2:
                 {
                     // sanity check the return types
-                    if (lua_type(L, -1) != LUA_TNUMBER) {
-                        set_and_print_new_error_message(MAV_SEVERITY_CRITICAL, "%s did not return a delay (0x%d)", script->name, lua_type(L, -1));
-                        lua_pop(L, 2);
+                    if (lua_type(T, -1) != LUA_TNUMBER) {
+                        set_and_print_new_error_message(MAV_SEVERITY_CRITICAL, "%s did not return a delay (0x%d)", script->name, lua_type(T, -1));
+                        lua_pop(T, 2);
                         remove_script(L, script);
                         return;
                     }
-                    if (lua_type(L, -2) != LUA_TFUNCTION) {
-                        set_and_print_new_error_message(MAV_SEVERITY_CRITICAL, "%s did not return a function (0x%d)", script->name, lua_type(L, -2));
-                        lua_pop(L, 2);
+                    if (lua_type(T, -2) != LUA_TFUNCTION) {
+                        set_and_print_new_error_message(MAV_SEVERITY_CRITICAL, "%s did not return a function (0x%d)", script->name, lua_type(T, -2));
+                        lua_pop(T, 2);
                         remove_script(L, script);
                         return;
                     }
 
                     // types match the expectations, go ahead and reschedule
-                    script->next_run_ms = start_time_ms + (uint64_t)luaL_checknumber(L, -1);
-                    lua_pop(L, 1);
+                    script->next_run_ms = script->run_start_ms + (uint64_t)luaL_checknumber(T, -1);
+                    lua_pop(T, 1);
                     int old_ref = script->run_ref;
-                    script->run_ref = luaL_ref(L, LUA_REGISTRYINDEX);
-                    luaL_unref(L, LUA_REGISTRYINDEX, old_ref);
+                    script->run_ref = luaL_ref(T, LUA_REGISTRYINDEX);
+                    luaL_unref(T, LUA_REGISTRYINDEX, old_ref);
                     reschedule_script(script);
                     break;
                 }
@@ -381,19 +579,14 @@ void lua_scripts::run_next_script(lua_State *L) {
                     set_and_print_new_error_message(MAV_SEVERITY_CRITICAL, "%s returned bad result count (%d)", script->name, returned);
                     remove_script(L, script);
                     // pop all the results we got that we didn't expect
-                    lua_pop(L, returned);
+                    lua_pop(T, returned);
                     break;
                  }
          }
      }
 }
 
-void lua_scripts::remove_script(lua_State *L, script_info *script) {
-    if (script == nullptr) {
-        return;
-    }
-
-    // ensure that the script isn't in the loaded list for any reason
+void lua_scripts::unlink_script(script_info *script) {
     if (scripts == nullptr) {
         // nothing to do, already not in the list
     } else if (scripts == script) {
@@ -406,6 +599,15 @@ void lua_scripts::remove_script(lua_State *L, script_info *script) {
             }
         }
     }
+}
+
+void lua_scripts::remove_script(lua_State *L, script_info *script) {
+    if (script == nullptr) {
+        return;
+    }
+
+    // ensure that the script isn't in the loaded list for any reason
+    unlink_script(script);
 
     {
         // Remove from running checksum
@@ -417,6 +619,7 @@ void lua_scripts::remove_script(lua_State *L, script_info *script) {
         // state could be null if we are force killing all scripts
         luaL_unref(L, LUA_REGISTRYINDEX, script->env_ref);
         luaL_unref(L, LUA_REGISTRYINDEX, script->run_ref);
+        luaL_unref(L, LUA_REGISTRYINDEX, script->thread_ref);
     }
     _heap.deallocate(script->name);
     _heap.deallocate(script);
@@ -458,10 +661,22 @@ void lua_scripts::reschedule_script(script_info *script) {
 }
 
 MultiHeap lua_scripts::_heap;
+lua_pool lua_scripts::_pool;
 
 void *lua_scripts::alloc(void *ud, void *ptr, size_t osize, size_t nsize) {
     (void)ud; /* not used */
-    return _heap.change_size(ptr, osize, nsize);
+    void *ret = _pool.change_size(_heap, ptr, osize, nsize);
+    if (ret == nullptr && nsize != 0) {
+        return nullptr;
+    }
+    if (nsize != 0) {
+        alloc_count++;
+        alloc_bytes += nsize;
+    }
+    // when ptr is null osize holds the object type, not a size
+    mem_in_use += int32_t(nsize) - (ptr != nullptr ? int32_t(osize) : 0);
+    mem_peak = MAX(mem_peak, mem_in_use);
+    return ret;
 }
 
 void lua_scripts::run(void) {
@@ -564,27 +779,33 @@ void lua_scripts::run(void) {
                 hal.scheduler->delay(scripts->next_run_ms - now_ms);
             }
 
+            script_info *script = next_script(AP_HAL::millis64());
+
             if ((_debug_options.get() & uint8_t(DebugLevel::RUNTIME_MSG)) != 0) {
-                GCS_SEND_TEXT(MAV_SEVERITY_DEBUG, "Lua: Running %s", scripts->name);
+                GCS_SEND_TEXT(MAV_SEVERITY_DEBUG, "Lua: Running %s", script->name);
             }
             // take a copy of the script name for the purposes of
-            // logging statistics.  "scripts" may become invalid
+            // logging statistics.  "script" may become invalid
             // during the "run_next_script" call, below.
             char script_name[128+1] {};
-            strncpy_noterm(script_name, scripts->name, 128);
+            strncpy_noterm(script_name, script->name, 128);
 
 #if DISABLE_INTERRUPTS_FOR_SCRIPT_RUN
             void *istate = hal.scheduler->disable_interrupts_save();
 #endif
 
             const int startMem = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+            alloc_count = 0;
+            alloc_bytes = 0;
+            mem_peak = mem_in_use;
             const uint32_t loadEnd = AP_HAL::micros();
 
             // NOTE!  the base pointer of our scripts linked list,
             // *and all its contents* may become invalid as part of
             // "run_next_script"!  So do *NOT* attempt to access
             // anything that was in *scripts after this call.
-            run_next_script(L);
+            run_stats stats {};
+            run_next_script(L, script, stats);
 
             const uint32_t runEnd = AP_HAL::micros();
             const int endMem = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
@@ -593,11 +814,20 @@ void lua_scripts::run(void) {
             hal.scheduler->restore_interrupts(istate);
 #endif
 
-            update_stats(script_name, runEnd - loadEnd, endMem, endMem - startMem);
-
+            stats.run_time_us = runEnd - loadEnd;
+            stats.total_mem = endMem;
+            stats.run_mem = endMem - startMem;
+            stats.allocs = alloc_count;
+            stats.alloc_bytes = alloc_bytes;
+            stats.peak_mem = mem_peak;
+
+            if (!stats.suspended) {
+                // garbage collect after each script, this shouldn't matter, but seems to resolve a memory leak
+                lua_gc(L, LUA_GCCOLLECT, 0);
+                stats.gc_time_us = AP_HAL::micros() - runEnd;
+            }
 
-            // garbage collect after each script, this shouldn't matter, but seems to resolve a memory leak
-            lua_gc(L, LUA_GCCOLLECT, 0);
+            update_stats(script_name, stats);
 
         } else {
             if ((_debug_options.get() & uint8_t(DebugLevel::NO_SCRIPTS_TO_RUN)) != 0) {
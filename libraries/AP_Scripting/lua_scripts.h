@@ -28,13 +28,14 @@
 #include <AP_HAL/Semaphores.h>
 #include <AP_Common/MultiHeap.h>
 #include "lua_common_defs.h"
+#include "lua_pool.h"
 
 #include "lua/src/lua.hpp"
 
 class lua_scripts
 {
 public:
-    lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_options);
+    lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_options, const AP_Int16 &slice_us);
 
     ~lua_scripts();
 
@@ -65,18 +66,46 @@ private:
        int env_ref;          // reference to the script's environment table
        int run_ref;          // reference to the function to run
        uint64_t next_run_ms; // time (in milliseconds) the script should next be run at
+       uint64_t run_start_ms; // time (in milliseconds) the current run started
        uint32_t crc;         // crc32 checksum
        char *name;           // filename for the script // FIXME: This information should be available from Lua
+       lua_State *thread;    // Lua thread the script runs in, so it can be suspended
+       int thread_ref;       // reference to the thread
+       uint32_t run_steps;   // VM instructions used by the current run
+       uint8_t priority;     // higher priority scripts are run first when time slicing
+       bool suspended;       // time slice ran out part way through a run
        script_info *next;
     } script_info;
 
+    // statistics for one run, or time slice, of a script
+    struct run_stats {
+        uint32_t run_time_us;
+        int32_t total_mem;
+        int32_t run_mem;
+        uint32_t allocs;
+        uint32_t alloc_bytes;
+        int32_t peak_mem;
+        uint32_t instructions;
+        uint32_t gc_time_us;
+        uint8_t priority;
+        bool suspended;
+        bool load;              // stats are for loading the script
+    };
+
     script_info *load_script(lua_State *L, char *filename);
 
     void reset_loop_overtime(lua_State *L);
 
     void load_all_scripts_in_dir(lua_State *L, const char *dirname);
 
-    void run_next_script(lua_State *L);
+    // return the script to run next. When time slicing this is the
+    // highest priority script which is due
+    script_info *next_script(uint64_t now_ms) const;
+
+    void run_next_script(lua_State *L, script_info *script, run_stats &stats);
+
+    // take the script out of the list of scripts to be run
+    void unlink_script(script_info *script);
 
     void remove_script(lua_State *L, script_info *script);
 
@@ -97,13 +126,47 @@ private:
 
     const AP_Int32 & _vm_steps;
     const AP_Int8 & _debug_options;
+    const AP_Int16 & _slice_us;
+
+    // state for the instruction count hook
+    static script_info *current_script;
+    static uint32_t hook_steps;     // instructions between calls to the hook
+    static uint32_t max_steps;      // instructions allowed for a run
+    static uint32_t slice_us;       // time slice length, zero to run scripts to completion
+    static uint32_t slice_start_us;
 
     static void *alloc(void *ud, void *ptr, size_t osize, size_t nsize);
 
     static MultiHeap _heap;
+    static lua_pool _pool;
+
+    // allocations made, and the highest memory in use, since the
+    // current script was started
+    static uint32_t alloc_count;
+    static uint32_t alloc_bytes;
+    static int32_t mem_in_use;
+    static int32_t mem_peak;
 
     // helper for print and log of runtime stats
-    void update_stats(const char *name, uint32_t run_time, int total_mem, int run_mem);
+    void update_stats(const char *name, const run_stats &stats);
+
+    // per-script statistics for @SYS/scripts.txt
+    struct script_stats {
+        char name[16];
+        uint32_t runs;          // runs and time slices
+        uint32_t time_us;       // total run time
+        uint32_t max_time_us;   // longest run or time slice
+        uint32_t instructions;  // VM instructions used by the last run
+        uint32_t allocs;        // allocations made in the last run
+        uint32_t alloc_bytes;   // total bytes allocated
+        uint32_t gc_time_us;    // total time spent collecting garbage after runs
+        int32_t peak_mem;       // highest memory use of any run
+        uint32_t load_time_us;  // time to compile and set up the script
+        uint8_t priority;
+    };
+    static const uint8_t max_script_stats = 16;
+    static script_stats _script_stats[max_script_stats];
+    static HAL_Semaphore stats_sem;
 
     // must be static for use in atpanic
     static void print_error(MAV_SEVERITY severity);
@@ -131,6 +194,12 @@ public:
     static uint32_t get_loaded_checksum();
     static uint32_t get_running_checksum();
 
+    // memory and CPU statistics for @SYS/scripts.txt
+    static void mem_info(ExpandingString &str);
+
+    // set the priority of the running script, used by the set_priority() binding
+    static void set_current_priority(uint8_t priority);
+
 };
 
 #endif  // AP_SCRIPTING_ENABLED
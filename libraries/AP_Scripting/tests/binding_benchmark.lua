@@ -0,0 +1,43 @@
+-- benchmark of binding calls, comparing methods returning a new
+-- userdata with the same methods writing their result in place, and
+-- uint32_t arithmetic with plain number arguments
+
+local iterations = 2000
+local loop_time = 5000 -- number of ms between runs
+
+local function time_loop(name, fn)
+  local start = micros()
+  for _ = 1, iterations do
+    fn()
+  end
+  local us = (micros() - start):toint()
+  gcs:send_text(6, string.format("bench %s: %.2f us/call", name, us / iterations))
+  return us
+end
+
+local loc = Location()
+local v = Vector3f()
+local w = Vector3f()
+local out = Vector3f()
+v:x(1)
+w:y(1)
+
+local function update()
+  collectgarbage("collect")
+  local mem_start = collectgarbage("count")
+
+  time_loop("get_location", function() local _ = ahrs:get_location() end)
+  time_loop("get_location in place", function() ahrs:get_location(loc) end)
+  time_loop("get_gyro", function() local _ = ahrs:get_gyro() end)
+  time_loop("get_gyro in place", function() ahrs:get_gyro(out) end)
+  time_loop("cross", function() local _ = v:cross(w) end)
+  time_loop("cross in place", function() v:cross(w, out) end)
+
+  local u = uint32_t(0)
+  time_loop("uint32_t add", function() u = u + 1 end)
+
+  gcs:send_text(6, string.format("bench garbage: %.1f kB", collectgarbage("count") - mem_start))
+  return update, loop_time
+end
+
+return update, loop_time
@@ -30,8 +30,8 @@ const AP_Param::GroupInfo AP_SmartRTL::var_info[] = {
 
     // @Param: POINTS
     // @DisplayName: SmartRTL maximum number of points on path
-    // @Description: SmartRTL maximum number of points on path. Set to 0 to disable SmartRTL.  100 points consumes about 3k of memory.
-    // @Range: 0 500
+    // @Description: SmartRTL maximum number of points on path. Set to 0 to disable SmartRTL.  100 points consumes about 1.9k of memory.
+    // @Range: 0 2000
     // @User: Advanced
     // @RebootRequired: True
     AP_GROUPINFO("POINTS", 1, AP_SmartRTL, _points_max, SMARTRTL_POINTS_DEFAULT),
@@ -62,7 +62,8 @@ const AP_Param::GroupInfo AP_SmartRTL::var_info[] = {
 *    points when their line segments get close. This algorithm will never
 *    compare two consecutive line segments. Obviously the segments (p1,p2) and
 *    (p2,p3) will get very close (they touch), but there would be nothing to
-*    trim between them.
+*    trim between them.  A grid of cells covering the path (the loop index) is
+*    used so that each segment is only compared with segments passing nearby.
 *
 *    2. Simplification uses the Ramer-Douglas-Peucker algorithm. See Wikipedia
 *    for a more complete description.
@@ -81,6 +82,10 @@ const AP_Param::GroupInfo AP_SmartRTL::var_info[] = {
 *    which is run as the vehicle initiates the SmartRTL flight mode, waits for
 *    these flags to become true.  This can force the vehicle to pause for a few
 *    seconds before initiating the return journey.
+*
+*    Points are packed into 9 bytes (see pack_point) so that long paths can be
+*    held in memory.  The loop index adds a little over 2 bytes per point, so
+*    the path and index together use less memory than unpacked points alone.
 */
 
 AP_SmartRTL::AP_SmartRTL(bool example_mode) :
@@ -107,7 +112,7 @@ void AP_SmartRTL::init()
     }
 
     // allocate arrays
-    _path = (Vector3f*)calloc(_points_max, sizeof(Vector3f));
+    _path = (PackedPoint*)calloc(_points_max, sizeof(PackedPoint));
 
     _prune.loops_max = _points_max * SMARTRTL_PRUNING_LOOP_BUFFER_LEN_MULT;
     _prune.loops = (prune_loop_t*)calloc(_prune.loops_max, sizeof(prune_loop_t));
@@ -127,6 +132,17 @@ void AP_SmartRTL::init()
 
     _path_points_max = _points_max;
 
+    // allocate loop index.  failure is not fatal because detect_loops can check every segment instead
+    _loop_index.num_cells_max = constrain_int16(ceilf(safe_sqrt(_points_max * (1.0f / SMARTRTL_LOOP_INDEX_POINTS_PER_CELL))), 1, SMARTRTL_LOOP_INDEX_CELLS_MAX);
+    _loop_index.cell_start = (uint16_t*)calloc(sq(_loop_index.num_cells_max) + 2, sizeof(uint16_t));
+    _loop_index.segments = (uint16_t*)calloc(_points_max, sizeof(uint16_t));
+    if (_loop_index.cell_start == nullptr || _loop_index.segments == nullptr) {
+        free(_loop_index.cell_start);
+        _loop_index.cell_start = nullptr;
+        free(_loop_index.segments);
+        _loop_index.segments = nullptr;
+    }
+
     // when running the example sketch, we want the cleanup tasks to run when we tell them to, not in the background (so that they can be timed.)
     if (!_example_mode){
         // register background cleanup to run in IO thread
@@ -161,7 +177,7 @@ bool AP_SmartRTL::pop_point(Vector3f& point)
     }
 
     // return last point and remove from path
-    point = _path[--_path_points_count];
+    point = unpack_point(_path[--_path_points_count]);
 
     // record count of last point popped
     _path_points_completed_limit = _path_points_count;
@@ -191,7 +207,7 @@ bool AP_SmartRTL::peek_point(Vector3f& point)
     }
 
     // return last point
-    point = _path[_path_points_count-1];
+    point = unpack_point(_path[_path_points_count-1]);
 
     _path_sem.give();
     return true;
@@ -268,7 +284,11 @@ void AP_SmartRTL::update(bool position_ok, const Vector3f& current_pos)
             _last_position_save_ms = now;
         } else if (AP_HAL::millis() - _last_position_save_ms > SMARTRTL_TIMEOUT) {
             // deactivate after timeout due to failure to save points to path (most likely due to buffer filling up)
-            deactivate(Action::DEACTIVATED_PATH_FULL_TIMEOUT, "buffer full");
+            if (_add_failure == Action::ADD_FAILED_OUT_OF_RANGE) {
+                deactivate(Action::DEACTIVATED_OUT_OF_RANGE_TIMEOUT, "too far from origin");
+            } else {
+                deactivate(Action::DEACTIVATED_PATH_FULL_TIMEOUT, "buffer full");
+            }
         }
     } else {
         // check for timeout due to bad position
@@ -322,13 +342,14 @@ bool AP_SmartRTL::add_point(const Vector3f& point)
 {
     // get semaphore
     if (!_path_sem.take_nonblocking()) {
+        _add_failure = Action::ADD_FAILED_NO_SEMAPHORE;
         log_action(Action::ADD_FAILED_NO_SEMAPHORE, point);
         return false;
     }
 
     // check if we have traveled far enough
     if (_path_points_count > 0) {
-        const Vector3f& last_pos = _path[_path_points_count-1];
+        const Vector3f last_pos = unpack_point(_path[_path_points_count-1]);
         if (last_pos.distance_squared(point) < sq(_accuracy.get())) {
             _path_sem.give();
             return true;
@@ -338,12 +359,22 @@ bool AP_SmartRTL::add_point(const Vector3f& point)
     // check we have space in the path
     if (_path_points_count >= _path_points_max) {
         _path_sem.give();
+        _add_failure = Action::ADD_FAILED_PATH_FULL;
         log_action(Action::ADD_FAILED_PATH_FULL, point);
         return false;
     }
 
+    // check point can be stored
+    PackedPoint packed_point;
+    if (!pack_point(point, packed_point)) {
+        _path_sem.give();
+        _add_failure = Action::ADD_FAILED_OUT_OF_RANGE;
+        log_action(Action::ADD_FAILED_OUT_OF_RANGE, point);
+        return false;
+    }
+
     // add point to path
-    _path[_path_points_count++] = point;
+    _path[_path_points_count++] = packed_point;
     log_action(Action::POINT_ADD, point);
 
     _path_sem.give();
@@ -523,12 +554,14 @@ void AP_SmartRTL::detect_simplifications()
         const uint16_t end_index = tmp.finish;
 
         // find the point between start and end points that is farthest from the start-end line segment
+        const Vector3f start_point = unpack_point(_path[start_index]);
+        const Vector3f end_point = unpack_point(_path[end_index]);
         float max_dist = 0.0f;
         uint16_t farthest_point_index = start_index;
         for (uint16_t i = start_index + 1; i < end_index; i++) {
             // only check points that have not already been flagged for simplification
             if (_simplify.bitmask.get(i)) {
-                const float dist = _path[i].distance_to_segment(_path[start_index], _path[end_index]);
+                const float dist = unpack_point(_path[i]).distance_to_segment(start_point, end_point);
                 if (dist > max_dist) {
                     farthest_point_index = i;
                     max_dist = dist;
@@ -562,6 +595,7 @@ void AP_SmartRTL::detect_simplifications()
 *   This method runs for the allotted time, and detects loops in a path. Any detected loops are added to _prune.loops,
 *   this function does not alter the path in memory. It works by comparing the line segment between any two sequential points
 *   to the line segment between any other two sequential points. If they get close enough, anything between them could be pruned.
+*   The loop index is used so that only segments passing nearby are compared.
 *
 *   reset_pruning should have been called at least once before this function is called to setup the indexes (_prune.i, etc)
 */
@@ -576,36 +610,205 @@ void AP_SmartRTL::detect_loops()
     // capture start time
     const uint32_t start_time_us = AP_HAL::micros();
 
+    // build the loop index once for each pruning run.  if this fails every segment will be checked
+    if (!_prune.index_built) {
+        build_loop_index();
+        _prune.index_built = true;
+    }
+
     // run for defined amount of time
     while (AP_HAL::micros() - start_time_us < SMARTRTL_PRUNING_LOOP_TIME_US) {
 
-        // advance inner loop
-        _prune.j++;
-        if (_prune.j > _prune.i - 2) {
-            // set inner loop back to first point
-            _prune.j = 1;
-            // reduce outer loop
-            _prune.i--;
-            // complete when outer loop has run out of new points to check
-            if (_prune.i < 4 || _prune.i < _prune.path_points_completed) {
+        // find the first segment which gets close to the current segment
+        uint16_t j;
+        dist_point dp;
+        bool found;
+        if (_loop_index.valid) {
+            found = find_loop_indexed(_prune.i, j, dp);
+        } else {
+            // without the index every earlier segment is checked, so check them a few at a time to keep within the time limit
+            const uint16_t k_end = MIN(_prune.k + SMARTRTL_PRUNING_SEGMENTS_PER_CHECK, _prune.i - 1);
+            found = find_loop_all_segments(_prune.i, _prune.k, k_end, j, dp);
+            if (!found && (_prune.k < _prune.i - 1)) {
+                // more segments to check against this segment
+                continue;
+            }
+        }
+        if (found) {
+            // if there is a loop here, add to loop array
+            if (!add_loop(j, _prune.i-1, dp.midpoint)) {
+                // if the buffer is full, stop trying to prune
                 _prune.complete = true;
-                _prune.path_points_completed = _prune.path_points_count;
                 return;
             }
         }
 
+        // move to previous segment
+        _prune.i--;
+        _prune.k = 1;
+        // complete when we have run out of new points to check
+        if (_prune.i < 4 || _prune.i < _prune.path_points_completed) {
+            _prune.complete = true;
+            _prune.path_points_completed = _prune.path_points_count;
+            return;
+        }
+    }
+}
+
+// find the first segment (j-1 to j) on the path which comes close to segment i-1 to i, checking every segment
+// from k up to (but not including) k_end.  k is advanced past the segments checked so the search can be resumed
+// returns true and fills in j and dp (the closest distance and midpoint) if found
+bool AP_SmartRTL::find_loop_all_segments(uint16_t i, uint16_t& k, uint16_t k_end, uint16_t& j, dist_point& dp) const
+{
+    const Vector3f seg_start = unpack_point(_path[i]);
+    const Vector3f seg_end = unpack_point(_path[i-1]);
+    k_end = MIN(k_end, i - 1);
+    if (k >= k_end) {
+        return false;
+    }
+    Vector3f prev_point = unpack_point(_path[k-1]);
+    for (; k < k_end; k++) {
         // find the closest distance between two line segments and the mid-point
-        dist_point dp = segment_segment_dist(_path[_prune.i], _path[_prune.i-1], _path[_prune.j-1], _path[_prune.j]);
+        const Vector3f point = unpack_point(_path[k]);
+        dp = segment_segment_dist(seg_start, seg_end, prev_point, point);
         if (dp.distance < SMARTRTL_PRUNING_DELTA) {
-            // if there is a loop here, add to loop array
-            if (!add_loop(_prune.j, _prune.i-1, dp.midpoint)) {
-                // if the buffer is full, stop trying to prune
-                _prune.complete = true;
+            j = k;
+            return true;
+        }
+        prev_point = point;
+    }
+    return false;
+}
+
+// find the first segment (j-1 to j) on the path which comes close to segment i-1 to i, checking only segments
+// held in the loop index cells near segment i.  Gives the same result as find_loop_all_segments
+// returns true and fills in j and dp (the closest distance and midpoint) if found
+bool AP_SmartRTL::find_loop_indexed(uint16_t i, uint16_t& j, dist_point& dp) const
+{
+    const float delta = SMARTRTL_PRUNING_DELTA;
+    const Vector3f seg_start = unpack_point(_path[i]);
+    const Vector3f seg_end = unpack_point(_path[i-1]);
+
+    // bounding box of segment expanded by the distance at which segments are considered close
+    const Vector3f box_min(MIN(seg_start.x, seg_end.x) - delta, MIN(seg_start.y, seg_end.y) - delta, MIN(seg_start.z, seg_end.z) - delta);
+    const Vector3f box_max(MAX(seg_start.x, seg_end.x) + delta, MAX(seg_start.y, seg_end.y) + delta, MAX(seg_start.z, seg_end.z) + delta);
+
+    // segments are held in the cell of their centre and are no longer than a cell, so widen the search by half a cell
+    const Vector3f half_cell(0.5f / _loop_index.cell_scale.x, 0.5f / _loop_index.cell_scale.y, 0);
+    int16_t x_min, y_min, x_max, y_max;
+    loop_index_cell(box_min - half_cell, x_min, y_min);
+    loop_index_cell(box_max + half_cell, x_max, y_max);
+    const uint16_t num_x = x_max - x_min + 1;
+    const uint16_t num_search = num_x * (y_max - y_min + 1);
+
+    // only segments ending at or before point i-2 may be checked, segments are only checked if earlier than the best so far
+    uint16_t best_j = i - 1;
+    for (uint16_t n = 0; n <= num_search; n++) {
+        // the last cell searched is the one after the grid holding long segments
+        const uint16_t cell = (n < num_search) ? (y_min + n / num_x) * _loop_index.num_cells + x_min + n % num_x : sq(_loop_index.num_cells);
+        for (uint16_t k = _loop_index.cell_start[cell]; k < _loop_index.cell_start[cell+1]; k++) {
+            const uint16_t candidate = _loop_index.segments[k];
+            if (candidate >= best_j) {
+                continue;
+            }
+            const Vector3f p3 = unpack_point(_path[candidate-1]);
+            const Vector3f p4 = unpack_point(_path[candidate]);
+
+            // quick reject of segments which cannot be close
+            if ((MIN(p3.x, p4.x) > box_max.x) || (MAX(p3.x, p4.x) < box_min.x) ||
+                (MIN(p3.y, p4.y) > box_max.y) || (MAX(p3.y, p4.y) < box_min.y) ||
+                (MIN(p3.z, p4.z) > box_max.z) || (MAX(p3.z, p4.z) < box_min.z)) {
+                continue;
+            }
+
+            // find the closest distance between two line segments and the mid-point
+            const dist_point candidate_dp = segment_segment_dist(seg_start, seg_end, p3, p4);
+            if (candidate_dp.distance < delta) {
+                best_j = candidate;
+                dp = candidate_dp;
             }
-            // set inner loop forward to trigger outer loop move to next segment
-            _prune.j = _prune.i;
         }
     }
+
+    if (best_j < i - 1) {
+        j = best_j;
+        return true;
+    }
+    return false;
+}
+
+// get loop index cell holding a point.  points outside the index are moved to the nearest cell
+void AP_SmartRTL::loop_index_cell(const Vector3f& point, int16_t& x, int16_t& y) const
+{
+    x = constrain_float((point.x - _loop_index.origin.x) * _loop_index.cell_scale.x, 0, _loop_index.num_cells - 1);
+    y = constrain_float((point.y - _loop_index.origin.y) * _loop_index.cell_scale.y, 0, _loop_index.num_cells - 1);
+}
+
+// get loop index cell holding the segment from p1 to p2.  segments longer than a cell in either axis are
+// held in the cell after the grid
+uint16_t AP_SmartRTL::loop_index_segment_cell(const Vector3f& p1, const Vector3f& p2) const
+{
+    if ((fabsf(p2.x - p1.x) * _loop_index.cell_scale.x > 1.0f) || (fabsf(p2.y - p1.y) * _loop_index.cell_scale.y > 1.0f)) {
+        return sq(_loop_index.num_cells);
+    }
+    int16_t x, y;
+    loop_index_cell((p1 + p2) * 0.5f, x, y);
+    return y * _loop_index.num_cells + x;
+}
+
+// build loop index of the segments on the path being pruned
+// returns false if the index could not be built, in which case every segment must be checked
+bool AP_SmartRTL::build_loop_index()
+{
+    _loop_index.valid = false;
+    if ((_loop_index.cell_start == nullptr) || (_loop_index.segments == nullptr) || (_prune.path_points_count < 2)) {
+        return false;
+    }
+    _loop_index.path_points_count = _prune.path_points_count;
+
+    // find horizontal extent of path
+    Vector2f pos_min = unpack_point(_path[0]).xy();
+    Vector2f pos_max = pos_min;
+    for (uint16_t i = 1; i < _loop_index.path_points_count; i++) {
+        const Vector3f point = unpack_point(_path[i]);
+        pos_min.x = MIN(pos_min.x, point.x);
+        pos_min.y = MIN(pos_min.y, point.y);
+        pos_max.x = MAX(pos_max.x, point.x);
+        pos_max.y = MAX(pos_max.y, point.y);
+    }
+    _loop_index.origin = pos_min;
+    const Vector2f size = pos_max - pos_min;
+    _loop_index.num_cells = constrain_int16(ceilf(safe_sqrt(_loop_index.path_points_count * (1.0f / SMARTRTL_LOOP_INDEX_POINTS_PER_CELL))), 1, _loop_index.num_cells_max);
+    _loop_index.cell_scale.x = _loop_index.num_cells / MAX(size.x, 1.0f);
+    _loop_index.cell_scale.y = _loop_index.num_cells / MAX(size.y, 1.0f);
+
+    // count segments in each cell (offset by one for the prefix sum below)
+    const uint16_t num_cells = sq(_loop_index.num_cells) + 1;
+    memset(_loop_index.cell_start, 0, (num_cells + 1) * sizeof(uint16_t));
+    Vector3f prev_point = unpack_point(_path[0]);
+    for (uint16_t j = 1; j < _loop_index.path_points_count; j++) {
+        const Vector3f point = unpack_point(_path[j]);
+        _loop_index.cell_start[loop_index_segment_cell(prev_point, point) + 1]++;
+        prev_point = point;
+    }
+    for (uint16_t c = 0; c < num_cells; c++) {
+        _loop_index.cell_start[c+1] += _loop_index.cell_start[c];
+    }
+
+    // fill in segments using cell_start as the insertion point, then shift back
+    prev_point = unpack_point(_path[0]);
+    for (uint16_t j = 1; j < _loop_index.path_points_count; j++) {
+        const Vector3f point = unpack_point(_path[j]);
+        _loop_index.segments[_loop_index.cell_start[loop_index_segment_cell(prev_point, point)]++] = j;
+        prev_point = point;
+    }
+    for (uint16_t c = num_cells; c > 0; c--) {
+        _loop_index.cell_start[c] = _loop_index.cell_start[c-1];
+    }
+    _loop_index.cell_start[0] = 0;
+
+    _loop_index.valid = true;
+    return true;
 }
 
 // restart simplify if new points have been added to path
@@ -649,8 +852,9 @@ void AP_SmartRTL::restart_pruning(uint16_t path_points_count)
 {
     _prune.complete = false;
     _prune.i = (path_points_count > 0) ? path_points_count - 1 : 0;
-    _prune.j = 0;
+    _prune.k = 1;
     _prune.path_points_count = path_points_count;
+    _prune.index_built = false;
 }
 
 // reset pruning algorithm so that it will re-check all points in the path
@@ -672,7 +876,7 @@ void AP_SmartRTL::remove_points_by_simplify_bitmask()
     uint16_t removed = 0;
     for (uint16_t src = 1; src < _path_points_count; src++) {
         if (!_simplify.bitmask.get(src)) {
-            log_action(Action::POINT_SIMPLIFY, _path[src]);
+            log_action(Action::POINT_SIMPLIFY, unpack_point(_path[src]));
             removed++;
         } else {
             _path[dest] = _path[src];
@@ -695,6 +899,9 @@ void AP_SmartRTL::remove_points_by_simplify_bitmask()
     // flag point removal is complete
     _simplify.bitmask.setall();
     _simplify.removal_required = false;
+
+    // loop index must be rebuilt because points have moved
+    _prune.index_built = false;
 }
 
 // remove loops until at least num_point_to_delete have been removed from path
@@ -719,12 +926,13 @@ bool AP_SmartRTL::remove_points_by_loops(uint16_t num_points_to_remove)
         prune_loop_t loop = _prune.loops[i];
 
         // midpoint goes into start_index (this is the end point of the first segment)
-        _path[loop.start_index] = loop.midpoint;
+        // it lies between two points already on the path so can always be packed
+        IGNORE_RETURN(pack_point(loop.midpoint, _path[loop.start_index]));
 
         // shift points after the end of the loop down by the number of points in the loop
         uint16_t loop_num_points_to_remove = loop.end_index - loop.start_index;
         for (uint16_t dest = loop.start_index + 1; dest < _path_points_count - loop_num_points_to_remove; dest++) {
-            log_action(Action::POINT_PRUNE, _path[dest]);
+            log_action(Action::POINT_PRUNE, unpack_point(_path[dest]));
             _path[dest] = _path[dest + loop_num_points_to_remove];
         }
 
@@ -775,9 +983,12 @@ bool AP_SmartRTL::add_loop(uint16_t start_index, uint16_t end_index, const Vecto
 
     // create new loop structure and calculate length squared of loop
     prune_loop_t new_loop = {start_index, end_index, midpoint, 0.0f};
-    new_loop.length_squared = midpoint.distance_squared(_path[start_index]) + midpoint.distance_squared(_path[end_index]);
+    new_loop.length_squared = midpoint.distance_squared(unpack_point(_path[start_index])) + midpoint.distance_squared(unpack_point(_path[end_index]));
+    Vector3f point = unpack_point(_path[start_index]);
     for (uint16_t i = start_index; i < end_index; i++) {
-        new_loop.length_squared += _path[i].distance_squared(_path[i+1]);
+        const Vector3f next_point = unpack_point(_path[i+1]);
+        new_loop.length_squared += point.distance_squared(next_point);
+        point = next_point;
     }
 
     // look for overlapping loops and find their combined length
@@ -861,6 +1072,34 @@ AP_SmartRTL::dist_point AP_SmartRTL::segment_segment_dist(const Vector3f &p1, co
     return {dP.length(), midpoint};
 }
 
+// pack a point into 9 bytes: 24 bits each for north, east and down
+// returns false if the point is too far from the EKF origin to be stored
+bool AP_SmartRTL::pack_point(const Vector3f& point, PackedPoint& packed)
+{
+    static_assert(sizeof(PackedPoint) == 9, "PackedPoint must be 9 bytes");
+
+    const float x = roundf(point.x * (1.0f / SMARTRTL_POINT_XY_RESOLUTION));
+    const float y = roundf(point.y * (1.0f / SMARTRTL_POINT_XY_RESOLUTION));
+    const float z = roundf(point.z * (1.0f / SMARTRTL_POINT_Z_RESOLUTION));
+
+    // written so that NaN fails the range check
+    const float limit = (1U << 23) - 1;
+    if (!(fabsf(x) <= limit) || !(fabsf(y) <= limit) || !(fabsf(z) <= limit)) {
+        return false;
+    }
+
+    packed.x = int32_t(x);
+    packed.y = int32_t(y);
+    packed.z = int32_t(z);
+    return true;
+}
+
+// unpack a point packed with pack_point
+Vector3f AP_SmartRTL::unpack_point(const PackedPoint& packed)
+{
+    return Vector3f(packed.x * SMARTRTL_POINT_XY_RESOLUTION, packed.y * SMARTRTL_POINT_XY_RESOLUTION, packed.z * SMARTRTL_POINT_Z_RESOLUTION);
+}
+
 // de-activate SmartRTL, send warning to GCS and logger
 void AP_SmartRTL::deactivate(Action action, const char *reason)
 {
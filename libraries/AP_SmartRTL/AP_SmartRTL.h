@@ -7,8 +7,8 @@
 
 // definitions and macros
 #define SMARTRTL_ACCURACY_DEFAULT        2.0f   // default _ACCURACY parameter value.  Points will be no closer than this distance (in meters) together.
-#define SMARTRTL_POINTS_DEFAULT          300    // default _POINTS parameter value.  High numbers improve path pruning but use more memory and CPU for cleanup. Memory used will be 20bytes * this number.
-#define SMARTRTL_POINTS_MAX              500    // the absolute maximum number of points this library can support.
+#define SMARTRTL_POINTS_DEFAULT          300    // default _POINTS parameter value.  High numbers improve path pruning but use more memory and CPU for cleanup. Memory used will be about 19bytes * this number.
+#define SMARTRTL_POINTS_MAX              2000   // the absolute maximum number of points this library can support.
 #define SMARTRTL_TIMEOUT                 15000  // the time in milliseconds with no points saved to the path (for whatever reason), before SmartRTL is disabled for the flight
 #define SMARTRTL_CLEANUP_POINT_TRIGGER   50     // simplification will trigger when this many points are added to the path
 #define SMARTRTL_CLEANUP_START_MARGIN    10     // routine cleanup algorithms begin when the path array has only this many empty slots remaining
@@ -21,9 +21,16 @@
 #define SMARTRTL_PRUNING_DELTA (_accuracy * 0.99)   // How many meters apart must two points be, such that we can assume that there is no obstacle between them.  must be smaller than _ACCURACY parameter
 #define SMARTRTL_PRUNING_LOOP_BUFFER_LEN_MULT 0.25f // pruning loop buffer size as compared to maximum number of points
 #define SMARTRTL_PRUNING_LOOP_TIME_US    200    // maximum time (in microseconds) that the loop finding algorithm will run before returning
+#define SMARTRTL_PRUNING_SEGMENTS_PER_CHECK 50  // without the loop index, number of segments compared between checks of the loop finding time limit
+#define SMARTRTL_POINT_XY_RESOLUTION     0.02f  // horizontal resolution (in meters) of points stored in the path.  Points must be within 167km of the EKF origin
+#define SMARTRTL_POINT_Z_RESOLUTION      0.02f  // vertical resolution (in meters) of points stored in the path.  Points must be within 167km of the EKF origin
+#define SMARTRTL_LOOP_INDEX_CELLS_MAX    32     // maximum number of loop index grid cells along each axis
+#define SMARTRTL_LOOP_INDEX_POINTS_PER_CELL 8   // loop index grid has about one cell per this many path points
 
 class AP_SmartRTL {
 
+    friend class AP_SmartRTL_Test;
+
 public:
 
     // constructor, destructor
@@ -39,7 +46,7 @@ public:
     uint16_t get_num_points() const;
 
     // get a point on the path
-    const Vector3f& get_point(uint16_t index) const { return _path[index]; }
+    Vector3f get_point(uint16_t index) const { return unpack_point(_path[index]); }
 
     // add point to end of path. returns true on success, false on failure (due to failure to take the semaphore)
     bool add_point(const Vector3f& point);
@@ -104,6 +111,8 @@ private:
         DEACTIVATED_BAD_POSITION_TIMEOUT = 9,
         DEACTIVATED_PATH_FULL_TIMEOUT = 10,
         DEACTIVATED_PROGRAM_ERROR = 11,
+        ADD_FAILED_OUT_OF_RANGE = 12,
+        DEACTIVATED_OUT_OF_RANGE_TIMEOUT = 13,
     };
 
     // enum for SRTL_OPTIONS parameter
@@ -170,6 +179,30 @@ private:
     // get the closest distance between 2 line segments and the point midway between the closest points
     static dist_point segment_segment_dist(const Vector3f& p1, const Vector3f& p2, const Vector3f& p3, const Vector3f& p4);
 
+    // point stored in the path, in meters from EKF origin in NED packed into 9 bytes (see pack_point)
+    struct PACKED PackedPoint {
+        int32_t x : 24;
+        int32_t y : 24;
+        int32_t z : 24;
+    };
+
+    // convert between a point and the packed form stored in the path
+    // pack_point returns false if the point is too far from the EKF origin to be stored
+    static bool pack_point(const Vector3f& point, PackedPoint& packed) WARN_IF_UNUSED;
+    static Vector3f unpack_point(const PackedPoint& packed);
+
+    // loop index used by detect_loops to find path segments which may be close to each other
+    // build_loop_index returns false if the index is unavailable and every segment must be checked
+    bool build_loop_index();
+    void loop_index_cell(const Vector3f& point, int16_t& x, int16_t& y) const;
+    uint16_t loop_index_segment_cell(const Vector3f& p1, const Vector3f& p2) const;
+
+    // find the first segment (j-1 to j) on the path which comes close to segment i-1 to i, checking every segment
+    // or only those found with the loop index.  returns true and fills in j and dp if found
+    // find_loop_all_segments checks segments from k up to (but not including) k_end, and advances k
+    bool find_loop_all_segments(uint16_t i, uint16_t& k, uint16_t k_end, uint16_t& j, dist_point& dp) const;
+    bool find_loop_indexed(uint16_t i, uint16_t& j, dist_point& dp) const;
+
     // de-activate SmartRTL, send warning to GCS and logger
     void deactivate(Action action, const char *reason);
 
@@ -195,9 +228,10 @@ private:
     uint32_t _thorough_clean_complete_ms; // set to _thorough_clean_request_ms when the background thread completes the thorough cleanup
     uint32_t _last_low_space_notify_ms; //last time low on SmartRTL space was notified on Mavlink. Minimum time is required before re-notification to avoid nagging.
     ThoroughCleanupType _thorough_clean_type;   // used by example sketch to test simplify and prune separately
+    Action _add_failure;    // reason the most recent add_point failed, used to report why SmartRTL was deactivated
 
     // path variables
-    Vector3f* _path;    // points are stored in meters from EKF origin in NED
+    PackedPoint* _path; // points are stored in meters from EKF origin in NED, packed into 9 bytes (see pack_point)
     uint16_t _path_points_max;  // after the array has been allocated, we will need to know how big it is. We can't use the parameter, because a user could change the parameter in-flight
     uint16_t _path_points_count;// number of points in the path array
     uint16_t _path_points_completed_limit;  // set by main thread to the path_point_count when a point is popped.  used by simplify and prune algorithms to detect path shrinking
@@ -231,13 +265,28 @@ private:
         bool complete;
         uint16_t path_points_count;  // copy of _path_points_count taken when the prune algorithm started
         uint16_t path_points_completed; // number of points in that path that have already been checked for loops and should be ignored
-        uint16_t i;     // loop search's outer loop index
-        uint16_t j;     // loop search's inner loop index
+        uint16_t i;     // loop search's current segment (from point i-1 to point i)
+        uint16_t k;     // next segment to compare with segment i when the loop index is not used
         prune_loop_t* loops;// the result of the pruning algorithm
         uint16_t loops_max; // maximum number of elements in the _prunable_loops array
         uint16_t loops_count;   // number of elements in the _prunable_loops array
+        bool index_built;       // true once build_loop_index has been called for the current pruning run
     } _prune;
 
+    // Loop index
+    // grid of cells covering the path horizontally.  each segment is held once, in the cell holding the centre of
+    // its bounding box.  segments longer than a cell are held in an extra cell after the grid which is always checked
+    struct {
+        bool valid;             // true if the index has been successfully built for the current path
+        Vector2f origin;        // north-east corner of the grid
+        Vector2f cell_scale;    // cells per meter in each axis
+        uint8_t num_cells;      // number of cells along each axis
+        uint8_t num_cells_max;  // maximum number of cells along each axis, set by size of cell_start array
+        uint16_t* cell_start;   // offset of each cell's first entry in segments array, (num_cells_max^2 + 2) elements
+        uint16_t* segments;     // end index of segments in each cell, one element per path point
+        uint16_t path_points_count; // number of points on the path when the index was built
+    } _loop_index;
+
     // returns true if the two loops overlap (used within add_loop to determine which loops to keep or throw away)
     bool loops_overlap(const prune_loop_t& loop1, const prune_loop_t& loop2) const;
 };
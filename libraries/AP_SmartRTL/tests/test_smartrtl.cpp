@@ -0,0 +1,203 @@
+#include <AP_gtest.h>
+
+#include <AP_SmartRTL/AP_SmartRTL.h>
+#include <AP_Math/tests/random_test.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// access to the internals of AP_SmartRTL
+class AP_SmartRTL_Test
+{
+public:
+    typedef AP_SmartRTL::dist_point dist_point;
+    typedef AP_SmartRTL::prune_loop_t prune_loop_t;
+
+    static bool pack_point(const Vector3f& point, Vector3f& unpacked)
+    {
+        AP_SmartRTL::PackedPoint packed;
+        if (!AP_SmartRTL::pack_point(point, packed)) {
+            return false;
+        }
+        unpacked = AP_SmartRTL::unpack_point(packed);
+        return true;
+    }
+
+    AP_SmartRTL_Test(uint16_t points_max)
+    {
+        smart_rtl._accuracy.set(SMARTRTL_ACCURACY_DEFAULT);
+        smart_rtl._points_max.set(points_max);
+        smart_rtl.init();
+    }
+
+    bool add_point(const Vector3f& point) { return smart_rtl.add_point(point); }
+    uint16_t num_points() const { return smart_rtl.get_num_points(); }
+
+    // prepare to search the whole path for loops, with or without the loop index
+    bool start_pruning(bool use_index)
+    {
+        smart_rtl.reset_pruning();
+        smart_rtl.restart_pruning(smart_rtl.get_num_points());
+        smart_rtl._prune.index_built = true;
+        if (!use_index) {
+            smart_rtl._loop_index.valid = false;
+            return true;
+        }
+        return smart_rtl.build_loop_index();
+    }
+
+    bool find_loop_indexed(uint16_t i, uint16_t& j, dist_point& dp) const
+    {
+        return smart_rtl.find_loop_indexed(i, j, dp);
+    }
+
+    bool find_loop_all_segments(uint16_t i, uint16_t& j, dist_point& dp) const
+    {
+        uint16_t k = 1;
+        return smart_rtl.find_loop_all_segments(i, k, i, j, dp);
+    }
+
+    // run loop detection to completion, returning the number of loops found
+    uint16_t detect_loops()
+    {
+        while (!smart_rtl._prune.complete) {
+            smart_rtl.detect_loops();
+        }
+        return smart_rtl._prune.loops_count;
+    }
+
+    const prune_loop_t& loop(uint16_t n) const { return smart_rtl._prune.loops[n]; }
+
+    AP_SmartRTL smart_rtl{true};
+};
+
+TEST(AP_SmartRTL, pack_point)
+{
+    // points come back to within half the resolution they are stored at
+    TestRandom rng{0x1234567};
+    for (uint32_t i = 0; i < 100000; i++) {
+        const float xy_range = (i % 2) ? 1000.0f : 160000.0f;
+        const Vector3f point {
+            rng.next_float(-xy_range, xy_range),
+            rng.next_float(-xy_range, xy_range),
+            rng.next_float(-20000, 20000)
+        };
+        Vector3f unpacked;
+        ASSERT_TRUE(AP_SmartRTL_Test::pack_point(point, unpacked));
+        // allow for float rounding at large distances
+        const float xy_tolerance = SMARTRTL_POINT_XY_RESOLUTION * 0.5f + fabsf(point.xy().length()) * FLT_EPSILON * 2;
+        const float z_tolerance = SMARTRTL_POINT_Z_RESOLUTION * 0.5f + fabsf(point.z) * FLT_EPSILON * 2;
+        EXPECT_LE(fabsf(unpacked.x - point.x), xy_tolerance);
+        EXPECT_LE(fabsf(unpacked.y - point.y), xy_tolerance);
+        EXPECT_LE(fabsf(unpacked.z - point.z), z_tolerance);
+    }
+
+    // the edges of the range, and heights far beyond what any vehicle reaches
+    const Vector3f edges[] {
+        { 167772.14f, -167772.14f, 0 },
+        { -167772.14f, 167772.14f, 0 },
+        { 0, 0, 167772.14f },
+        { 0, 0, -1700.0f },
+        { 0, 0, 1700.0f },
+        { 0, 0, -100000.0f },
+        { 0, 0, 100000.0f },
+    };
+    for (const Vector3f &point : edges) {
+        Vector3f unpacked;
+        ASSERT_TRUE(AP_SmartRTL_Test::pack_point(point, unpacked));
+        EXPECT_LE((unpacked - point).length(), SMARTRTL_POINT_XY_RESOLUTION);
+    }
+
+    // points too far away, or not a number, are rejected
+    const Vector3f rejected[] {
+        { 167772.2f, 0, 0 },
+        { 0, -167772.2f, 0 },
+        { 0, 0, -167772.2f },
+        { NAN, 0, 0 },
+        { 0, NAN, 0 },
+        { 0, 0, NAN },
+        { 0, 0, INFINITY },
+    };
+    for (const Vector3f &point : rejected) {
+        Vector3f unpacked;
+        EXPECT_FALSE(AP_SmartRTL_Test::pack_point(point, unpacked));
+    }
+}
+
+// a random walk which often turns back on itself so the path has loops, with occasional long legs like
+// those left by simplification
+static void make_path(TestRandom &rng, AP_SmartRTL_Test &test, uint16_t num_points)
+{
+    Vector3f pos;
+    float heading = 0;
+    for (uint16_t i = 0; test.num_points() < num_points && i < num_points * 10; i++) {
+        if (rng.next() % 10 == 0) {
+            heading += rng.next_float(2.0f, 4.0f);
+        } else {
+            heading += rng.next_float(-0.5f, 0.5f);
+        }
+        const float step = (rng.next() % 50 == 0) ? rng.next_float(50.0f, 300.0f) : rng.next_float(2.5f, 10.0f);
+        pos += Vector3f{cosf(heading) * step, sinf(heading) * step, rng.next_float(-0.5f, 0.5f)};
+        EXPECT_TRUE(test.add_point(pos));
+    }
+}
+
+TEST(AP_SmartRTL, loop_index_matches_all_segments)
+{
+    TestRandom rng{0x7654321};
+    for (uint8_t n = 0; n < 10; n++) {
+        // allocated with new so it is zeroed like the vehicle's copy
+        AP_SmartRTL_Test &test = *new AP_SmartRTL_Test(1000);
+        make_path(rng, test, 200 + n * 80);
+        ASSERT_TRUE(test.start_pruning(true));
+
+        // the loop index finds the same first close segment as checking every segment
+        uint16_t loops_found = 0;
+        for (uint16_t i = test.num_points() - 1; i >= 4; i--) {
+            uint16_t j_indexed = 0;
+            uint16_t j_all = 0;
+            AP_SmartRTL_Test::dist_point dp_indexed {};
+            AP_SmartRTL_Test::dist_point dp_all {};
+            const bool found_indexed = test.find_loop_indexed(i, j_indexed, dp_indexed);
+            const bool found_all = test.find_loop_all_segments(i, j_all, dp_all);
+            ASSERT_EQ(found_all, found_indexed);
+            if (found_all) {
+                loops_found++;
+                EXPECT_EQ(j_all, j_indexed);
+                EXPECT_FLOAT_EQ(dp_all.distance, dp_indexed.distance);
+                EXPECT_EQ(dp_all.midpoint, dp_indexed.midpoint);
+            }
+        }
+        EXPECT_GT(loops_found, 0);
+        delete &test;
+    }
+}
+
+TEST(AP_SmartRTL, detect_loops_matches_all_segments)
+{
+    // the loops found by the time sliced search are the same with and without the loop index
+    TestRandom rng{0x2468ace};
+    for (uint8_t n = 0; n < 5; n++) {
+        AP_SmartRTL_Test &test = *new AP_SmartRTL_Test(1000);
+        make_path(rng, test, 300 + n * 150);
+
+        ASSERT_TRUE(test.start_pruning(false));
+        const uint16_t num_loops = test.detect_loops();
+        EXPECT_GT(num_loops, 0);
+        AP_SmartRTL_Test::prune_loop_t loops[250];
+        ASSERT_LE(num_loops, ARRAY_SIZE(loops));
+        for (uint16_t i = 0; i < num_loops; i++) {
+            loops[i] = test.loop(i);
+        }
+
+        ASSERT_TRUE(test.start_pruning(true));
+        ASSERT_EQ(num_loops, test.detect_loops());
+        for (uint16_t i = 0; i < num_loops; i++) {
+            EXPECT_EQ(loops[i].start_index, test.loop(i).start_index);
+            EXPECT_EQ(loops[i].end_index, test.loop(i).end_index);
+            EXPECT_EQ(loops[i].midpoint, test.loop(i).midpoint);
+        }
+        delete &test;
+    }
+}
+
+AP_GTEST_MAIN()
@@ -1402,24 +1402,24 @@ void AP_TECS::update_pitch_throttle(int32_t hgt_dem_cm,
         // @Field: dspdem: demanded acceleration output ("delta-speed demand")
         // @Field: f: flags
         // @FieldBits: f: Underspeed,UnachievableDescent,AutoLanding,ReachedTakeoffSpd
-        AP::logger().WriteStreaming("TECS", "TimeUS,h,dh,hin,hdem,dhdem,spdem,sp,dsp,th,ph,pmin,pmax,dspdem,f",
+        LOGGER_WRITE_STREAMING_FAST("TECS", "TimeUS,h,dh,hin,hdem,dhdem,spdem,sp,dsp,th,ph,pmin,pmax,dspdem,f",
                                     "smnmmnnnn------",
                                     "F00000000------",
                                     "QfffffffffffffB",
                                     now,
-                                    (double)_height,
-                                    (double)_climb_rate,
-                                    (double)_hgt_dem_in_raw,
-                                    (double)_hgt_dem,
-                                    (double)_hgt_rate_dem,
-                                    (double)_TAS_dem_adj,
-                                    (double)_TAS_state,
-                                    (double)_vel_dot,
-                                    (double)_throttle_dem,
-                                    (double)_pitch_dem,
-                                    (double)_PITCHminf,
-                                    (double)_PITCHmaxf,
-                                    (double)_TAS_rate_dem,
+                                    _height,
+                                    _climb_rate,
+                                    _hgt_dem_in_raw,
+                                    _hgt_dem,
+                                    _hgt_rate_dem,
+                                    _TAS_dem_adj,
+                                    _TAS_state,
+                                    _vel_dot,
+                                    _throttle_dem,
+                                    _pitch_dem,
+                                    _PITCHminf,
+                                    _PITCHmaxf,
+                                    _TAS_rate_dem,
                                     _flags_byte);
     }
 #endif
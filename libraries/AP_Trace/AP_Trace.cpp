@@ -0,0 +1,239 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "AP_Trace.h"
+
+#if AP_TRACE_ENABLED
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_Logger/AP_Logger.h>
+#include <AP_Common/ExpandingString.h>
+
+static_assert((AP_TRACE_RING_SIZE & (AP_TRACE_RING_SIZE - 1)) == 0, "AP_TRACE_RING_SIZE must be a power of 2");
+
+extern const AP_HAL::HAL& hal;
+
+static AP_Trace instance;
+
+// interval between TRCE messages
+#define AP_TRACE_LOG_INTERVAL_MS 100
+
+void AP_Trace::mark(Point point)
+{
+    mark(point, AP_HAL::micros64());
+}
+
+void AP_Trace::mark(Point point, uint64_t time_us)
+{
+    ring *r = ring_for_thread();
+    if (r != nullptr) {
+        const uint32_t h = r->head.load(std::memory_order_relaxed);
+        // order the store of head for the previous event before the
+        // slot is overwritten, see trace_json()
+        std::atomic_thread_fence(std::memory_order_release);
+        r->events[h & (AP_TRACE_RING_SIZE - 1)] = { time_us, point };
+        r->head.store(h + 1, std::memory_order_release);
+    }
+    if (hal.scheduler->in_main_thread()) {
+        loop_mark(point, time_us);
+    }
+}
+
+AP_Trace::ring *AP_Trace::ring_for_thread()
+{
+    const void *self = hal.scheduler->current_thread();
+    if (self == nullptr) {
+        return nullptr;
+    }
+    for (auto &r : rings) {
+        const void *owner = r.owner.load();
+        if (owner == self) {
+            return &r;
+        }
+        if (owner != nullptr) {
+            continue;
+        }
+        if (r.owner.compare_exchange_strong(owner, self)) {
+            r.main_thread = hal.scheduler->in_main_thread();
+            return &r;
+        }
+        // another thread took it, try the next
+    }
+    return nullptr;
+}
+
+// time each point is passed after the IMU sample, a loop ends when
+// the outputs are pushed
+void AP_Trace::loop_mark(Point point, uint64_t time_us)
+{
+    if (point == Point::IMU_SAMPLE) {
+        loop.sample_us = time_us;
+        loop.passed = 0;
+        return;
+    }
+    if (loop.sample_us == 0 || time_us < loop.sample_us) {
+        // no sample this loop
+        return;
+    }
+    const uint8_t i = uint8_t(point);
+    loop.delta_us[i] = time_us - loop.sample_us;
+    loop.passed |= 1U << i;
+    if (point == Point::OUTPUT_PUSH) {
+        loop_end();
+    }
+}
+
+void AP_Trace::loop_end()
+{
+    for (uint8_t i = 0; i < uint8_t(Point::NUM_POINTS); i++) {
+        if (loop.passed & (1U << i)) {
+            stats.count[i]++;
+            stats.sum_us[i] += loop.delta_us[i];
+        }
+    }
+    stats.max_us = MAX(stats.max_us, loop.delta_us[uint8_t(Point::OUTPUT_PUSH)]);
+    loop.sample_us = 0;
+
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - stats.last_log_ms >= AP_TRACE_LOG_INTERVAL_MS) {
+        stats.last_log_ms = now_ms;
+        Write_TRCE();
+        memset(stats.count, 0, sizeof(stats.count));
+        memset(stats.sum_us, 0, sizeof(stats.sum_us));
+        stats.max_us = 0;
+    }
+}
+
+void AP_Trace::Write_TRCE()
+{
+#if HAL_LOGGING_ENABLED
+    uint32_t avg_us[uint8_t(Point::NUM_POINTS)] {};
+    for (uint8_t i = 0; i < uint8_t(Point::NUM_POINTS); i++) {
+        if (stats.count[i] > 0) {
+            avg_us[i] = stats.sum_us[i] / stats.count[i];
+        }
+    }
+// @LoggerMessage: TRCE
+// @Description: Loop latency from the newest IMU sample to each tracepoint
+// @Field: TimeUS: Time since system startup
+// @Field: N: number of loops which pushed outputs
+// @Field: Ins: average time to AP_InertialSensor::update() done
+// @Field: AHRS: average time to AP_AHRS::update() done
+// @Field: Rate: average time to the attitude rate controller run
+// @Field: Mot: average time to the motor outputs being calculated
+// @Field: Out: average time to the outputs being pushed
+// @Field: OutMax: maximum time to the outputs being pushed
+    AP::logger().WriteStreaming("TRCE",
+                                "TimeUS,N,Ins,AHRS,Rate,Mot,Out,OutMax",
+                                "s-ssssss",
+                                "F-FFFFFF",
+                                "QIIIIIII",
+                                AP_HAL::micros64(),
+                                stats.count[uint8_t(Point::OUTPUT_PUSH)],
+                                avg_us[uint8_t(Point::INS_UPDATE)],
+                                avg_us[uint8_t(Point::AHRS_UPDATE)],
+                                avg_us[uint8_t(Point::RATE_CONTROL)],
+                                avg_us[uint8_t(Point::MOTORS_OUTPUT)],
+                                avg_us[uint8_t(Point::OUTPUT_PUSH)],
+                                stats.max_us);
+#endif
+}
+
+const char *AP_Trace::point_name(Point point)
+{
+    switch (point) {
+    case Point::IMU_SAMPLE:
+        return "IMU_SAMPLE";
+    case Point::INS_UPDATE:
+        return "INS_UPDATE";
+    case Point::AHRS_UPDATE:
+        return "AHRS_UPDATE";
+    case Point::RATE_CONTROL:
+        return "RATE_CONTROL";
+    case Point::MOTORS_OUTPUT:
+        return "MOTORS_OUTPUT";
+    case Point::OUTPUT_PUSH:
+        return "OUTPUT_PUSH";
+    case Point::NUM_POINTS:
+        break;
+    }
+    return "?";
+}
+
+#if AP_TRACE_JSON_ENABLED
+/*
+  Chrome trace event format, which Perfetto and chrome://tracing
+  load. Each point is an instant event on the thread that passed it,
+  and each main thread loop from IMU sample to output push is a
+  complete event
+ */
+void AP_Trace::trace_json(ExpandingString &str)
+{
+    bool first = true;
+    str.printf("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (uint8_t i = 0; i < AP_TRACE_RINGS; i++) {
+        ring &r = rings[i];
+        if (r.owner.load() == nullptr) {
+            continue;
+        }
+        if (r.main_thread) {
+            str.printf("%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"main\"}}",
+                       first ? "" : ",", unsigned(i));
+        } else {
+            str.printf("%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread%u\"}}",
+                       first ? "" : ",", unsigned(i), unsigned(i));
+        }
+        first = false;
+
+        uint64_t sample_us = 0;
+        const uint32_t head = r.head.load(std::memory_order_acquire);
+        // the slot of the oldest event may already be taken by the
+        // next one, so at most AP_TRACE_RING_SIZE-1 events are read
+        const uint32_t start = head >= AP_TRACE_RING_SIZE ? head - AP_TRACE_RING_SIZE + 1 : 0;
+        for (uint32_t n = start; n < head; n++) {
+            const event ev = r.events[n & (AP_TRACE_RING_SIZE - 1)];
+            // skip the event if the owner has started overwriting it
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (r.head.load(std::memory_order_relaxed) - n >= AP_TRACE_RING_SIZE) {
+                sample_us = 0;
+                continue;
+            }
+            str.printf(",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%llu,\"pid\":1,\"tid\":%u}",
+                       point_name(ev.point), (unsigned long long)ev.time_us, unsigned(i));
+            if (ev.point == Point::IMU_SAMPLE) {
+                sample_us = ev.time_us;
+            } else if (ev.point == Point::OUTPUT_PUSH && sample_us != 0 && ev.time_us >= sample_us) {
+                str.printf(",\n{\"name\":\"loop\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":1,\"tid\":%u}",
+                           (unsigned long long)sample_us,
+                           (unsigned long long)(ev.time_us - sample_us),
+                           unsigned(i));
+                sample_us = 0;
+            }
+        }
+    }
+    str.printf("\n]}\n");
+}
+#endif // AP_TRACE_JSON_ENABLED
+
+namespace AP {
+
+AP_Trace &trace()
+{
+    return instance;
+}
+
+};
+
+#endif // AP_TRACE_ENABLED
@@ -0,0 +1,114 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "AP_Trace_config.h"
+
+#if AP_TRACE_ENABLED
+
+#include <stdint.h>
+#include <atomic>
+
+class ExpandingString;
+
+/*
+  Tracepoints along the path from an IMU sample to the motor outputs
+  being sent. Each tracepoint records a timestamp in a ring owned by
+  the calling thread, so recording needs no lock. On the main thread
+  the time of each point after the IMU sample is summed and logged
+  as TRCE, and on Linux and SITL the rings can be read as a Chrome
+  trace from @SYS/trace.json and loaded into Perfetto
+ */
+class AP_Trace {
+    friend class AP_Trace_Test;
+public:
+    // tracepoints in the order they are passed in a loop
+    enum class Point : uint8_t {
+        IMU_SAMPLE = 0,     // newest gyro sample used by the loop
+        INS_UPDATE,         // AP_InertialSensor::update() done
+        AHRS_UPDATE,        // AP_AHRS::update() done
+        RATE_CONTROL,       // attitude rate controller run
+        MOTORS_OUTPUT,      // motor outputs calculated
+        OUTPUT_PUSH,        // SRV_Channels::push() done, outputs sent
+        NUM_POINTS
+    };
+
+    // record point at the current time
+    void mark(Point point);
+    // record point at time_us, from AP_HAL::micros64()
+    void mark(Point point, uint64_t time_us);
+
+#if AP_TRACE_JSON_ENABLED
+    // the events in the rings in Chrome trace event format
+    void trace_json(ExpandingString &str);
+#endif
+
+private:
+    struct event {
+        uint64_t time_us;
+        Point point;
+    };
+
+    /*
+      Each ring has a single producer, its owner. A reader copies the
+      events and then discards those the owner may have overwritten
+      while it was copying
+     */
+    struct ring {
+        std::atomic<const void *> owner{nullptr};
+        std::atomic<bool> main_thread{false};   // set just after owner
+        std::atomic<uint32_t> head{0};  // events written
+        event events[AP_TRACE_RING_SIZE];
+    } rings[AP_TRACE_RINGS];
+
+    // return the ring owned by the calling thread, claiming a free one
+    // if it has none. nullptr if all are taken
+    ring *ring_for_thread();
+
+    // the points passed in the current loop, main thread only
+    struct {
+        uint64_t sample_us;
+        uint32_t delta_us[uint8_t(Point::NUM_POINTS)];
+        uint8_t passed;     // bitmask of points passed
+    } loop;
+
+    // loop latencies since last logged, main thread only
+    struct {
+        uint32_t count[uint8_t(Point::NUM_POINTS)];
+        uint32_t sum_us[uint8_t(Point::NUM_POINTS)];
+        uint32_t max_us;    // IMU sample to OUTPUT_PUSH
+        uint32_t last_log_ms;
+    } stats;
+
+    void loop_mark(Point point, uint64_t time_us);
+    void loop_end();
+    void Write_TRCE();
+
+    static const char *point_name(Point point);
+};
+
+namespace AP {
+    AP_Trace &trace();
+};
+
+#define AP_TRACE(point) AP::trace().mark(AP_Trace::Point::point)
+#define AP_TRACE_AT(point, time_us) AP::trace().mark(AP_Trace::Point::point, time_us)
+
+#else
+
+#define AP_TRACE(point)
+#define AP_TRACE_AT(point, time_us)
+
+#endif // AP_TRACE_ENABLED
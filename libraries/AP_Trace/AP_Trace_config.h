@@ -0,0 +1,30 @@
+#pragma once
+
+#include <AP_HAL/AP_HAL_Boards.h>
+
+// loop latency tracepoints, on in SITL only by default as each
+// tracepoint costs a clock read and a few stores and a TRCE message
+// is logged at 10Hz. Linux boards are flight controllers too, so
+// they have to opt in
+#ifndef AP_TRACE_ENABLED
+#define AP_TRACE_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL && !defined(HAL_BUILD_AP_PERIPH))
+#endif
+
+// Chrome trace / Perfetto JSON dump of the rings as @SYS/trace.json
+#ifndef AP_TRACE_JSON_ENABLED
+#define AP_TRACE_JSON_ENABLED (AP_TRACE_ENABLED && (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX))
+#endif
+
+// number of threads which can record events
+#ifndef AP_TRACE_RINGS
+#define AP_TRACE_RINGS 4
+#endif
+
+// events kept per thread, a power of two
+#ifndef AP_TRACE_RING_SIZE
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+#define AP_TRACE_RING_SIZE 2048
+#else
+#define AP_TRACE_RING_SIZE 64
+#endif
+#endif
@@ -0,0 +1,135 @@
+#include <AP_gtest.h>
+
+#include <AP_Trace/AP_Trace.h>
+#include <AP_Common/ExpandingString.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if AP_TRACE_JSON_ENABLED
+
+// access to the internals of AP_Trace
+class AP_Trace_Test
+{
+public:
+    // append an event to a ring as the thread owning it would
+    static void add(AP_Trace &trace, uint8_t ring, AP_Trace::Point point, uint64_t time_us)
+    {
+        AP_Trace::ring &r = trace.rings[ring];
+        r.owner.store(&r);
+        const uint32_t h = r.head.load();
+        r.events[h & (AP_TRACE_RING_SIZE - 1)] = { time_us, point };
+        r.head.store(h + 1);
+    }
+
+    static void set_main_thread(AP_Trace &trace, uint8_t ring)
+    {
+        trace.rings[ring].main_thread = true;
+    }
+};
+
+static uint32_t count(const char *str, const char *sub)
+{
+    uint32_t n = 0;
+    for (const char *p = strstr(str, sub); p != nullptr; p = strstr(p + 1, sub)) {
+        n++;
+    }
+    return n;
+}
+
+// time of event n, all distinct so each can be looked for
+static uint64_t event_time(uint32_t n)
+{
+    return 1000 + n * 10;
+}
+
+static bool has_time(const char *json, uint32_t n)
+{
+    char ts[32];
+    snprintf(ts, sizeof(ts), "\"ts\":%llu,", (unsigned long long)event_time(n));
+    return strstr(json, ts) != nullptr;
+}
+
+// the start of a loop at the time of event n
+static const char *loop_start(uint32_t n)
+{
+    static char str[64];
+    snprintf(str, sizeof(str), "\"ph\":\"X\",\"ts\":%llu,", (unsigned long long)event_time(n));
+    return str;
+}
+
+// fill ring 0 with num_events, alternating IMU_SAMPLE and OUTPUT_PUSH
+// starting with a sample
+static void fill(AP_Trace &trace, uint32_t num_events)
+{
+    for (uint32_t n = 0; n < num_events; n++) {
+        AP_Trace_Test::add(trace, 0,
+                           (n & 1) ? AP_Trace::Point::OUTPUT_PUSH : AP_Trace::Point::IMU_SAMPLE,
+                           event_time(n));
+    }
+}
+
+static AP_Trace trace_nowrap;
+
+TEST(AP_Trace, NoWrap)
+{
+    fill(trace_nowrap, 20);
+    AP_Trace_Test::set_main_thread(trace_nowrap, 0);
+    ExpandingString str;
+    trace_nowrap.trace_json(str);
+    ASSERT_FALSE(str.has_failed_allocation());
+    const char *json = str.get_string();
+
+    EXPECT_EQ(count(json, "\"ph\":\"i\""), 20U);
+    EXPECT_EQ(count(json, "\"ph\":\"X\""), 10U);
+    EXPECT_EQ(count(json, "\"ph\":\"M\""), 1U);
+    EXPECT_NE(strstr(json, "\"args\":{\"name\":\"main\"}"), nullptr);
+    EXPECT_TRUE(has_time(json, 0));
+    EXPECT_TRUE(has_time(json, 19));
+}
+
+static AP_Trace trace_wrap;
+
+TEST(AP_Trace, WrapAround)
+{
+    // the oldest slot may be being overwritten so it is never read,
+    // leaving the newest AP_TRACE_RING_SIZE-1 events, a sample first
+    const uint32_t num_events = AP_TRACE_RING_SIZE + 5;
+    fill(trace_wrap, num_events);
+    ExpandingString str;
+    trace_wrap.trace_json(str);
+    ASSERT_FALSE(str.has_failed_allocation());
+    const char *json = str.get_string();
+
+    EXPECT_EQ(count(json, "\"ph\":\"i\""), uint32_t(AP_TRACE_RING_SIZE - 1));
+    EXPECT_EQ(count(json, "\"ph\":\"X\""), uint32_t(AP_TRACE_RING_SIZE / 2 - 1));
+    EXPECT_NE(strstr(json, "\"args\":{\"name\":\"thread0\"}"), nullptr);
+    EXPECT_FALSE(has_time(json, 5));
+    EXPECT_TRUE(has_time(json, 6));
+    EXPECT_TRUE(has_time(json, num_events - 1));
+    EXPECT_NE(strstr(json, loop_start(6)), nullptr);
+}
+
+static AP_Trace trace_wrap_mid_loop;
+
+TEST(AP_Trace, WrapAroundMidLoop)
+{
+    // the oldest event read is an OUTPUT_PUSH whose sample has been
+    // overwritten, so no loop is made from it
+    const uint32_t num_events = AP_TRACE_RING_SIZE + 6;
+    fill(trace_wrap_mid_loop, num_events);
+    ExpandingString str;
+    trace_wrap_mid_loop.trace_json(str);
+    ASSERT_FALSE(str.has_failed_allocation());
+    const char *json = str.get_string();
+
+    EXPECT_EQ(count(json, "\"ph\":\"i\""), uint32_t(AP_TRACE_RING_SIZE - 1));
+    EXPECT_EQ(count(json, "\"ph\":\"X\""), uint32_t(AP_TRACE_RING_SIZE / 2 - 1));
+    EXPECT_FALSE(has_time(json, 6));
+    EXPECT_TRUE(has_time(json, 7));
+    EXPECT_EQ(strstr(json, loop_start(6)), nullptr);
+    EXPECT_NE(strstr(json, loop_start(8)), nullptr);
+}
+
+#endif // AP_TRACE_JSON_ENABLED
+
+AP_GTEST_MAIN()
@@ -491,7 +491,7 @@ void HarmonicNotchFilter<T>::log_notch_centers(uint8_t instance, uint64_t now_us
     }
 
     if (num_sources > 1) {
-        AP::logger().WriteStreaming(
+        LOGGER_WRITE_STREAMING_FAST(
             "FCN", "TimeUS,I,NF,CF1,CF2,CF3,CF4,CF5,CF6,HF1,HF2,HF3,HF4,HF5,HF6", "s#-zzzzzzzzzzzz", "F--------------", "QBHffffffffffff",
             now_us,
             instance,
@@ -500,7 +500,7 @@ void HarmonicNotchFilter<T>::log_notch_centers(uint8_t instance, uint64_t now_us
             first_harmonic[0], first_harmonic[1], first_harmonic[2], first_harmonic[3], first_harmonic[4], first_harmonic[5]);
     } else {
         // log single center frequency
-        AP::logger().WriteStreaming(
+        LOGGER_WRITE_STREAMING_FAST(
             "FCNS", "TimeUS,I,CF,HF", "s#zz", "F---", "QBff",
             now_us,
             instance,
@@ -13,6 +13,9 @@
 #include "GCS_MAVLink.h"
 #include <AP_Mission/AP_Mission.h>
 #include <stdint.h>
+#if AP_MAVLINK_RX_THREAD_ENABLED
+#include <atomic>
+#endif
 #include "MAVLink_routing.h"
 #include <AP_RTC/JitterCorrection.h>
 #include <AP_Common/Bitmask.h>
@@ -772,6 +775,65 @@ private:
     mavlink_message_t _channel_buffer;
     mavlink_status_t _channel_status;
 
+    // true if status is for a MAVLink2 packet received while we are
+    // sending MAVLink1 on a link which is allowed to send MAVLink2
+    bool should_switch_to_mavlink2(const mavlink_status_t &status) const;
+
+#if AP_MAVLINK_RX_THREAD_ENABLED
+    // when the port has the "MAVLink receive thread" option set,
+    // framing, CRC and signature checks are done on a thread for this
+    // link and the decoded messages are queued for update_receive()
+    // to handle on the main thread.  Links with an alternative
+    // protocol handler are still parsed on the main thread
+    struct rx_message_t {
+        mavlink_status_t status;
+        mavlink_message_t msg;
+    };
+    struct {
+        // messages which control the vehicle are queued separately so
+        // they are handled first and aren't dropped behind bulk traffic
+        ObjectBuffer<rx_message_t> *queue;
+        ObjectBuffer<rx_message_t> *priority_queue;
+        // held while reading and parsing from the port, so only one
+        // of the thread and update_receive() parses at a time, and
+        // while signing is changed
+        HAL_Semaphore sem;
+        // parser state for the thread, kept apart from _channel_status
+        // which is used on the main thread for sending
+        mavlink_message_t buffer;
+        mavlink_status_t status;
+        // copy of signing used to check received packets
+        mavlink_signing_t signing;
+        // messages pushed onto queue by the thread, and popped from it
+        // by the main thread
+        uint32_t pushed;
+        std::atomic<uint32_t> popped;
+        // senders which may have messages in queue, and the value of
+        // pushed after their last one. Until popped reaches
+        // untracked_pushed a sender missing from the table may too
+        struct {
+            uint8_t sysid;
+            uint8_t compid;
+            uint32_t pushed;
+        } senders[8];
+        uint32_t untracked_pushed;
+        // messages dropped because the queues were full
+        std::atomic<uint32_t> dropped;
+        // parser counts from the last message handled, main thread only
+        uint16_t rx_success_count;
+        uint16_t rx_drop_count;
+        bool running;
+    } rx_thread;
+    bool start_rx_thread();
+    void rx_thread_main();
+    bool rx_thread_should_parse() const;
+    void rx_thread_parse(const uint8_t *buf, uint16_t len);
+    void rx_thread_queue(const rx_message_t &m);
+    void handle_rx_thread_messages(uint32_t tstart_us, uint32_t max_time_us);
+    void rx_thread_update_signing();
+    static bool is_priority_rx_message(uint32_t msgid);
+#endif
+
     const AP_SerialManager::UARTState *uartstate;
 
     // last time we got a non-zero RSSI from RADIO_STATUS
@@ -855,6 +917,7 @@ private:
         Bitmask<MSG_LAST> ap_message_ids;
         uint16_t interval_ms;
         uint16_t last_sent_ms; // from AP_HAL::millis16()
+        uint32_t due_ms;       // from AP_HAL::millis(), last_sent_ms plus the reschedule interval
     };
     deferred_message_bucket_t deferred_message_bucket[10];
     static const uint8_t no_bucket_to_send = -1;
@@ -862,10 +925,41 @@ private:
     uint8_t sending_bucket_id = no_bucket_to_send;
     Bitmask<MSG_LAST> bucket_message_ids_to_send;
 
-    ap_message next_deferred_bucket_message_to_send(uint16_t now16_ms);
-    void find_next_bucket_to_send(uint16_t now16_ms);
+    ap_message next_deferred_bucket_message_to_send(uint32_t now_ms);
+    void find_next_bucket_to_send(uint32_t now_ms);
     void remove_message_from_bucket(int8_t bucket, ap_message id);
 
+    // bucket due times are cached so that finding the next bucket to
+    // send doesn't need the reschedule interval of every bucket.
+    // They are recalculated when anything the reschedule interval
+    // depends on changes
+    void update_bucket_due_ms(uint8_t bucket, uint32_t now_ms);
+    uint32_t get_reschedule_state() const;
+    uint32_t bucket_due_reschedule_state;
+
+    // reschedule a deferred message or bucket which has just been
+    // sent, returning the number of send slots missed because we fell
+    // more than an interval behind
+    static uint16_t reschedule_last_sent_ms(uint16_t &last_sent_ms, uint16_t interval_ms, uint16_t now16_ms);
+
+    // a message which did not fit in the transmit buffer is not tried
+    // again until there is more space than there was when it failed
+    ap_message blocked_message_id = no_message_to_send;
+    uint16_t blocked_message_txspace;
+
+#if AP_MAVLINK_MSG_STATS_ENABLED
+    // counts of what happened to each ap_message on this link, for
+    // tuning message rates.  Available as @SYS/mavlink_msgs.txt
+    struct ap_message_stats_t {
+        uint32_t sent;      // try_send_message() succeeded
+        uint32_t deferred;  // didn't fit, will be tried again later
+        uint32_t dropped;   // send slots skipped because we fell behind
+    } *ap_message_stats = nullptr;
+    void message_stats_info(ExpandingString &str) const;
+#endif
+    void count_message_deferred(ap_message id);
+    void count_message_dropped(ap_message id, uint16_t count);
+
     // bitmask of IDs the code has spontaneously decided it wants to
     // send out.  Examples include HEARTBEAT (gcs_send_heartbeat)
     Bitmask<MSG_LAST> pushed_ap_message_ids;
@@ -908,7 +1002,8 @@ private:
 #endif
     // return interval deferred message bucket should be sent after.
     // When sending parameters and waypoints this may be longer than
-    // the interval specified in "deferred"
+    // the interval specified in "deferred".  Depends only on the
+    // state returned by get_reschedule_state()
     uint16_t get_reschedule_interval_ms(const deferred_message_bucket_t &deferred) const;
 
     bool do_try_send_message(const ap_message id);
@@ -1063,6 +1158,10 @@ private:
 
     mavlink_signing_t signing;
     static mavlink_signing_streams_t signing_streams;
+#if AP_MAVLINK_RX_THREAD_ENABLED
+    // protects signing_streams, which receive threads also update
+    static HAL_Semaphore signing_sem;
+#endif
     static uint32_t last_signing_save_ms;
 
     static StorageAccess _signing_storage;
@@ -1229,6 +1328,27 @@ public:
 
     bool out_of_time() const;
 
+#if AP_MAVLINK_MSG_STATS_ENABLED
+    // fill in @SYS/mavlink_msgs.txt with per-link message statistics
+    void message_stats_info(ExpandingString &str) const;
+#endif
+
+    // payloads of messages which are the same on every link.  The
+    // first link to send one of these after update_send() starts
+    // fills it in and the other links reuse it, so the values are
+    // only gathered and packed once however many links are streaming.
+    // An entry is current when its generation matches generation
+    struct {
+        uint32_t generation = 1;
+        uint32_t attitude_generation;
+        mavlink_attitude_t attitude;
+        uint32_t global_position_int_generation;
+        mavlink_global_position_int_t global_position_int;
+        Location global_position_int_loc;
+        uint32_t sys_status_generation;
+        mavlink_sys_status_t sys_status;
+    } shared_payload;
+
 #if AP_FRSKY_TELEM_ENABLED
     // frsky backend
     class AP_Frsky_Telem *frsky;
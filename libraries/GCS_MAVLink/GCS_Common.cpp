@@ -61,6 +61,7 @@
 #include <AP_RPM/AP_RPM.h>
 #include <AP_AIS/AP_AIS.h>
 #include <AP_Filesystem/AP_Filesystem.h>
+#include <AP_Common/ExpandingString.h>
 #include <AP_Frsky_Telem/AP_Frsky_Telem.h>
 #include <RC_Channel/RC_Channel.h>
 #include <AP_VisualOdom/AP_VisualOdom.h>
@@ -202,6 +203,13 @@ bool GCS_MAVLINK::init(uint8_t instance)
         is_high_latency_link = true;
     }
 #endif
+
+#if AP_MAVLINK_RX_THREAD_ENABLED
+    if (uartstate->option_enabled(AP_HAL::UARTDriver::OPTION_MAVLINK_RX_THREAD) &&
+        !start_rx_thread()) {
+        GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "Chan %u: failed to start receive thread", unsigned(chan));
+    }
+#endif
     return true;
 }
 
@@ -1200,8 +1208,33 @@ uint16_t GCS_MAVLINK::get_reschedule_interval_ms(const deferred_message_bucket_t
     return interval_ms;
 }
 
-// typical runtime on fmuv3: 5 microseconds for 3 buckets
-void GCS_MAVLINK::find_next_bucket_to_send(uint16_t now16_ms)
+// returns a value which changes whenever the result of
+// get_reschedule_interval_ms() might change
+uint32_t GCS_MAVLINK::get_reschedule_state() const
+{
+    uint32_t state = stream_slowdown_ms;
+    if (_queued_parameter) {
+        state |= 1U<<16;
+    }
+    if (requesting_mission_items()) {
+        state |= 1U<<17;
+    }
+#if AP_MAVLINK_FTP_ENABLED
+    if (AP_HAL::millis() - ftp.last_send_ms < 1000) {
+        state |= 1U<<18;
+    }
+#endif
+    return state;
+}
+
+void GCS_MAVLINK::update_bucket_due_ms(uint8_t bucket, uint32_t now_ms)
+{
+    deferred_message_bucket_t &b = deferred_message_bucket[bucket];
+    const uint16_t ms_since_last_sent = uint16_t(now_ms) - b.last_sent_ms;
+    b.due_ms = now_ms - ms_since_last_sent + get_reschedule_interval_ms(b);
+}
+
+void GCS_MAVLINK::find_next_bucket_to_send(uint32_t now_ms)
 {
 #if GCS_DEBUG_SEND_MESSAGE_TIMINGS
     void *data = hal.scheduler->disable_interrupts_save();
@@ -1210,21 +1243,14 @@ void GCS_MAVLINK::find_next_bucket_to_send(uint16_t now16_ms)
 
     // all done sending this bucket... find another bucket...
     sending_bucket_id = no_bucket_to_send;
-    uint16_t ms_before_send_next_bucket_to_send = UINT16_MAX;
+    int32_t ms_before_send_next_bucket_to_send = INT32_MAX;
     for (uint8_t i=0; i<ARRAY_SIZE(deferred_message_bucket); i++) {
-        if (deferred_message_bucket[i].ap_message_ids.count() == 0) {
+        if (deferred_message_bucket[i].interval_ms == 0) {
             // no entries
             continue;
         }
-        const uint16_t interval = get_reschedule_interval_ms(deferred_message_bucket[i]);
-        const uint16_t ms_since_last_sent = now16_ms - deferred_message_bucket[i].last_sent_ms;
-        uint16_t ms_before_send_this_bucket;
-        if (ms_since_last_sent > interval) {
-            // should already have sent this bucket!
-            ms_before_send_this_bucket = 0;
-        } else {
-            ms_before_send_this_bucket = interval - ms_since_last_sent;
-        }
+        // should already have sent this bucket if this is negative
+        const int32_t ms_before_send_this_bucket = MAX(int32_t(deferred_message_bucket[i].due_ms - now_ms), int32_t(0));
         if (ms_before_send_this_bucket < ms_before_send_next_bucket_to_send) {
             sending_bucket_id = i;
             ms_before_send_next_bucket_to_send = ms_before_send_this_bucket;
@@ -1245,15 +1271,14 @@ void GCS_MAVLINK::find_next_bucket_to_send(uint16_t now16_ms)
 #endif
 }
 
-ap_message GCS_MAVLINK::next_deferred_bucket_message_to_send(uint16_t now16_ms)
+ap_message GCS_MAVLINK::next_deferred_bucket_message_to_send(uint32_t now_ms)
 {
     if (sending_bucket_id == no_bucket_to_send) {
         // could happen if all streamrates are zero?
         return no_message_to_send;
     }
 
-    const uint16_t ms_since_last_sent = now16_ms - deferred_message_bucket[sending_bucket_id].last_sent_ms;
-    if (ms_since_last_sent < get_reschedule_interval_ms(deferred_message_bucket[sending_bucket_id])) {
+    if (int32_t(now_ms - deferred_message_bucket[sending_bucket_id].due_ms) < 0) {
         // not time to send this bucket
         return no_message_to_send;
     }
@@ -1264,7 +1289,7 @@ ap_message GCS_MAVLINK::next_deferred_bucket_message_to_send(uint16_t now16_ms)
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
         AP_HAL::panic("next_deferred_bucket_message_to_send called on empty bucket");
 #endif
-        find_next_bucket_to_send(now16_ms);
+        find_next_bucket_to_send(now_ms);
         return no_message_to_send;
     }
     return (ap_message)next;
@@ -1283,6 +1308,15 @@ bool GCS_MAVLINK::do_try_send_message(const ap_message id)
         return false;
     }
     WITH_SEMAPHORE(comm_chan_lock(chan));
+    const uint16_t txspace = comm_get_txspace(chan);
+    if (id == blocked_message_id) {
+        if (txspace <= blocked_message_txspace) {
+            // this didn't fit last time and there's no more space now
+            count_message_deferred(id);
+            return false;
+        }
+        blocked_message_id = no_message_to_send;
+    }
 #if GCS_DEBUG_SEND_MESSAGE_TIMINGS
     void *data = hal.scheduler->disable_interrupts_save();
     uint32_t start_send_message_us = AP_HAL::micros();
@@ -1293,8 +1327,21 @@ bool GCS_MAVLINK::do_try_send_message(const ap_message id)
         try_send_message_stats.no_space_for_message++;
         hal.scheduler->restore_interrupts(data);
 #endif
+        // if there isn't room for a packet of any size then lack of
+        // space is likely why this failed, so don't try again until
+        // some of the buffer has drained
+        if (txspace < MAVLINK_MAX_PACKET_LEN) {
+            blocked_message_id = id;
+            blocked_message_txspace = txspace;
+        }
+        count_message_deferred(id);
         return false;
     }
+#if AP_MAVLINK_MSG_STATS_ENABLED
+    if (ap_message_stats != nullptr) {
+        ap_message_stats[id].sent++;
+    }
+#endif
 #if GCS_DEBUG_SEND_MESSAGE_TIMINGS
     const uint32_t delta_us = AP_HAL::micros() - start_send_message_us;
     hal.scheduler->restore_interrupts(data);
@@ -1316,6 +1363,38 @@ int8_t GCS_MAVLINK::get_deferred_message_index(const ap_message id) const
     return -1;
 }
 
+void GCS_MAVLINK::count_message_deferred(ap_message id)
+{
+#if AP_MAVLINK_MSG_STATS_ENABLED
+    if (ap_message_stats != nullptr) {
+        ap_message_stats[id].deferred++;
+    }
+#endif
+}
+
+void GCS_MAVLINK::count_message_dropped(ap_message id, uint16_t count)
+{
+#if AP_MAVLINK_MSG_STATS_ENABLED
+    if (ap_message_stats != nullptr) {
+        ap_message_stats[id].dropped += count;
+    }
+#endif
+}
+
+uint16_t GCS_MAVLINK::reschedule_last_sent_ms(uint16_t &last_sent_ms, uint16_t interval_ms, uint16_t now16_ms)
+{
+    // we try to keep output on a regular clock to avoid
+    // user support questions:
+    last_sent_ms += interval_ms;
+    // but we do not want to try to catch up too much:
+    const uint16_t ms_behind = now16_ms - last_sent_ms;
+    if (ms_behind > interval_ms) {
+        last_sent_ms = now16_ms;
+        return interval_ms > 0 ? ms_behind / interval_ms : 0;
+    }
+    return 0;
+}
+
 int8_t GCS_MAVLINK::deferred_message_to_send_index(uint16_t now16_ms)
 {
 
@@ -1494,6 +1573,9 @@ void GCS_MAVLINK::update_send()
         initialise_message_intervals_from_config_files();
 #endif
         deferred_messages_initialised = true;
+#if AP_MAVLINK_MSG_STATS_ENABLED
+        ap_message_stats = NEW_NOTHROW ap_message_stats_t[MSG_LAST];
+#endif
     }
 
 #if GCS_DEBUG_SEND_MESSAGE_TIMINGS
@@ -1505,6 +1587,19 @@ void GCS_MAVLINK::update_send()
 
     const uint32_t start = AP_HAL::millis();
     const uint16_t start16 = start & 0xFFFF;
+
+    // the bucket due times depend on things like whether we are
+    // sending parameters; recalculate them if any of those change
+    const uint32_t reschedule_state = get_reschedule_state();
+    if (reschedule_state != bucket_due_reschedule_state) {
+        bucket_due_reschedule_state = reschedule_state;
+        for (uint8_t i=0; i<ARRAY_SIZE(deferred_message_bucket); i++) {
+            if (deferred_message_bucket[i].interval_ms != 0) {
+                update_bucket_due_ms(i, start);
+            }
+        }
+    }
+
     while (AP_HAL::millis() - start < 5) { // spend a max of 5ms sending messages.  This should never trigger - out_of_time() should become true
         if (gcs().out_of_time()) {
 #if GCS_DEBUG_SEND_MESSAGE_TIMINGS
@@ -1524,13 +1619,9 @@ void GCS_MAVLINK::update_send()
                 if (!do_try_send_message(deferred_message[next].id)) {
                     break;
                 }
-                // we try to keep output on a regular clock to avoid
-                // user support questions:
-                const uint16_t interval_ms = deferred_message[next].interval_ms;
-                deferred_message[next].last_sent_ms += interval_ms;
-                // but we do not want to try to catch up too much:
-                if (uint16_t(start16 - deferred_message[next].last_sent_ms) > interval_ms) {
-                    deferred_message[next].last_sent_ms = start16;
+                const uint16_t dropped = reschedule_last_sent_ms(deferred_message[next].last_sent_ms, deferred_message[next].interval_ms, start16);
+                if (dropped != 0) {
+                    count_message_dropped(deferred_message[next].id, dropped);
                 }
 
                 next_deferred_message_to_send_cache = -1; // deferred_message_to_send will recalculate
@@ -1565,7 +1656,7 @@ void GCS_MAVLINK::update_send()
             continue;
         }
 
-        ap_message next = next_deferred_bucket_message_to_send(start16);
+        ap_message next = next_deferred_bucket_message_to_send(start);
         if (next != no_message_to_send) {
             if (!do_try_send_message(next)) {
                 break;
@@ -1573,15 +1664,17 @@ void GCS_MAVLINK::update_send()
             bucket_message_ids_to_send.clear(next);
             if (bucket_message_ids_to_send.count() == 0) {
                 // we sent everything in the bucket.  Reschedule it.
-                // we try to keep output on a regular clock to avoid
-                // user support questions:
-                const uint16_t interval_ms = get_reschedule_interval_ms(deferred_message_bucket[sending_bucket_id]);
-                deferred_message_bucket[sending_bucket_id].last_sent_ms += interval_ms;
-                // but we do not want to try to catch up too much:
-                if (uint16_t(start16 - deferred_message_bucket[sending_bucket_id].last_sent_ms) > interval_ms) {
-                    deferred_message_bucket[sending_bucket_id].last_sent_ms = start16;
+                deferred_message_bucket_t &bucket = deferred_message_bucket[sending_bucket_id];
+                const uint16_t dropped = reschedule_last_sent_ms(bucket.last_sent_ms, get_reschedule_interval_ms(bucket), start16);
+                if (dropped != 0) {
+                    for (uint8_t i=0; i<MSG_LAST; i++) {
+                        if (bucket.ap_message_ids.get(i)) {
+                            count_message_dropped((ap_message)i, dropped);
+                        }
+                    }
                 }
-                find_next_bucket_to_send(start16);
+                update_bucket_due_ms(sending_bucket_id, start);
+                find_next_bucket_to_send(start);
             }
 #if GCS_DEBUG_SEND_MESSAGE_TIMINGS
                 const uint32_t stop = AP_HAL::micros();
@@ -1623,7 +1716,7 @@ void GCS_MAVLINK::remove_message_from_bucket(int8_t bucket, ap_message id)
     if (bucket == sending_bucket_id) {
         bucket_message_ids_to_send.clear(id);
         if (bucket_message_ids_to_send.count() == 0) {
-            find_next_bucket_to_send(AP_HAL::millis16());
+            find_next_bucket_to_send(AP_HAL::millis());
         } else {
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
             if (deferred_message_bucket[bucket].interval_ms == 0 &&
@@ -1639,6 +1732,31 @@ void GCS_MAVLINK::remove_message_from_bucket(int8_t bucket, ap_message id)
     }
 }
 
+#if AP_MAVLINK_MSG_STATS_ENABLED
+// one line for each ap_message which has been sent or attempted on this link
+void GCS_MAVLINK::message_stats_info(ExpandingString &str) const
+{
+    if (ap_message_stats == nullptr) {
+        return;
+    }
+    for (uint8_t i=0; i<MSG_LAST; i++) {
+        const ap_message_stats_t &stats = ap_message_stats[i];
+        if (stats.sent == 0 && stats.deferred == 0 && stats.dropped == 0) {
+            continue;
+        }
+        uint16_t interval_ms = 0;
+        IGNORE_RETURN(get_ap_message_interval((ap_message)i, interval_ms));
+        str.printf("MAV%u %-3u %-5u %-8u %-8u %u\n",
+                   (unsigned)chan,
+                   (unsigned)i,
+                   (unsigned)interval_ms,
+                   (unsigned)stats.sent,
+                   (unsigned)stats.deferred,
+                   (unsigned)stats.dropped);
+    }
+}
+#endif
+
 bool GCS_MAVLINK::set_ap_message_interval(enum ap_message id, uint16_t interval_ms)
 {
     if (id == MSG_NEXT_PARAM) {
@@ -1734,6 +1852,9 @@ bool GCS_MAVLINK::set_ap_message_interval(enum ap_message id, uint16_t interval_
         // allocate a bucket for this interval
         deferred_message_bucket[empty_bucket_id].interval_ms = interval_ms;
         deferred_message_bucket[empty_bucket_id].last_sent_ms = AP_HAL::millis16();
+        update_bucket_due_ms(empty_bucket_id, AP_HAL::millis());
+        // make sure update_send() recalculates this with the state it sees
+        bucket_due_reschedule_state = UINT32_MAX;
         closest_bucket = empty_bucket_id;
     }
 
@@ -1771,6 +1892,15 @@ void GCS_MAVLINK::send_message(enum ap_message id)
     pushed_ap_message_ids.set(id);
 }
 
+bool GCS_MAVLINK::should_switch_to_mavlink2(const mavlink_status_t &status) const
+{
+    const auto mavlink_protocol = uartstate->get_protocol();
+    return !(status.flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1) &&
+        (status.flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1) &&
+        (mavlink_protocol == AP_SerialManager::SerialProtocol_MAVLink2 ||
+         mavlink_protocol == AP_SerialManager::SerialProtocol_MAVLinkHL);
+}
+
 void GCS_MAVLINK::packetReceived(const mavlink_status_t &status,
                                  const mavlink_message_t &msg)
 {
@@ -1779,11 +1909,7 @@ void GCS_MAVLINK::packetReceived(const mavlink_status_t &status,
     if (msg.msgid != MAVLINK_MSG_ID_RADIO && msg.msgid != MAVLINK_MSG_ID_RADIO_STATUS) {
         mavlink_active |= (1U<<(chan-MAVLINK_COMM_0));
     }
-    const auto mavlink_protocol = uartstate->get_protocol();
-    if (!(status.flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1) &&
-        (status.flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1) &&
-        (mavlink_protocol == AP_SerialManager::SerialProtocol_MAVLink2 ||
-         mavlink_protocol == AP_SerialManager::SerialProtocol_MAVLinkHL)) {
+    if (should_switch_to_mavlink2(status)) {
         // if we receive any MAVLink2 packets on a connection
         // currently sending MAVLink1 then switch to sending
         // MAVLink2
@@ -1830,7 +1956,23 @@ GCS_MAVLINK::update_receive(uint32_t max_time_us)
 
     status.packet_rx_drop_count = 0;
 
+#if AP_MAVLINK_RX_THREAD_ENABLED
+    if (rx_thread.running) {
+        // handle anything the receive thread has already parsed
+        handle_rx_thread_messages(tstart_us, max_time_us);
+    }
+    uint16_t nbytes;
+    {
+        // wait for the thread to finish any batch it is parsing.  It
+        // only reads while rx_thread_should_parse() is true, which
+        // can only change on this thread, so we can then read without
+        // holding the semaphore
+        WITH_SEMAPHORE(rx_thread.sem);
+        nbytes = (rx_thread.running && rx_thread_should_parse()) ? 0 : _port->available();
+    }
+#else
     const uint16_t nbytes = _port->available();
+#endif
     for (uint16_t i=0; i<nbytes; i++)
     {
         const uint8_t c = (uint8_t)_port->read();
@@ -1860,7 +2002,18 @@ GCS_MAVLINK::update_receive(uint32_t max_time_us)
         bool parsed_packet = false;
 
         // Try to get a new message
-        if (mavlink_frame_char_buffer(channel_buffer(), channel_status(), c, &msg, &status) == MAVLINK_FRAMING_OK) {
+        uint8_t framing;
+#if AP_MAVLINK_RX_THREAD_ENABLED
+        if (_channel_status.signing != nullptr) {
+            // signing_streams is shared with the receive threads
+            WITH_SEMAPHORE(signing_sem);
+            framing = mavlink_frame_char_buffer(channel_buffer(), channel_status(), c, &msg, &status);
+        } else
+#endif
+        {
+            framing = mavlink_frame_char_buffer(channel_buffer(), channel_status(), c, &msg, &status);
+        }
+        if (framing == MAVLINK_FRAMING_OK) {
             hal.util->persistent_data.last_mavlink_msgid = msg.msgid;
             packetReceived(status, msg);
             parsed_packet = true;
@@ -2000,13 +2153,22 @@ void GCS_MAVLINK::log_mavlink_stats()
         flags |= (uint8_t)Flags::LOCKED;
     }
 
+    uint16_t packet_rx_success_count = _channel_status.packet_rx_success_count;
+    uint32_t packet_rx_drop_count = _channel_status.packet_rx_drop_count;
+#if AP_MAVLINK_RX_THREAD_ENABLED
+    // add what the receive thread has parsed, and the messages
+    // dropped because the receive queues were full
+    packet_rx_success_count += rx_thread.rx_success_count;
+    packet_rx_drop_count += rx_thread.rx_drop_count + rx_thread.dropped;
+#endif
+
     const struct log_MAV pkt{
     LOG_PACKET_HEADER_INIT(LOG_MAV_MSG),
     time_us                : AP_HAL::micros64(),
     chan                   : (uint8_t)chan,
     packet_tx_count        : send_packet_count,
-    packet_rx_success_count: _channel_status.packet_rx_success_count,
-    packet_rx_drop_count   : _channel_status.packet_rx_drop_count,
+    packet_rx_success_count: packet_rx_success_count,
+    packet_rx_drop_count   : (uint16_t)packet_rx_drop_count,
     flags                  : flags,
     stream_slowdown_ms     : stream_slowdown_ms,
     times_full             : out_of_space_to_send_count,
@@ -2617,6 +2779,21 @@ void GCS::send_message(enum ap_message id)
     }
 }
 
+#if AP_MAVLINK_MSG_STATS_ENABLED
+void GCS::message_stats_info(ExpandingString &str) const
+{
+    // a header to allow for machine parsers to determine format
+    str.printf("MAVMSGV1\n");
+    str.printf("CHAN ID  INTMS SENT     DEFERRED DROPPED\n");
+    for (uint8_t i=0; i<num_gcs(); i++) {
+        const GCS_MAVLINK *link = chan(i);
+        if (link != nullptr) {
+            link->message_stats_info(str);
+        }
+    }
+}
+#endif
+
 void GCS::update_send()
 {
     update_send_has_been_called = true;
@@ -2651,6 +2828,9 @@ void GCS::update_send()
         prot->update();
     }
 
+    // anything in shared_payload is now out of date
+    shared_payload.generation++;
+
     // round-robin the GCS_MAVLINK backend that gets to go first so
     // one backend doesn't monopolise all of the time allowed for sending
     // messages
@@ -5712,54 +5892,48 @@ void GCS_MAVLINK::send_sys_status()
     if (!gcs().vehicle_initialised()) {
         return;
     }
+
+    auto &shared = gcs().shared_payload;
+    if (shared.sys_status_generation == shared.generation) {
+        mavlink_msg_sys_status_send_struct(chan, &shared.sys_status);
+        return;
+    }
+
+    mavlink_sys_status_t &packet = shared.sys_status;
+    packet = {};
+
 #if AP_BATTERY_ENABLED
     const AP_BattMonitor &battery = AP::battery();
     float battery_current;
-    const int8_t battery_remaining = battery_remaining_pct(AP_BATT_PRIMARY_INSTANCE);
 
     if (battery.healthy() && battery.current_amps(battery_current)) {
         battery_current = constrain_float(battery_current * 100,-INT16_MAX,INT16_MAX);
     } else {
         battery_current = -1;
     }
+    packet.voltage_battery = battery.gcs_voltage() * 1000;  // mV
+    packet.current_battery = battery_current;               // in 10mA units
+    packet.battery_remaining = battery_remaining_pct(AP_BATT_PRIMARY_INSTANCE);  // in %
+#else
+    packet.current_battery = -1;
+    packet.battery_remaining = -1;
 #endif
 
-    uint32_t control_sensors_present;
-    uint32_t control_sensors_enabled;
-    uint32_t control_sensors_health;
+    gcs().get_sensor_status_flags(packet.onboard_control_sensors_present,
+                                  packet.onboard_control_sensors_enabled,
+                                  packet.onboard_control_sensors_health);
 
-    gcs().get_sensor_status_flags(control_sensors_present, control_sensors_enabled, control_sensors_health);
+#if AP_SCHEDULER_ENABLED
+    packet.load = static_cast<uint16_t>(AP::scheduler().load_average() * 1000);
+#endif
 
     const uint32_t errors = AP::internalerror().errors();
-    const uint16_t errors1 = errors & 0xffff;
-    const uint16_t errors2 = (errors>>16) & 0xffff;
-    const uint16_t errors4 = AP::internalerror().count() & 0xffff;
+    packet.errors_count1 = errors & 0xffff;
+    packet.errors_count2 = (errors>>16) & 0xffff;
+    packet.errors_count4 = AP::internalerror().count() & 0xffff;
 
-    mavlink_msg_sys_status_send(
-        chan,
-        control_sensors_present,
-        control_sensors_enabled,
-        control_sensors_health,
-#if AP_SCHEDULER_ENABLED
-        static_cast<uint16_t>(AP::scheduler().load_average() * 1000),
-#else
-        0,
-#endif
-#if AP_BATTERY_ENABLED
-        battery.gcs_voltage() * 1000,  // mV
-        battery_current,        // in 10mA units
-        battery_remaining,      // in %
-#else
-        0,
-        -1,
-        -1,
-#endif
-        0,  // comm drops %,
-        0,  // comm drops in pkts,
-        errors1,
-        errors2,
-        0,  // errors3
-        errors4); // errors4
+    shared.sys_status_generation = shared.generation;
+    mavlink_msg_sys_status_send_struct(chan, &packet);
 }
 
 void GCS_MAVLINK::send_extended_sys_state() const
@@ -5770,17 +5944,21 @@ void GCS_MAVLINK::send_extended_sys_state() const
 void GCS_MAVLINK::send_attitude() const
 {
 #if AP_AHRS_ENABLED
-    const AP_AHRS &ahrs = AP::ahrs();
-    const Vector3f omega = ahrs.get_gyro();
-    mavlink_msg_attitude_send(
-        chan,
-        AP_HAL::millis(),
-        ahrs.get_roll(),
-        ahrs.get_pitch(),
-        ahrs.get_yaw(),
-        omega.x,
-        omega.y,
-        omega.z);
+    auto &shared = gcs().shared_payload;
+    if (shared.attitude_generation != shared.generation) {
+        const AP_AHRS &ahrs = AP::ahrs();
+        const Vector3f omega = ahrs.get_gyro();
+        mavlink_attitude_t &packet = shared.attitude;
+        packet.time_boot_ms = AP_HAL::millis();
+        packet.roll = ahrs.get_roll();
+        packet.pitch = ahrs.get_pitch();
+        packet.yaw = ahrs.get_yaw();
+        packet.rollspeed = omega.x;
+        packet.pitchspeed = omega.y;
+        packet.yawspeed = omega.z;
+        shared.attitude_generation = shared.generation;
+    }
+    mavlink_msg_attitude_send_struct(chan, &shared.attitude);
 #endif
 }
 
@@ -5826,6 +6004,13 @@ int32_t GCS_MAVLINK::global_position_int_relative_alt() const {
 void GCS_MAVLINK::send_global_position_int()
 {
 #if AP_AHRS_ENABLED
+    auto &shared = gcs().shared_payload;
+    if (shared.global_position_int_generation == shared.generation) {
+        global_position_current_loc = shared.global_position_int_loc;
+        mavlink_msg_global_position_int_send_struct(chan, &shared.global_position_int);
+        return;
+    }
+
     AP_AHRS &ahrs = AP::ahrs();
 
     UNUSED_RESULT(ahrs.get_location(global_position_current_loc)); // return value ignored; we send stale data
@@ -5835,17 +6020,20 @@ void GCS_MAVLINK::send_global_position_int()
         vel.zero();
     }
 
-    mavlink_msg_global_position_int_send(
-        chan,
-        AP_HAL::millis(),
-        global_position_current_loc.lat, // in 1E7 degrees
-        global_position_current_loc.lng, // in 1E7 degrees
-        global_position_int_alt(),       // millimeters above ground/sea level
-        global_position_int_relative_alt(), // millimeters above home
-        vel.x * 100,                     // X speed cm/s (+ve North)
-        vel.y * 100,                     // Y speed cm/s (+ve East)
-        vel.z * 100,                     // Z speed cm/s (+ve Down)
-        ahrs.yaw_sensor);                // compass heading in 1/100 degree
+    mavlink_global_position_int_t &packet = shared.global_position_int;
+    packet.time_boot_ms = AP_HAL::millis();
+    packet.lat = global_position_current_loc.lat;               // in 1E7 degrees
+    packet.lon = global_position_current_loc.lng;               // in 1E7 degrees
+    packet.alt = global_position_int_alt();                     // millimeters above ground/sea level
+    packet.relative_alt = global_position_int_relative_alt();   // millimeters above home
+    packet.vx = vel.x * 100;                                    // X speed cm/s (+ve North)
+    packet.vy = vel.y * 100;                                    // Y speed cm/s (+ve East)
+    packet.vz = vel.z * 100;                                    // Z speed cm/s (+ve Down)
+    packet.hdg = ahrs.yaw_sensor;                               // compass heading in 1/100 degree
+    shared.global_position_int_loc = global_position_current_loc;
+    shared.global_position_int_generation = shared.generation;
+
+    mavlink_msg_global_position_int_send_struct(chan, &packet);
 #endif  // AP_AHRS_ENABLED
 }
 
@@ -0,0 +1,258 @@
+/*
+  MAVLink receive thread
+
+  On ports with the "MAVLink receive thread" option set the bytes
+  received are read, framed and have their signatures checked on a
+  thread for that link. Decoded messages are queued and then handled
+  on the main thread by update_receive(), so a busy link doesn't use main loop time for
+  parsing and control messages aren't delayed behind bulk traffic.
+ */
+
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GCS_config.h"
+
+#if AP_MAVLINK_RX_THREAD_ENABLED
+
+#include <AP_HAL/AP_HAL.h>
+#include "GCS.h"
+
+extern const AP_HAL::HAL& hal;
+
+#ifndef MAVLINK_RX_THREAD_QUEUE_LEN
+#define MAVLINK_RX_THREAD_QUEUE_LEN 64
+#endif
+
+#ifndef MAVLINK_RX_THREAD_PRIORITY_QUEUE_LEN
+#define MAVLINK_RX_THREAD_PRIORITY_QUEUE_LEN 16
+#endif
+
+// maximum number of queued messages handled per call to update_receive()
+#ifndef MAVLINK_RX_THREAD_MSG_BUDGET
+#define MAVLINK_RX_THREAD_MSG_BUDGET 32
+#endif
+
+bool GCS_MAVLINK::start_rx_thread()
+{
+    if (rx_thread.running) {
+        return true;
+    }
+
+    rx_thread.queue = NEW_NOTHROW ObjectBuffer<rx_message_t>(MAVLINK_RX_THREAD_QUEUE_LEN);
+    rx_thread.priority_queue = NEW_NOTHROW ObjectBuffer<rx_message_t>(MAVLINK_RX_THREAD_PRIORITY_QUEUE_LEN);
+    if (rx_thread.queue == nullptr || rx_thread.queue->get_size() == 0 ||
+        rx_thread.priority_queue == nullptr || rx_thread.priority_queue->get_size() == 0) {
+        goto failed;
+    }
+
+    // set before the thread starts so update_receive() stops
+    // reading from the port as soon as the thread may
+    rx_thread.running = true;
+
+    if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&GCS_MAVLINK::rx_thread_main, void),
+                                      "MAVRx", 4096, AP_HAL::Scheduler::PRIORITY_UART, 0)) {
+        rx_thread.running = false;
+        goto failed;
+    }
+
+    return true;
+
+failed:
+    delete rx_thread.queue;
+    rx_thread.queue = nullptr;
+    delete rx_thread.priority_queue;
+    rx_thread.priority_queue = nullptr;
+    return false;
+}
+
+/*
+  return true if the thread should be parsing from the port.  Locked
+  ports and ports with an alternative protocol handler are left to
+  update_receive() on the main thread.  Both only change on the main
+  thread
+ */
+bool GCS_MAVLINK::rx_thread_should_parse() const
+{
+    return !locked() && alternative.handler == nullptr;
+}
+
+void GCS_MAVLINK::rx_thread_main()
+{
+    uint8_t buf[256];
+
+    while (true) {
+        if (!rx_thread_should_parse()) {
+            hal.scheduler->delay(10);
+            continue;
+        }
+
+        // sleep until bytes arrive
+        _port->wait_timeout(1, 100);
+
+        WITH_SEMAPHORE(rx_thread.sem);
+        if (!rx_thread_should_parse()) {
+            continue;
+        }
+        const uint32_t n = MIN(_port->available(), sizeof(buf));
+        if (n == 0) {
+            continue;
+        }
+        const ssize_t nread = _port->read(buf, n);
+        if (nread <= 0) {
+            continue;
+        }
+        if (rx_thread.status.signing != nullptr) {
+            // signing_streams is shared by all links
+            WITH_SEMAPHORE(signing_sem);
+            rx_thread_parse(buf, nread);
+        } else {
+            rx_thread_parse(buf, nread);
+        }
+    }
+}
+
+/*
+  frame bytes read from the port and queue completed messages.  The
+  thread has its own parser state and copy of signing so it never
+  touches _channel_status
+ */
+void GCS_MAVLINK::rx_thread_parse(const uint8_t *buf, uint16_t len)
+{
+    rx_message_t m;
+
+    for (uint16_t i=0; i<len; i++) {
+        if (mavlink_frame_char_buffer(&rx_thread.buffer, &rx_thread.status, buf[i], &m.msg, &m.status) != MAVLINK_FRAMING_OK) {
+            continue;
+        }
+        // pass on the link's drop count for logging
+        m.status.packet_rx_drop_count = rx_thread.status.packet_rx_drop_count;
+        rx_thread_queue(m);
+    }
+}
+
+/*
+  queue a message from the thread.  A priority message only goes
+  ahead of the queue if no earlier message from the same sender may
+  still be waiting in it, so each sender's messages are handled in
+  the order they were sent
+ */
+void GCS_MAVLINK::rx_thread_queue(const rx_message_t &m)
+{
+    const uint32_t popped = rx_thread.popped.load();
+    bool pending = int32_t(rx_thread.untracked_pushed - popped) > 0;
+    decltype(&rx_thread.senders[0]) sender = nullptr;
+    for (auto &s : rx_thread.senders) {
+        const bool in_queue = int32_t(s.pushed - popped) > 0;
+        if (in_queue && s.sysid == m.msg.sysid && s.compid == m.msg.compid) {
+            pending = true;
+            sender = &s;
+            break;
+        }
+        if (!in_queue && sender == nullptr) {
+            sender = &s;
+        }
+    }
+
+    if (!pending && is_priority_rx_message(m.msg.msgid) &&
+        rx_thread.priority_queue->push(m)) {
+        return;
+    }
+    if (!rx_thread.queue->push(m)) {
+        rx_thread.dropped++;
+        return;
+    }
+    rx_thread.pushed++;
+    if (sender == nullptr) {
+        // no room to record the sender
+        rx_thread.untracked_pushed = rx_thread.pushed;
+        return;
+    }
+    sender->sysid = m.msg.sysid;
+    sender->compid = m.msg.compid;
+    sender->pushed = rx_thread.pushed;
+}
+
+/*
+  messages which command the vehicle, or keep failsafes from
+  triggering, are handled ahead of everything else
+ */
+bool GCS_MAVLINK::is_priority_rx_message(uint32_t msgid)
+{
+    switch (msgid) {
+    case MAVLINK_MSG_ID_HEARTBEAT:
+    case MAVLINK_MSG_ID_COMMAND_LONG:
+    case MAVLINK_MSG_ID_COMMAND_INT:
+    case MAVLINK_MSG_ID_MANUAL_CONTROL:
+    case MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE:
+    case MAVLINK_MSG_ID_SET_MODE:
+    case MAVLINK_MSG_ID_SET_ATTITUDE_TARGET:
+    case MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED:
+    case MAVLINK_MSG_ID_SET_POSITION_TARGET_GLOBAL_INT:
+        return true;
+    }
+    return false;
+}
+
+/*
+  handle messages queued by the receive thread, priority messages
+  first, within the time allowed for update_receive()
+ */
+void GCS_MAVLINK::handle_rx_thread_messages(uint32_t tstart_us, uint32_t max_time_us)
+{
+    rx_message_t m;
+    uint16_t count = 0;
+
+    while (count < MAVLINK_RX_THREAD_MSG_BUDGET) {
+        if (!rx_thread.priority_queue->pop(m)) {
+            if (!rx_thread.queue->pop(m)) {
+                break;
+            }
+            rx_thread.popped++;
+        }
+        count++;
+        rx_thread.rx_success_count = m.status.packet_rx_success_count;
+        rx_thread.rx_drop_count = m.status.packet_rx_drop_count;
+
+        // the thread's parser doesn't know what we send, which
+        // packetReceived() uses to decide on switching to MAVLink2
+        m.status.flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+        m.status.flags |= _channel_status.flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+
+        if ((m.msg.incompat_flags & MAVLINK_IFLAG_SIGNED) && _channel_status.signing != nullptr) {
+            // the thread checked the signature, and as in
+            // mavlink_signature_check() our next timestamp must be
+            // at least the one received
+            uint64_t tstamp = 0;
+            memcpy(&tstamp, &m.msg.signature[1], 6);
+            if (tstamp > signing.timestamp) {
+                signing.timestamp = tstamp;
+            }
+        }
+
+        hal.util->persistent_data.last_mavlink_msgid = m.msg.msgid;
+        packetReceived(m.status, m.msg);
+        gcs_alternative_active[chan] = false;
+        alternative.last_mavlink_ms = AP_HAL::millis();
+        hal.util->persistent_data.last_mavlink_msgid = 0;
+
+        // make sure we don't spend too much time handling messages
+        if (AP_HAL::micros() - tstart_us > max_time_us) {
+            break;
+        }
+    }
+}
+
+#endif  // AP_MAVLINK_RX_THREAD_ENABLED
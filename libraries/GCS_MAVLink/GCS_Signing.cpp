@@ -38,6 +38,9 @@ struct SigningKey {
 
 // shared signing_streams structure
 mavlink_signing_streams_t GCS_MAVLINK::signing_streams;
+#if AP_MAVLINK_RX_THREAD_ENABLED
+HAL_Semaphore GCS_MAVLINK::signing_sem;
+#endif
 
 // last time we saved the timestamp
 uint32_t GCS_MAVLINK::last_signing_save_ms;
@@ -125,6 +128,17 @@ static bool accept_unsigned_callback(const mavlink_status_t *status, uint32_t ms
     }
     return false;
 }
+
+#if AP_MAVLINK_RX_THREAD_ENABLED
+/*
+  channel 0's receive thread checks signatures with its own status,
+  so it can't be recognised by accept_unsigned_callback()
+ */
+static bool accept_unsigned_chan0_callback(const mavlink_status_t *status, uint32_t msgId)
+{
+    return true;
+}
+#endif
 }
 
 /*
@@ -161,8 +175,43 @@ void GCS_MAVLINK::load_signing_key(void)
         _channel_status.signing = &signing;
         _channel_status.signing_streams = &signing_streams;
     }
+
+#if AP_MAVLINK_RX_THREAD_ENABLED
+    rx_thread_update_signing();
+#endif
 }
 
+#if AP_MAVLINK_RX_THREAD_ENABLED
+/*
+  give the receive thread a copy of signing to check received
+  packets with.  The thread's timestamp is kept if it is ahead and
+  the key hasn't changed
+ */
+void GCS_MAVLINK::rx_thread_update_signing()
+{
+    WITH_SEMAPHORE(rx_thread.sem);
+
+    if (_channel_status.signing == nullptr) {
+        rx_thread.status.signing = nullptr;
+        rx_thread.status.signing_streams = nullptr;
+        return;
+    }
+
+    const bool same_key = rx_thread.status.signing != nullptr &&
+        memcmp(rx_thread.signing.secret_key, signing.secret_key, sizeof(signing.secret_key)) == 0;
+    const uint64_t thread_timestamp = rx_thread.signing.timestamp;
+    rx_thread.signing = signing;
+    if (same_key && thread_timestamp > signing.timestamp) {
+        rx_thread.signing.timestamp = thread_timestamp;
+    }
+    if (chan == MAVLINK_COMM_0) {
+        rx_thread.signing.accept_unsigned_callback = accept_unsigned_chan0_callback;
+    }
+    rx_thread.status.signing = &rx_thread.signing;
+    rx_thread.status.signing_streams = &signing_streams;
+}
+#endif
+
 /*
   update signing timestamp. This is called when we get GPS lock
   timestamp_usec is since 1/1/1970 (the epoch)
@@ -188,6 +237,15 @@ void GCS_MAVLINK::update_signing_timestamp(uint64_t timestamp_usec)
         }
     }
 
+#if AP_MAVLINK_RX_THREAD_ENABLED
+    for (uint8_t i=0; i<MAVLINK_COMM_NUM_BUFFERS; i++) {
+        GCS_MAVLINK *backend = gcs().chan(i);
+        if (backend != nullptr) {
+            backend->rx_thread_update_signing();
+        }
+    }
+#endif
+
     // save to stable storage
     save_signing_timestamp(true);
 }
@@ -54,6 +54,18 @@
 #define HAL_MAVLINK_INTERVALS_FROM_FILES_ENABLED ((AP_FILESYSTEM_FATFS_ENABLED || AP_FILESYSTEM_POSIX_ENABLED) && BOARD_FLASH_SIZE > 1024)
 #endif
 
+// per-link counts of messages sent, deferred and dropped, available
+// as @SYS/mavlink_msgs.txt
+#ifndef AP_MAVLINK_MSG_STATS_ENABLED
+#define AP_MAVLINK_MSG_STATS_ENABLED HAL_GCS_ENABLED && (HAL_MEM_CLASS >= HAL_MEM_CLASS_1000)
+#endif
+
+// allow MAVLink received on a port to be parsed on a thread of its
+// own, enabled with the SERIALn_OPTIONS "MAVLink receive thread" bit
+#ifndef AP_MAVLINK_RX_THREAD_ENABLED
+#define AP_MAVLINK_RX_THREAD_ENABLED HAL_GCS_ENABLED && (CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
+
 #ifndef AP_MAVLINK_MSG_RELAY_STATUS_ENABLED
 #define AP_MAVLINK_MSG_RELAY_STATUS_ENABLED HAL_GCS_ENABLED && AP_RELAY_ENABLED
 #endif
@@ -33,7 +33,11 @@ extern const AP_HAL::HAL& hal;
 #define ROUTING_DEBUG 0
 
 // constructor
-MAVLink_routing::MAVLink_routing(void) : num_routes(0) {}
+MAVLink_routing::MAVLink_routing(void) : num_routes(0)
+{
+    memset(id_head, ROUTE_NONE, sizeof(id_head));
+    memset(sysid_head, ROUTE_NONE, sizeof(sysid_head));
+}
 
 /*
   forward a MAVLink message to the right port. This also
@@ -171,45 +175,53 @@ bool MAVLink_routing::check_and_forward(GCS_MAVLINK &in_link, const mavlink_mess
         return true;
     }
 
+    // find the channels with routes matching the targets
+    uint16_t chan_mask;
+    if (broadcast_system) {
+        chan_mask = route_chan_mask;
+    } else if (broadcast_component || !match_system) {
+        chan_mask = sysid_chan_mask(target_system);
+    } else {
+        chan_mask = id_chan_mask(target_system, target_component);
+    }
+    // private channels only get messages targeted at exactly the
+    // sysid/compid of a route on that channel
+    const uint16_t exact_chan_mask = id_chan_mask(target_system, target_component);
+
     // forward on any channels matching the targets
     bool forwarded = false;
-    bool sent_to_chan[MAVLINK_COMM_NUM_BUFFERS];
-    memset(sent_to_chan, 0, sizeof(sent_to_chan));
-    for (uint8_t i=0; i<num_routes; i++) {
+    for (uint8_t i=0; chan_mask != 0 && i<MAVLINK_COMM_NUM_BUFFERS; i++) {
+        const uint16_t chan_bit = 1U<<i;
+        if ((chan_mask & chan_bit) == 0) {
+            continue;
+        }
+        chan_mask &= ~chan_bit;
 
-        // Skip if channel is private and the target system or component IDs do not match
-        GCS_MAVLINK *out_link = gcs().chan(routes[i].channel);
+        const mavlink_channel_t channel = (mavlink_channel_t)(MAVLINK_COMM_0 + i);
+        GCS_MAVLINK *out_link = gcs().chan(channel);
         if (out_link == nullptr) {
             // this is bad
             continue;
         }
-        if (out_link->is_private() &&
-            (target_system != routes[i].sysid ||
-             target_component != routes[i].compid)) {
+        // Skip if channel is private and the target system or component IDs do not match
+        if (out_link->is_private() && (exact_chan_mask & chan_bit) == 0) {
             continue;
         }
-
-        if (broadcast_system || (target_system == routes[i].sysid &&
-                                 (broadcast_component || 
-                                  target_component == routes[i].compid ||
-                                  !match_system))) {
-
-            if (&in_link != out_link && !sent_to_chan[routes[i].channel]) {
-                if (out_link->check_payload_size(msg.len)) {
+        if (&in_link == out_link) {
+            continue;
+        }
+        if (out_link->check_payload_size(msg.len)) {
 #if ROUTING_DEBUG
-                    ::printf("fwd msg %u from chan %u on chan %u sysid=%d compid=%d\n",
-                             msg.msgid,
-                             (unsigned)in_link.get_chan(),
-                             (unsigned)routes[i].channel,
-                             (int)target_system,
-                             (int)target_component);
+            ::printf("fwd msg %u from chan %u on chan %u sysid=%d compid=%d\n",
+                     msg.msgid,
+                     (unsigned)in_link.get_chan(),
+                     (unsigned)channel,
+                     (int)target_system,
+                     (int)target_component);
 #endif
-                    _mavlink_resend_uart(routes[i].channel, &msg);
-                }
-                sent_to_chan[routes[i].channel] = true;
-                forwarded = true;
-            }
+            _mavlink_resend_uart(channel, &msg);
         }
+        forwarded = true;
     }
 
     if ((!forwarded && match_system) ||
@@ -236,29 +248,25 @@ void MAVLink_routing::send_to_components(uint32_t msgid, const char *pkt, uint8_
 
 void MAVLink_routing::send_to_components(const char *pkt, const mavlink_msg_entry_t *entry, const uint8_t pkt_len)
 {
-    bool sent_to_chan[MAVLINK_COMM_NUM_BUFFERS] {};
+    // check learned routes for our system ID
+    const uint16_t chan_mask = sysid_chan_mask(mavlink_system.sysid);
 
-    // check learned routes
-    for (uint8_t i=0; i<num_routes; i++) {
-        if (routes[i].sysid != mavlink_system.sysid) {
+    for (uint8_t i=0; i<MAVLINK_COMM_NUM_BUFFERS; i++) {
+        if ((chan_mask & (1U<<i)) == 0) {
             // our system ID hasn't been seen on this link
             continue;
         }
-        if (sent_to_chan[routes[i].channel]) {
-            // we've already send it on this link
-            continue;
-        }
-        if (comm_get_txspace(routes[i].channel) <
-            ((uint16_t)entry->max_msg_len) + GCS_MAVLINK::packet_overhead_chan(routes[i].channel)) {
+        const mavlink_channel_t channel = (mavlink_channel_t)(MAVLINK_COMM_0 + i);
+        if (comm_get_txspace(channel) <
+            ((uint16_t)entry->max_msg_len) + GCS_MAVLINK::packet_overhead_chan(channel)) {
             // it doesn't fit on this channel
             continue;
         }
 #if ROUTING_DEBUG
-        ::printf("send msg %u on chan %u sysid=%u compid=%u\n",
+        ::printf("send msg %u on chan %u sysid=%u\n",
                  entry->msgid,
-                 (unsigned)routes[i].channel,
-                 (unsigned)routes[i].sysid,
-                 (unsigned)routes[i].compid);
+                 (unsigned)channel,
+                 (unsigned)mavlink_system.sysid);
 #endif
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
         if (entry->max_msg_len > pkt_len) {
@@ -266,13 +274,12 @@ void MAVLink_routing::send_to_components(const char *pkt, const mavlink_msg_entr
                           entry->max_msg_len, pkt_len);
         }
 #endif
-        _mav_finalize_message_chan_send(routes[i].channel,
+        _mav_finalize_message_chan_send(channel,
                                         entry->msgid,
                                         pkt,
                                         entry->min_msg_len,
                                         MIN(entry->max_msg_len, pkt_len),
                                         entry->crc_extra);
-        sent_to_chan[routes[i].channel] = true;
     }
 }
 
@@ -335,31 +342,146 @@ void MAVLink_routing::learn_route(GCS_MAVLINK &in_link, const mavlink_message_t
         return;
     }
     const mavlink_channel_t in_channel = in_link.get_chan();
-    for (i=0; i<num_routes; i++) {
+    const uint32_t now_ms = AP_HAL::millis();
+    for (i=id_head[id_bucket(msg.sysid, msg.compid)]; i!=ROUTE_NONE; i=routes[i].next_id) {
         if (routes[i].sysid == msg.sysid &&
             routes[i].compid == msg.compid &&
             routes[i].channel == in_channel) {
             if (routes[i].mavtype == 0 && msg.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
                 routes[i].mavtype = mavlink_msg_heartbeat_get_type(&msg);
             }
-            break;
+            routes[i].last_seen_ms = now_ms;
+            return;
         }
     }
-    if (i == num_routes && i<MAVLINK_MAX_ROUTES) {
-        routes[i].sysid = msg.sysid;
-        routes[i].compid = msg.compid;
-        routes[i].channel = in_channel;
-        if (msg.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
-            routes[i].mavtype = mavlink_msg_heartbeat_get_type(&msg);
+
+    // new route, add it to the end of the table or replace one which
+    // has timed out
+    if (num_routes < MAVLINK_MAX_ROUTES) {
+        i = num_routes++;
+    } else {
+        i = find_route_to_replace(now_ms);
+        if (i == ROUTE_NONE) {
+            return;
         }
-        num_routes++;
 #if ROUTING_DEBUG
-        ::printf("learned route %u %u via %u\n",
-                 (unsigned)msg.sysid,
-                 (unsigned)msg.compid,
-                 (unsigned)in_channel);
+        ::printf("replacing route %u %u via %u\n",
+                 (unsigned)routes[i].sysid,
+                 (unsigned)routes[i].compid,
+                 (unsigned)routes[i].channel);
 #endif
+        unlink_route(i);
+    }
+    routes[i].sysid = msg.sysid;
+    routes[i].compid = msg.compid;
+    routes[i].channel = in_channel;
+    routes[i].mavtype = 0;
+    if (msg.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+        routes[i].mavtype = mavlink_msg_heartbeat_get_type(&msg);
     }
+    routes[i].last_seen_ms = now_ms;
+    link_route(i);
+    update_route_chan_mask();
+#if ROUTING_DEBUG
+    ::printf("learned route %u %u via %u\n",
+             (unsigned)msg.sysid,
+             (unsigned)msg.compid,
+             (unsigned)in_channel);
+#endif
+}
+
+/*
+  find a route which has not been heard from for
+  MAVLINK_ROUTE_TIMEOUT_MS, preferring the one heard from least
+  recently.  Returns ROUTE_NONE if no route has timed out
+*/
+uint8_t MAVLink_routing::find_route_to_replace(uint32_t now_ms)
+{
+    // last_seen_ms only ever increases so no route can time out
+    // before the oldest one does
+    if ((int32_t)(now_ms - replace_check_ms) < 0) {
+        return ROUTE_NONE;
+    }
+    uint8_t oldest = 0;
+    for (uint8_t i=1; i<num_routes; i++) {
+        if (now_ms - routes[i].last_seen_ms > now_ms - routes[oldest].last_seen_ms) {
+            oldest = i;
+        }
+    }
+    if (now_ms - routes[oldest].last_seen_ms < MAVLINK_ROUTE_TIMEOUT_MS) {
+        replace_check_ms = routes[oldest].last_seen_ms + MAVLINK_ROUTE_TIMEOUT_MS;
+        return ROUTE_NONE;
+    }
+    return oldest;
+}
+
+// add route i to the head of its hash chains
+void MAVLink_routing::link_route(uint8_t i)
+{
+    route &r = routes[i];
+    const uint8_t idb = id_bucket(r.sysid, r.compid);
+    r.next_id = id_head[idb];
+    id_head[idb] = i;
+    const uint8_t sysb = sysid_bucket(r.sysid);
+    r.next_sysid = sysid_head[sysb];
+    sysid_head[sysb] = i;
+}
+
+// remove route i from its hash chains
+void MAVLink_routing::unlink_route(uint8_t i)
+{
+    const route &r = routes[i];
+    uint8_t *p = &id_head[id_bucket(r.sysid, r.compid)];
+    while (*p != ROUTE_NONE && *p != i) {
+        p = &routes[*p].next_id;
+    }
+    if (*p == i) {
+        *p = r.next_id;
+    }
+    p = &sysid_head[sysid_bucket(r.sysid)];
+    while (*p != ROUTE_NONE && *p != i) {
+        p = &routes[*p].next_sysid;
+    }
+    if (*p == i) {
+        *p = r.next_sysid;
+    }
+}
+
+void MAVLink_routing::update_route_chan_mask()
+{
+    uint16_t mask = 0;
+    for (uint8_t i=0; i<num_routes; i++) {
+        mask |= 1U<<((unsigned)(routes[i].channel-MAVLINK_COMM_0));
+    }
+    route_chan_mask = mask;
+}
+
+uint16_t MAVLink_routing::id_chan_mask(int16_t sysid, int16_t compid) const
+{
+    if (sysid < 0 || sysid > UINT8_MAX || compid < 0 || compid > UINT8_MAX) {
+        return 0;
+    }
+    uint16_t mask = 0;
+    for (uint8_t i=id_head[id_bucket(sysid, compid)]; i!=ROUTE_NONE; i=routes[i].next_id) {
+        if (routes[i].sysid == sysid && routes[i].compid == compid) {
+            mask |= 1U<<((unsigned)(routes[i].channel-MAVLINK_COMM_0));
+        }
+    }
+    return mask;
+}
+
+uint16_t MAVLink_routing::sysid_chan_mask(int16_t sysid) const
+{
+    if (sysid < 0 || sysid > UINT8_MAX) {
+        return 0;
+    }
+    uint16_t mask = 0;
+    for (uint8_t i=sysid_head[sysid_bucket(sysid)]; i!=ROUTE_NONE; i=routes[i].next_sysid) {
+        if (routes[i].sysid == sysid) {
+            mask |= 1U<<((unsigned)(routes[i].channel-MAVLINK_COMM_0));
+        }
+    }
+    return mask;
 }
 
 
@@ -382,11 +504,7 @@ void MAVLink_routing::handle_heartbeat(GCS_MAVLINK &link, const mavlink_message_
     mask &= ~no_route_mask;
     
     // mask out channels that are known sources for this sysid/compid
-    for (uint8_t i=0; i<num_routes; i++) {
-        if (routes[i].sysid == msg.sysid && routes[i].compid == msg.compid) {
-            mask &= ~(1U<<((unsigned)(routes[i].channel-MAVLINK_COMM_0)));
-        }
-    }
+    mask &= ~id_chan_mask(msg.sysid, msg.compid);
 
     if (mask == 0) {
         // nothing to send to
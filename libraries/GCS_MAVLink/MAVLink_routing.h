@@ -3,11 +3,30 @@
 #pragma once
 
 #include <AP_Common/AP_Common.h>
+#include <AP_HAL/AP_HAL_Boards.h>
 #include "GCS_MAVLink.h"
 
-// 20 routes should be enough for now. This may need to increase as
-// we make more extensive use of MAVLink forwarding
+// maximum number of routes.  Systems with many components (gimbals,
+// cameras, companion computers, multiple GCSs) or relaying for a
+// swarm may need more than the default
+#ifndef MAVLINK_MAX_ROUTES
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define MAVLINK_MAX_ROUTES 64
+#else
 #define MAVLINK_MAX_ROUTES 20
+#endif
+#endif
+
+// when the routing table is full, a route which has not been heard
+// from for this long may be replaced by a new one
+#ifndef MAVLINK_ROUTE_TIMEOUT_MS
+#define MAVLINK_ROUTE_TIMEOUT_MS 30000
+#endif
+
+// number of hash buckets used to look up routes, must be a power of two
+#ifndef MAVLINK_ROUTE_HASH_BUCKETS
+#define MAVLINK_ROUTE_HASH_BUCKETS (MAVLINK_MAX_ROUTES > 32 ? 64 : 32)
+#endif
 
 /*
   object to handle MAVLink packet routing
@@ -50,22 +69,68 @@ public:
     bool find_by_mavtype_and_compid(uint8_t mavtype, uint8_t compid, uint8_t &sysid, mavlink_channel_t &channel) const;
 
 private:
-    // a simple linear routing table. We don't expect to have a lot of
-    // routes, so a scalable structure isn't worthwhile yet.
+    static_assert(MAVLINK_MAX_ROUTES < UINT8_MAX, "route indexes must fit in uint8_t");
+    static_assert((MAVLINK_ROUTE_HASH_BUCKETS & (MAVLINK_ROUTE_HASH_BUCKETS-1)) == 0, "MAVLINK_ROUTE_HASH_BUCKETS must be a power of two");
+
+    // marks the end of a hash chain
+    static const uint8_t ROUTE_NONE = UINT8_MAX;
+
+    // routing table.  Routes are kept in the order they were learned
+    // and are also chained into two hash tables, one keyed on
+    // sysid/compid and one keyed on sysid, so that forwarding a
+    // message only looks at routes which could match its target
     uint8_t num_routes;
     struct route {
         uint8_t sysid;
         uint8_t compid;
         mavlink_channel_t channel;
         uint8_t mavtype;
+        uint8_t next_id;        // next route in the same id_head bucket
+        uint8_t next_sysid;     // next route in the same sysid_head bucket
+        uint32_t last_seen_ms;  // system time a message was last received on this route
     } routes[MAVLINK_MAX_ROUTES];
-    
+    uint8_t id_head[MAVLINK_ROUTE_HASH_BUCKETS];
+    uint8_t sysid_head[MAVLINK_ROUTE_HASH_BUCKETS];
+
+    // mask of channels with at least one route
+    uint16_t route_chan_mask;
+
+    // earliest time a route could have timed out, used to avoid
+    // searching for a route to replace when none can have timed out
+    uint32_t replace_check_ms;
+
     // a channel mask to block routing as required
     uint8_t no_route_mask;
     
     // learn new routes
     void learn_route(GCS_MAVLINK &link, const mavlink_message_t &msg);
 
+    // hash table buckets for a sysid/compid and for a sysid
+    static uint8_t id_bucket(uint8_t sysid, uint8_t compid) {
+        return (sysid * 37U + compid) & (MAVLINK_ROUTE_HASH_BUCKETS-1);
+    }
+    static uint8_t sysid_bucket(uint8_t sysid) {
+        return sysid & (MAVLINK_ROUTE_HASH_BUCKETS-1);
+    }
+
+    // mask of channels with a route to the given sysid/compid.  Negative
+    // values (no target in the message) never match a route
+    uint16_t id_chan_mask(int16_t sysid, int16_t compid) const;
+
+    // mask of channels with a route to any component of sysid
+    uint16_t sysid_chan_mask(int16_t sysid) const;
+
+    // add route i to or remove it from the hash tables
+    void link_route(uint8_t i);
+    void unlink_route(uint8_t i);
+
+    // find the index of a route which has timed out and may be
+    // replaced, returns ROUTE_NONE if there is none
+    uint8_t find_route_to_replace(uint32_t now_ms);
+
+    // recalculate route_chan_mask
+    void update_route_chan_mask();
+
     // extract target sysid and compid from a message
     void get_targets(const mavlink_message_t &msg, int16_t &sysid, int16_t &compid);
 
@@ -106,6 +106,18 @@ MAV_MISSION_RESULT MissionItemProtocol_Fence::convert_MISSION_ITEM_INT_to_AC_Pol
         return MAV_MISSION_UNSUPPORTED_FRAME;
     }
 
+    switch (mission_item_int.command) {
+    case MAV_CMD_NAV_FENCE_POLYGON_VERTEX_INCLUSION:
+    case MAV_CMD_NAV_FENCE_POLYGON_VERTEX_EXCLUSION:
+        // the vertex count is stored in a single byte
+        if (mission_item_int.param1 < 0 || mission_item_int.param1 > UINT8_MAX) {
+            return MAV_MISSION_INVALID_PARAM1;
+        }
+        break;
+    default:
+        break;
+    }
+
     switch (mission_item_int.command) {
     case MAV_CMD_NAV_FENCE_POLYGON_VERTEX_INCLUSION:
         ret.type = AC_PolyFenceType::POLYGON_INCLUSION;
@@ -0,0 +1,98 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <GCS_MAVLink/GCS.h>
+#include <GCS_MAVLink/GCS_Dummy.h>
+#include <AP_SerialManager/AP_SerialManager.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+AP_SerialManager _serialmanager;
+GCS_Dummy _gcs;
+
+const AP_Param::GroupInfo GCS_MAVLINK_Parameters::var_info[] = {
+    AP_GROUPEND
+};
+
+/*
+  a mix of traffic as seen on a link to a companion computer relaying
+  for many components: heartbeats, telemetry without a target,
+  messages targeted at each component and messages targeted at us
+ */
+static const uint8_t traffic_len = 64;
+
+static void make_traffic(mavlink_message_t *traffic, uint8_t num_components)
+{
+    mavlink_status_t status {};
+    for (uint8_t i=0; i<traffic_len; i++) {
+        // spread the components over several systems
+        const uint8_t sysid = 2 + (i % num_components) / 8;
+        const uint8_t compid = 100 + (i % num_components) % 8;
+        switch (i % 4) {
+        case 0: {
+            mavlink_heartbeat_t heartbeat {};
+            heartbeat.type = MAV_TYPE_GIMBAL;
+            mavlink_msg_heartbeat_encode_status(sysid, compid, &status, &traffic[i], &heartbeat);
+            break;
+        }
+        case 1: {
+            mavlink_attitude_t attitude {};
+            mavlink_msg_attitude_encode_status(sysid, compid, &status, &traffic[i], &attitude);
+            break;
+        }
+        case 2: {
+            // from the GCS to a component
+            mavlink_command_long_t command {};
+            command.target_system = sysid;
+            command.target_component = compid;
+            mavlink_msg_command_long_encode_status(255, 190, &status, &traffic[i], &command);
+            break;
+        }
+        case 3: {
+            // from a component to us
+            mavlink_param_set_t param_set {};
+            param_set.target_system = mavlink_system.sysid;
+            param_set.target_component = mavlink_system.compid;
+            mavlink_msg_param_set_encode_status(sysid, compid, &status, &traffic[i], &param_set);
+            break;
+        }
+        }
+    }
+}
+
+static GCS_MAVLINK *setup_link()
+{
+    static bool done;
+    if (!done) {
+        mavlink_system.sysid = 1;
+        mavlink_system.compid = 1;
+        gcs().init();
+        gcs().setup_console();
+        done = true;
+    }
+    return gcs().chan(0);
+}
+
+static void BM_RoutingCheckAndForward(benchmark::State& state)
+{
+    GCS_MAVLINK *link = setup_link();
+    if (link == nullptr) {
+        state.SkipWithError("no link");
+        return;
+    }
+    mavlink_message_t *traffic = new mavlink_message_t[traffic_len];
+    make_traffic(traffic, state.range_x());
+    MAVLink_routing *routing = new MAVLink_routing();
+    uint8_t i = 0;
+
+    while (state.KeepRunning()) {
+        bool process_locally = routing->check_and_forward(*link, traffic[i++ % traffic_len]);
+        gbenchmark_escape(&process_locally);
+    }
+    delete routing;
+    delete[] traffic;
+}
+
+BENCHMARK(BM_RoutingCheckAndForward)->Arg(4)->Arg(16)->Arg(64);
+
+BENCHMARK_MAIN();
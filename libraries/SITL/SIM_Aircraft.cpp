@@ -276,25 +276,34 @@ void Aircraft::sync_frame_time(void)
     uint64_t now = get_wall_time_us();
     uint64_t dt_us = now - last_wall_time_us;
 
-    const float target_dt_us = 1.0e6/(rate_hz*target_speedup);
+#if AP_SIM_LOCKSTEP_ENABLED
+    if (lockstep.enabled()) {
+        // run as fast as the slowest instance in the group rather
+        // than at the requested speedup
+        lockstep.wait(time_now_us);
+    } else
+#endif
+    if (!max_speed) {
+        const float target_dt_us = 1.0e6/(rate_hz*target_speedup);
 
-    // accumulate sleep debt if we're running too fast
-    sleep_debt_us += target_dt_us - dt_us;
+        // accumulate sleep debt if we're running too fast
+        sleep_debt_us += target_dt_us - dt_us;
 
-    if (sleep_debt_us < -1.0e5) {
-        // don't let a large negative debt build up
-        sleep_debt_us = -1.0e5;
-    }
-    if (sleep_debt_us > min_sleep_time) {
-        // sleep if we have built up a debt of min_sleep_tim
+        if (sleep_debt_us < -1.0e5) {
+            // don't let a large negative debt build up
+            sleep_debt_us = -1.0e5;
+        }
+        if (sleep_debt_us > min_sleep_time) {
+            // sleep if we have built up a debt of min_sleep_tim
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
-        usleep(sleep_debt_us);
+            usleep(sleep_debt_us);
 #elif CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
-        hal.scheduler->delay_microseconds(sleep_debt_us);
+            hal.scheduler->delay_microseconds(sleep_debt_us);
 #else
-        // ??
+            // ??
 #endif
-        sleep_debt_us -= (get_wall_time_us() - now);
+            sleep_debt_us -= (get_wall_time_us() - now);
+        }
     }
     last_wall_time_us = get_wall_time_us();
 
@@ -37,6 +37,7 @@
 #include "SIM_Battery.h"
 #include <Filter/Filter.h>
 #include "SIM_JSON_Master.h"
+#include "SIM_LockStep.h"
 #include "ServoModel.h"
 #include "SIM_GPIO_LED_1.h"
 #include "SIM_GPIO_LED_2.h"
@@ -68,6 +69,24 @@ public:
         instance = _instance;
     }
 
+    /*
+      run as fast as possible instead of pacing the simulation to the
+      wall clock
+     */
+    void set_max_speed() {
+        max_speed = true;
+    }
+
+#if AP_SIM_LOCKSTEP_ENABLED
+    /*
+      step in lock-step with the other num_instances SITL instances
+      of group instead of pacing the simulation to the wall clock
+     */
+    void set_lockstep(uint8_t num_instances, uint32_t group) {
+        lockstep.init(num_instances, instance, group);
+    }
+#endif
+
     /*
       set directory for additional files such as aircraft models
      */
@@ -248,6 +267,10 @@ protected:
     const char *autotest_dir;
     const char *frame;
     bool use_time_sync = true;
+    bool max_speed = false;
+#if AP_SIM_LOCKSTEP_ENABLED
+    LockStep lockstep;
+#endif
     float last_speedup = -1.0f;
     const char *config_ = "";
     float eas2tas = 1.0;
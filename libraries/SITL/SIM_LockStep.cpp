@@ -0,0 +1,213 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  Step several SITL instances in lock-step through a shared memory
+  clock
+*/
+
+#include "SIM_LockStep.h"
+
+#if AP_SIM_LOCKSTEP_ENABLED
+
+#include <AP_HAL/AP_HAL.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace SITL;
+
+// an instance which hasn't updated its slot for this long (e.g. it
+// has not started yet, has crashed, or is stopped in a debugger) is
+// not waited for
+#define LOCKSTEP_TIMEOUT_US 3000000ULL
+
+// instances which haven't joined this long after we did are not
+// waited for before starting
+#define LOCKSTEP_START_TIMEOUT_US 60000000ULL
+
+// the instance to remove from the group on exit
+static LockStep *exit_instance;
+
+static void lockstep_exit()
+{
+    if (exit_instance != nullptr) {
+        exit_instance->leave();
+    }
+}
+
+static bool process_running(int32_t pid)
+{
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+static uint64_t wall_time_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000ULL + ts.tv_nsec / 1000U;
+}
+
+void LockStep::init(uint8_t _num_instances, uint8_t _instance, uint32_t group)
+{
+    if (_instance >= _num_instances) {
+        AP_HAL::panic("lockstep: instance %u must be less than %u", unsigned(_instance), unsigned(_num_instances));
+    }
+
+    snprintf(shm_name, sizeof(shm_name), "/ardupilot_lockstep_%u_%u", unsigned(getuid()), unsigned(group));
+    shm_fd = shm_open(shm_name, O_RDWR | O_CREAT, 0600);
+    if (shm_fd == -1) {
+        AP_HAL::panic("lockstep: shm_open(%s) failed: %s", shm_name, strerror(errno));
+    }
+    // joining instances see each other's slots, so they don't clear
+    // an instance which has only just started
+    flock(shm_fd, LOCK_EX);
+    if (ftruncate(shm_fd, sizeof(segment)) != 0) {
+        AP_HAL::panic("lockstep: ftruncate failed: %s", strerror(errno));
+    }
+    void *p = mmap(nullptr, sizeof(segment), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    if (p == MAP_FAILED) {
+        AP_HAL::panic("lockstep: mmap failed: %s", strerror(errno));
+    }
+
+    shared = (segment *)p;
+    num_instances = _num_instances;
+    instance = _instance;
+    init_us = wall_time_us();
+
+    // clear the slots of instances which crashed or were killed
+    for (auto &s : shared->slots) {
+        const int32_t pid = s.pid.load();
+        if (pid != 0 && !process_running(pid)) {
+            s.sim_time_us = 0;
+            s.wall_time_us = 0;
+            s.pid = 0;
+        }
+    }
+    slot &self = shared->slots[instance];
+    if (self.pid.load() != 0) {
+        AP_HAL::panic("lockstep: instance %u of group %u is already running as pid %d",
+                      unsigned(instance), unsigned(group), int(self.pid.load()));
+    }
+    self.sim_time_us = 0;
+    self.wall_time_us = init_us;
+    self.pid = int32_t(getpid());
+    flock(shm_fd, LOCK_UN);
+
+    exit_instance = this;
+    atexit(lockstep_exit);
+
+    ::printf("lockstep: instance %u of %u in group %u\n", unsigned(instance), unsigned(num_instances), unsigned(group));
+}
+
+void LockStep::leave()
+{
+    if (shared == nullptr) {
+        return;
+    }
+    flock(shm_fd, LOCK_EX);
+    // stop the other instances waiting for us
+    slot &self = shared->slots[instance];
+    self.wall_time_us = 0;
+    self.pid = 0;
+    bool others_running = false;
+    for (const auto &s : shared->slots) {
+        if (process_running(s.pid.load())) {
+            others_running = true;
+            break;
+        }
+    }
+    if (!others_running) {
+        shm_unlink(shm_name);
+    }
+    munmap(shared, sizeof(segment));
+    shared = nullptr;
+    // closing releases the lock
+    close(shm_fd);
+    shm_fd = -1;
+    if (exit_instance == this) {
+        exit_instance = nullptr;
+    }
+}
+
+LockStep::~LockStep()
+{
+    leave();
+}
+
+void LockStep::wait(uint64_t sim_time_us)
+{
+    slot &self = shared->slots[instance];
+    self.sim_time_us = sim_time_us;
+
+    const uint64_t wait_start_us = wall_time_us();
+    uint32_t spins = 0;
+    while (true) {
+        const uint64_t now = wall_time_us();
+        // we are alive while waiting, even though our time isn't moving
+        self.wall_time_us = now;
+
+        int16_t waiting_on = -1;
+        for (uint8_t i=0; i<num_instances; i++) {
+            if (i == instance) {
+                continue;
+            }
+            const slot &other = shared->slots[i];
+            const uint64_t other_wall_us = other.wall_time_us.load();
+            if (other_wall_us < now && now - other_wall_us > LOCKSTEP_TIMEOUT_US) {
+                if (!started && now - init_us < LOCKSTEP_START_TIMEOUT_US) {
+                    // don't start until the whole group has joined
+                    waiting_on = i;
+                    break;
+                }
+                continue;
+            }
+            if (other.sim_time_us.load() < sim_time_us) {
+                waiting_on = i;
+                break;
+            }
+        }
+        if (waiting_on == -1) {
+            if (!started && now - init_us >= LOCKSTEP_START_TIMEOUT_US) {
+                ::printf("lockstep: starting without instances which haven't joined\n");
+            }
+            started = true;
+            return;
+        }
+
+        if (now - wait_start_us > 1000000U &&
+            now - last_stall_report_us > LOCKSTEP_TIMEOUT_US) {
+            ::printf("lockstep: waiting for instance %d\n", waiting_on);
+            last_stall_report_us = now;
+        }
+
+        // the instance we are waiting for is normally only a single
+        // physics step behind, so yield rather than sleep
+        if (spins++ < 1000) {
+            sched_yield();
+        } else {
+            usleep(100);
+        }
+    }
+}
+
+#endif  // AP_SIM_LOCKSTEP_ENABLED
@@ -0,0 +1,93 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  Step several SITL instances in lock-step through a shared memory
+  clock, so a swarm runs as fast as its slowest vehicle rather than
+  being paced by the wall clock
+*/
+
+#pragma once
+
+#include <AP_HAL/AP_HAL_Boards.h>
+
+#ifndef AP_SIM_LOCKSTEP_ENABLED
+#define AP_SIM_LOCKSTEP_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL)
+#endif
+
+#if AP_SIM_LOCKSTEP_ENABLED
+
+#include <atomic>
+#include <stdint.h>
+
+namespace SITL {
+
+class LockStep {
+public:
+    ~LockStep();
+
+    // join lock-step group of num_instances vehicles as instance.
+    // Groups run by the same user are kept apart by their group
+    // number
+    void init(uint8_t num_instances, uint8_t instance, uint32_t group);
+
+    // leave the group, removing the shared memory segment if no other
+    // instance is running. Called on exit
+    void leave();
+
+    bool enabled() const { return shared != nullptr; }
+
+    // publish that this instance has reached sim_time_us, then wait
+    // until every other running instance has reached it too
+    void wait(uint64_t sim_time_us);
+
+private:
+
+    static const uint8_t max_instances = 255;
+
+    // one slot per instance in the shared memory segment
+    struct slot {
+        std::atomic<uint64_t> sim_time_us;
+        // wall clock time the instance last updated this slot.
+        // Instances which stop updating it are no longer waited for
+        std::atomic<uint64_t> wall_time_us;
+        // process using the slot, 0 if none. A slot whose process
+        // has died without leaving is cleared by the next to join
+        std::atomic<int32_t> pid;
+    };
+
+    struct segment {
+        slot slots[max_instances];
+    };
+
+    segment *shared = nullptr;
+    // the segment's file, locked while joining and leaving
+    int shm_fd = -1;
+    char shm_name[48] {};
+    uint8_t num_instances = 0;
+    uint8_t instance = 0;
+
+    // true once every instance has joined, or we gave up waiting
+    bool started = false;
+
+    // wall clock time we joined the group
+    uint64_t init_us = 0;
+
+    // wall clock time we last reported waiting on a stalled instance
+    uint64_t last_stall_report_us = 0;
+};
+
+}
+
+#endif  // AP_SIM_LOCKSTEP_ENABLED
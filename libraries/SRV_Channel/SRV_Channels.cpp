@@ -25,6 +25,7 @@
 #include "SRV_Channel.h"
 #include <AP_Logger/AP_Logger.h>
 #include <AP_KDECAN/AP_KDECAN.h>
+#include <AP_Trace/AP_Trace.h>
 
 #if HAL_MAX_CAN_PROTOCOL_DRIVERS
   #include <AP_CANManager/AP_CANManager.h>
@@ -576,6 +577,8 @@ void SRV_Channels::push()
         }
     }
 #endif // HAL_NUM_CAN_IFACES
+
+    AP_TRACE(OUTPUT_PUSH);
 }
 
 void SRV_Channels::zero_rc_outputs()